@@ -0,0 +1,105 @@
+/**
+ * \file host/display.c
+ *
+ * Replacements for the brain's screen when the PROS kernel runs on a host
+ * machine. The real implementations in src/display are built on LVGL, which
+ * isn't part of the host build.
+ *
+ * LLEMU lines and error messages are written to stdout as they change, with
+ * write() rather than stdio so that a task preempted inside printf can't hold
+ * up another one that draws to the screen.
+ *
+ * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <errno.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include "pros/llemu.h"
+
+#define LCD_LINES 8
+#define LCD_LINE_LENGTH 64
+
+static void _screen_write(const char* prefix, const char* fmt, va_list args) {
+	char buf[LCD_LINE_LENGTH + 16];
+	int len = snprintf(buf, sizeof(buf), "%s", prefix);
+	len += vsnprintf(buf + len, sizeof(buf) - len, fmt, args);
+	if (len > (int)sizeof(buf) - 1) len = sizeof(buf) - 1;
+	buf[len++] = '\n';
+	write(STDOUT_FILENO, buf, len);
+}
+
+static void _screen_printf(const char* prefix, const char* fmt, ...) {
+	va_list args;
+	va_start(args, fmt);
+	_screen_write(prefix, fmt, args);
+	va_end(args);
+}
+
+void display_error(const char* text) {
+	if (text[0]) _screen_printf("[ERROR] ", "%s", text);
+}
+
+// There is no screen to set up, so LLEMU is always ready
+bool lcd_is_initialized(void) {
+	return true;
+}
+
+bool lcd_initialize(void) {
+	return true;
+}
+
+bool lcd_shutdown(void) {
+	return true;
+}
+
+bool lcd_print(int16_t line, const char* fmt, ...) {
+	if (line < 0 || line >= LCD_LINES) {
+		errno = EINVAL;
+		return false;
+	}
+	char prefix[16];
+	snprintf(prefix, sizeof(prefix), "[LCD %d] ", line);
+	va_list args;
+	va_start(args, fmt);
+	_screen_write(prefix, fmt, args);
+	va_end(args);
+	return true;
+}
+
+bool lcd_set_text(int16_t line, const char* text) {
+	return lcd_print(line, "%s", text);
+}
+
+bool lcd_clear(void) {
+	return true;
+}
+
+bool lcd_clear_line(int16_t line) {
+	return lcd_print(line, "");
+}
+
+bool lcd_register_btn0_cb(lcd_btn_cb_fn_t cb) {
+	return true;
+}
+
+bool lcd_register_btn1_cb(lcd_btn_cb_fn_t cb) {
+	return true;
+}
+
+bool lcd_register_btn2_cb(lcd_btn_cb_fn_t cb) {
+	return true;
+}
+
+uint8_t lcd_read_buttons(void) {
+	return 0;
+}
@@ -0,0 +1,99 @@
+/**
+ * \file host/include/portmacro.h
+ *
+ * FreeRTOS port definitions for running the PROS kernel as a Linux process.
+ *
+ * Every task runs on its own pthread, but only the thread of the task FreeRTOS
+ * considers running is ever allowed to make progress, so the kernel sees a
+ * single core exactly like on the V5. The tick is a SIGALRM timer; "disabling
+ * interrupts" blocks that signal on the calling thread.
+ *
+ * See host/port.c for the implementation.
+ *
+ * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef PORTMACRO_H
+#define PORTMACRO_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define portCHAR char
+#define portFLOAT float
+#define portDOUBLE double
+#define portLONG long
+#define portSHORT short
+#define portSTACK_TYPE uint32_t
+#define portBASE_TYPE long
+#define portPOINTER_SIZE_TYPE uintptr_t
+
+typedef portSTACK_TYPE task_stack_t;
+
+#define portMAX_DELAY (uint32_t)0xffffffffUL
+#define portTICK_TYPE_IS_ATOMIC 1
+
+#define portSTACK_GROWTH (-1)
+#define portTICK_PERIOD_MS ((uint32_t)1000 / configTICK_RATE_HZ)
+#define portBYTE_ALIGNMENT 8
+
+extern void vPortYield(void);
+extern uint32_t ulPortYieldRequired;
+
+#define portYIELD() vPortYield()
+#define portEND_SWITCHING_ISR(xSwitchRequired) \
+	if ((xSwitchRequired) != pdFALSE) {          \
+		ulPortYieldRequired = pdTRUE;              \
+	}
+#define portYIELD_FROM_ISR(x) portEND_SWITCHING_ISR(x)
+
+extern void vPortEnterCritical(void);
+extern void vPortExitCritical(void);
+extern uint32_t ulPortSetInterruptMask(void);
+extern void vPortClearInterruptMask(uint32_t ulNewMaskValue);
+
+#define portENTER_CRITICAL() vPortEnterCritical();
+#define portEXIT_CRITICAL() vPortExitCritical();
+#define portDISABLE_INTERRUPTS() ulPortSetInterruptMask()
+#define portENABLE_INTERRUPTS() vPortClearInterruptMask(0)
+#define portSET_INTERRUPT_MASK_FROM_ISR() ulPortSetInterruptMask()
+#define portCLEAR_INTERRUPT_MASK_FROM_ISR(x) vPortClearInterruptMask(x)
+
+#define portTASK_FUNCTION_PROTO(vFunction, pvParameters) void vFunction(void* pvParameters)
+#define portTASK_FUNCTION(vFunction, pvParameters) void vFunction(void* pvParameters)
+
+// Every task's thread has its own floating point state already
+#define vPortTaskUsesFPU()
+#define portTASK_USES_FLOATING_POINT()
+
+// The thread backing a task is torn down when FreeRTOS frees the task
+extern void vPortCleanUpTCB(void* pxTCB);
+#define portCLEAN_UP_TCB(pxTCB) vPortCleanUpTCB(pxTCB)
+
+#ifndef configUSE_PORT_OPTIMISED_TASK_SELECTION
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION 1
+#endif
+
+#if configUSE_PORT_OPTIMISED_TASK_SELECTION == 1
+#define portRECORD_READY_PRIORITY(uxPriority, uxReadyPriorities) (uxReadyPriorities) |= (1UL << (uxPriority))
+#define portRESET_READY_PRIORITY(uxPriority, uxReadyPriorities) (uxReadyPriorities) &= ~(1UL << (uxPriority))
+#define portGET_HIGHEST_PRIORITY(uxTopPriority, uxReadyPriorities) \
+	uxTopPriority = (31UL - (uint32_t)__builtin_clz(uxReadyPriorities))
+#endif
+
+#define portNOP() __asm volatile("nop")
+#define portINLINE __inline
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // PORTMACRO_H
@@ -0,0 +1,50 @@
+/**
+ * \file host/include/reent.h
+ *
+ * Stand-in for newlib's reentrancy structure, for building the PROS kernel on
+ * a host machine with the C library of the host.
+ *
+ * The kernel reports errors from its file system stubs by setting the errno of
+ * a struct _reent. The host C library keeps errno in its own thread local
+ * storage, so _REENT points there and every task's thread gets its own.
+ *
+ * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef _HOST_REENT_H_
+#define _HOST_REENT_H_
+
+#include <errno.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct _reent {
+	// Must stay the first member so that _REENT can alias errno
+	int _errno;
+	int __sdidinit;
+};
+
+extern struct _reent* _impure_ptr;
+extern struct _reent _host_global_reent;
+
+#define _REENT ((struct _reent*)&errno)
+#define _GLOBAL_REENT (&_host_global_reent)
+#define _REENT_INIT_PTR(var) memset((var), 0, sizeof(struct _reent))
+
+static inline void _reclaim_reent(struct _reent* ptr) {
+	(void)ptr;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // _HOST_REENT_H_
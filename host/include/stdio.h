@@ -0,0 +1,34 @@
+/**
+ * \file host/include/stdio.h
+ *
+ * The host C library's stdio.h, plus the newlib extensions which the kernel
+ * calls. host/system.c implements them on top of the host's stdio.
+ *
+ * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include_next <stdio.h>
+
+#ifndef _HOST_STDIO_H_
+#define _HOST_STDIO_H_
+
+#include <stdarg.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// newlib's integer-only printf and vsnprintf
+int iprintf(const char* fmt, ...) __attribute__((format(printf, 1, 2)));
+int vsniprintf(char* str, size_t size, const char* fmt, va_list args);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // _HOST_STDIO_H_
@@ -0,0 +1,165 @@
+/**
+ * \file host/include/v5_api.h
+ *
+ * Functions of the VEX V5 SDK, for building the PROS kernel on a host machine.
+ *
+ * Only the functions the kernel uses are declared. They are implemented by
+ * host/v5_api.c, which behaves like a brain with nothing plugged in.
+ *
+ * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef V5_API_H_
+#define V5_API_H_
+
+#include "v5_apitypes.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// System
+void vexBackgroundProcessing(void);
+uint32_t vexSystemTimeGet(void);
+uint64_t vexSystemHighResTimeGet(void);
+uint32_t vexSystemWatchdogGet(void);
+uint32_t vexSystemVersion(void);
+uint32_t vexCompetitionStatus(void);
+
+// Serial
+int32_t vexSerialWriteBuffer(uint32_t channel, uint8_t* data, uint32_t data_len);
+int32_t vexSerialReadChar(uint32_t channel);
+int32_t vexSerialWriteFree(uint32_t channel);
+
+// Display
+void vexDisplayForegroundColor(uint32_t col);
+void vexDisplayBackgroundColor(uint32_t col);
+void vexDisplayErase(void);
+void vexDisplayRectFill(int32_t x1, int32_t y1, int32_t x2, int32_t y2);
+void vexDisplayRectClear(int32_t x1, int32_t y1, int32_t x2, int32_t y2);
+void vexDisplayString(const int32_t nLineNumber, const char* format, ...);
+void vexDisplayCenteredString(const int32_t nLineNumber, const char* format, ...);
+void vexDisplayPrintf(int32_t xpos, int32_t ypos, uint32_t bOpaque, const char* format, ...);
+
+// Battery
+int32_t vexBatteryVoltageGet(void);
+int32_t vexBatteryCurrentGet(void);
+double vexBatteryTemperatureGet(void);
+double vexBatteryCapacityGet(void);
+
+// Controller
+int32_t vexControllerGet(V5_ControllerId id, V5_ControllerIndex index);
+V5_ControllerStatus vexControllerConnectionStatusGet(V5_ControllerId id);
+bool vexControllerTextSet(V5_ControllerId id, uint32_t line, uint32_t col, const char* str);
+
+// Devices
+int32_t vexDeviceGetStatus(V5_DeviceType* buffer);
+V5_DeviceT vexDeviceGetByIndex(uint32_t index);
+uint32_t vexDeviceTimestampGet(V5_DeviceT device);
+
+// Motor
+void vexDeviceMotorVelocitySet(V5_DeviceT device, int32_t velocity);
+void vexDeviceMotorVelocityUpdate(V5_DeviceT device, int32_t velocity);
+int32_t vexDeviceMotorVelocityGet(V5_DeviceT device);
+double vexDeviceMotorActualVelocityGet(V5_DeviceT device);
+int32_t vexDeviceMotorDirectionGet(V5_DeviceT device);
+void vexDeviceMotorCurrentLimitSet(V5_DeviceT device, int32_t value);
+int32_t vexDeviceMotorCurrentLimitGet(V5_DeviceT device);
+int32_t vexDeviceMotorCurrentGet(V5_DeviceT device);
+double vexDeviceMotorPowerGet(V5_DeviceT device);
+double vexDeviceMotorTorqueGet(V5_DeviceT device);
+double vexDeviceMotorEfficiencyGet(V5_DeviceT device);
+double vexDeviceMotorTemperatureGet(V5_DeviceT device);
+bool vexDeviceMotorOverTempFlagGet(V5_DeviceT device);
+bool vexDeviceMotorCurrentLimitFlagGet(V5_DeviceT device);
+uint32_t vexDeviceMotorFaultsGet(V5_DeviceT device);
+bool vexDeviceMotorZeroVelocityFlagGet(V5_DeviceT device);
+bool vexDeviceMotorZeroPositionFlagGet(V5_DeviceT device);
+uint32_t vexDeviceMotorFlagsGet(V5_DeviceT device);
+void vexDeviceMotorReverseFlagSet(V5_DeviceT device, bool value);
+bool vexDeviceMotorReverseFlagGet(V5_DeviceT device);
+void vexDeviceMotorEncoderUnitsSet(V5_DeviceT device, V5MotorEncoderUnits units);
+V5MotorEncoderUnits vexDeviceMotorEncoderUnitsGet(V5_DeviceT device);
+void vexDeviceMotorBrakeModeSet(V5_DeviceT device, V5MotorBrakeMode mode);
+V5MotorBrakeMode vexDeviceMotorBrakeModeGet(V5_DeviceT device);
+void vexDeviceMotorPositionSet(V5_DeviceT device, double position);
+double vexDeviceMotorPositionGet(V5_DeviceT device);
+int32_t vexDeviceMotorPositionRawGet(V5_DeviceT device, uint32_t* timestamp);
+void vexDeviceMotorPositionReset(V5_DeviceT device);
+double vexDeviceMotorTargetGet(V5_DeviceT device);
+void vexDeviceMotorAbsoluteTargetSet(V5_DeviceT device, double position, int32_t veloctiy);
+void vexDeviceMotorRelativeTargetSet(V5_DeviceT device, double position, int32_t velocity);
+void vexDeviceMotorGearingSet(V5_DeviceT device, V5MotorGearset value);
+V5MotorGearset vexDeviceMotorGearingGet(V5_DeviceT device);
+void vexDeviceMotorVoltageSet(V5_DeviceT device, int32_t value);
+int32_t vexDeviceMotorVoltageGet(V5_DeviceT device);
+void vexDeviceMotorVoltageLimitSet(V5_DeviceT device, int32_t value);
+int32_t vexDeviceMotorVoltageLimitGet(V5_DeviceT device);
+void vexDeviceMotorPositionPidSet(V5_DeviceT device, V5_DeviceMotorPid* pid);
+
+// ADI
+void vexDeviceAdiPortConfigSet(V5_DeviceT device, uint32_t port, V5_AdiPortConfiguration type);
+V5_AdiPortConfiguration vexDeviceAdiPortConfigGet(V5_DeviceT device, uint32_t port);
+void vexDeviceAdiValueSet(V5_DeviceT device, uint32_t port, int32_t value);
+int32_t vexDeviceAdiValueGet(V5_DeviceT device, uint32_t port);
+
+// Vision
+int32_t vexDeviceVisionObjectCountGet(V5_DeviceT device);
+int32_t vexDeviceVisionObjectGet(V5_DeviceT device, uint32_t indexObj, V5_DeviceVisionObject* pObject);
+void vexDeviceVisionSignatureSet(V5_DeviceT device, V5_DeviceVisionSignature* pSignature);
+bool vexDeviceVisionSignatureGet(V5_DeviceT device, uint32_t id, V5_DeviceVisionSignature* pSignature);
+void vexDeviceVisionBrightnessSet(V5_DeviceT device, uint8_t value);
+uint8_t vexDeviceVisionBrightnessGet(V5_DeviceT device);
+void vexDeviceVisionWhiteBalanceModeSet(V5_DeviceT device, V5VisionWBMode mode);
+void vexDeviceVisionWhiteBalanceSet(V5_DeviceT device, V5_DeviceVisionRgb color);
+V5_DeviceVisionRgb vexDeviceVisionWhiteBalanceGet(V5_DeviceT device);
+void vexDeviceVisionLedModeSet(V5_DeviceT device, V5VisionLedMode mode);
+void vexDeviceVisionLedColorSet(V5_DeviceT device, V5_DeviceVisionRgb color);
+void vexDeviceVisionWifiModeSet(V5_DeviceT device, V5VisionWifiMode mode);
+
+// IMU
+void vexDeviceImuReset(V5_DeviceT device);
+double vexDeviceImuHeadingGet(V5_DeviceT device);
+double vexDeviceImuDegreesGet(V5_DeviceT device);
+void vexDeviceImuQuaternionGet(V5_DeviceT device, V5_DeviceImuQuaternion* data);
+void vexDeviceImuAttitudeGet(V5_DeviceT device, V5_DeviceImuAttitude* data);
+void vexDeviceImuRawGyroGet(V5_DeviceT device, V5_DeviceImuRaw* data);
+void vexDeviceImuRawAccelGet(V5_DeviceT device, V5_DeviceImuRaw* data);
+uint32_t vexDeviceImuStatusGet(V5_DeviceT device);
+void vexDeviceImuDataRateSet(V5_DeviceT device, uint32_t rate);
+
+// Generic serial
+void vexDeviceGenericSerialEnable(V5_DeviceT device, int32_t options);
+void vexDeviceGenericSerialBaudrate(V5_DeviceT device, int32_t baudrate);
+int32_t vexDeviceGenericSerialWriteChar(V5_DeviceT device, uint8_t c);
+int32_t vexDeviceGenericSerialWriteFree(V5_DeviceT device);
+int32_t vexDeviceGenericSerialTransmit(V5_DeviceT device, uint8_t* buffer, int32_t length);
+int32_t vexDeviceGenericSerialReadChar(V5_DeviceT device);
+int32_t vexDeviceGenericSerialPeekChar(V5_DeviceT device);
+int32_t vexDeviceGenericSerialReceiveAvail(V5_DeviceT device);
+int32_t vexDeviceGenericSerialReceive(V5_DeviceT device, uint8_t* buffer, int32_t length);
+void vexDeviceGenericSerialFlush(V5_DeviceT device);
+
+// File system
+FRESULT vexFileMountSD(void);
+bool vexFileDriveStatus(uint32_t drive);
+FIL* vexFileOpen(const char* filename, const char* mode);
+FIL* vexFileOpenWrite(const char* filename);
+FIL* vexFileOpenCreate(const char* filename);
+void vexFileClose(FIL* fdp);
+int32_t vexFileRead(char* buf, uint32_t size, uint32_t nItems, FIL* fdp);
+int32_t vexFileWrite(char* buf, uint32_t size, uint32_t nItems, FIL* fdp);
+int32_t vexFileSize(FIL* fdp);
+FRESULT vexFileSeek(FIL* fdp, uint32_t offset, int32_t whence);
+int32_t vexFileTell(FIL* fdp);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // V5_API_H_
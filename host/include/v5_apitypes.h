@@ -0,0 +1,205 @@
+/**
+ * \file host/include/v5_apitypes.h
+ *
+ * Types of the VEX V5 SDK, for building the PROS kernel on a host machine.
+ *
+ * Only the types the kernel uses are declared. Layouts follow the SDK so that
+ * the casts the kernel makes between its own structures and these stay valid.
+ *
+ * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef V5_APITYPES_H_
+#define V5_APITYPES_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define V5_MAX_DEVICE_PORTS 32
+
+typedef enum {
+	kDeviceTypeNoSensor = 0,
+	kDeviceTypeMotorSensor = 2,
+	kDeviceTypeLedSensor = 3,
+	kDeviceTypeAbsEncSensor = 4,
+	kDeviceTypeBumperSensor = 5,
+	kDeviceTypeImuSensor = 6,
+	kDeviceTypeRangeSensor = 7,
+	kDeviceTypeRadioSensor = 8,
+	kDeviceTypeTetherSensor = 9,
+	kDeviceTypeBrainSensor = 10,
+	kDeviceTypeVisionSensor = 11,
+	kDeviceTypeAdiSensor = 12,
+	kDeviceTypeGyroSensor = 0x46,
+	kDeviceTypeSonarSensor = 0x47,
+	kDeviceTypeGenericSensor = 128,
+	kDeviceTypeGenericSerial = 129,
+	kDeviceTypeUndefinedSensor = 255
+} V5_DeviceType;
+
+typedef struct _V5_Device* V5_DeviceT;
+
+typedef enum { kControllerMaster = 0, kControllerPartner } V5_ControllerId;
+
+typedef enum {
+	AnaLeftX = 0,
+	AnaLeftY,
+	AnaRightX,
+	AnaRightY,
+	AnaSpare1,
+	AnaSpare2,
+	Button5U,
+	Button5D,
+	Button6U,
+	Button6D,
+	Button7U,
+	Button7D,
+	Button7L,
+	Button7R,
+	Button8U,
+	Button8D,
+	Button8L,
+	Button8R,
+	ButtonSEL,
+	BatteryLevel,
+	ButtonAll,
+	Flags,
+	BatteryCapacity
+} V5_ControllerIndex;
+
+typedef enum { kV5ControllerOffline = 0, kV5ControllerTethered, kV5ControllerVexnet } V5_ControllerStatus;
+
+typedef enum { kMotorEncoderDegrees = 0, kMotorEncoderRotations, kMotorEncoderCounts } V5MotorEncoderUnits;
+typedef enum { kV5MotorBrakeModeCoast = 0, kV5MotorBrakeModeBrake, kV5MotorBrakeModeHold } V5MotorBrakeMode;
+typedef enum { kMotorGearSet_36 = 0, kMotorGearSet_18, kMotorGearSet_06 } V5MotorGearset;
+
+typedef struct __attribute__((__packed__)) _V5_DeviceMotorPid {
+	uint8_t kf;
+	uint8_t kp;
+	uint8_t ki;
+	uint8_t kd;
+	uint8_t filter;
+	uint8_t pad1;
+	uint16_t limit;
+	uint8_t threshold;
+	uint8_t loopspeed;
+	uint8_t pad2[2];
+} V5_DeviceMotorPid;
+
+typedef enum {
+	kAdiPortTypeAnalogIn = 0,
+	kAdiPortTypeAnalogOut,
+	kAdiPortTypeDigitalIn,
+	kAdiPortTypeDigitalOut,
+	kAdiPortTypeSmartButton,
+	kAdiPortTypeSmartPot,
+	kAdiPortTypeLegacyButton,
+	kAdiPortTypeLegacyPotentiometer,
+	kAdiPortTypeLegacyLineSensor,
+	kAdiPortTypeLegacyLightSensor,
+	kAdiPortTypeLegacyGyro,
+	kAdiPortTypeLegacyAccelerometer,
+	kAdiPortTypeLegacyServo,
+	kAdiPortTypeLegacyPwm,
+	kAdiPortTypeQuadEncoder,
+	kAdiPortTypeSonar,
+	kAdiPortTypeLegacyPwmSlew,
+	kAdiPortTypeUndefined = 255
+} V5_AdiPortConfiguration;
+
+typedef enum { kVisionTypeNormal = 0, kVisionTypeColorCode = 1, kVisionTypeLineDetect = 2 } V5VisionBlockType;
+typedef enum { kVisionWBNormal = 0, kVisionWBStart, kVisionWBManual } V5VisionWBMode;
+typedef enum { kVisionLedModeAuto = 0, kVisionLedModeManual } V5VisionLedMode;
+typedef enum { kVisionWifiModeOff = 0, kVisionWifiModeOn } V5VisionWifiMode;
+
+typedef struct __attribute__((__packed__)) _V5_DeviceVisionSignature {
+	uint8_t id;
+	uint8_t flags;
+	uint8_t pad[2];
+	float range;
+	int32_t uMin;
+	int32_t uMax;
+	int32_t uMean;
+	int32_t vMin;
+	int32_t vMax;
+	int32_t vMean;
+	uint32_t mRgb;
+	uint32_t mType;
+} V5_DeviceVisionSignature;
+
+typedef struct __attribute__((__packed__)) _V5_DeviceVisionObject {
+	uint16_t signature;
+	V5VisionBlockType type;
+	uint16_t xoffset;
+	uint16_t yoffset;
+	uint16_t width;
+	uint16_t height;
+	uint16_t angle;
+} V5_DeviceVisionObject;
+
+typedef struct __attribute__((__packed__)) _V5_DeviceVisionRgb {
+	uint8_t red;
+	uint8_t green;
+	uint8_t blue;
+	uint8_t brightness;
+} V5_DeviceVisionRgb;
+
+typedef struct __attribute__((__packed__)) _V5_DeviceImuRaw {
+	double x;
+	double y;
+	double z;
+	double w;
+} V5_DeviceImuRaw;
+
+typedef struct __attribute__((__packed__)) _V5_DeviceImuQuaternion {
+	double a;
+	double b;
+	double c;
+	double d;
+} V5_DeviceImuQuaternion;
+
+typedef struct __attribute__((__packed__)) _V5_DeviceImuAttitude {
+	double pitch;
+	double roll;
+	double yaw;
+} V5_DeviceImuAttitude;
+
+typedef enum {
+	FR_OK = 0,
+	FR_DISK_ERR,
+	FR_INT_ERR,
+	FR_NOT_READY,
+	FR_NO_FILE,
+	FR_NO_PATH,
+	FR_INVALID_NAME,
+	FR_DENIED,
+	FR_EXIST,
+	FR_INVALID_OBJECT,
+	FR_WRITE_PROTECTED,
+	FR_INVALID_DRIVE,
+	FR_NOT_ENABLED,
+	FR_NO_FILESYSTEM,
+	FR_MKFS_ABORTED,
+	FR_TIMEOUT,
+	FR_LOCKED,
+	FR_NOT_ENOUGH_CORE,
+	FR_TOO_MANY_OPEN_FILES,
+	FR_INVALID_PARAMETER
+} FRESULT;
+
+typedef struct _FIL FIL;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // V5_APITYPES_H_
@@ -0,0 +1,309 @@
+/**
+ * \file host/port.c
+ *
+ * FreeRTOS port for running the PROS kernel as a Linux process.
+ *
+ * Every task is backed by a pthread. Each thread waits on its own condition
+ * variable until the scheduler hands it the (simulated) CPU, so exactly one
+ * task's thread makes progress at a time, and switching tasks means waking the
+ * next thread and putting the current one to sleep.
+ *
+ * The tick is a SIGALRM from an interval timer. Only the thread of the running
+ * task ever has SIGALRM unblocked, so the tick always interrupts the running
+ * task, and blocking the signal is the host's equivalent of masking
+ * interrupts. Critical sections nest per thread, which stands in for the
+ * critical nesting count the Cortex-A9 port saves with each task's context.
+ *
+ * Deleting a task wakes its thread, which jumps back to where it started and
+ * exits. Like on the V5, nothing on the task's stack is unwound.
+ *
+ * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <pthread.h>
+#include <setjmp.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+#include "rtos/FreeRTOS.h"
+#include "rtos/task.h"
+#include "system/profiler.h"
+
+typedef struct port_thread_s {
+	pthread_t thread;
+	pthread_mutex_t lock;
+	pthread_cond_t wake;
+	// Set when the thread has been given the CPU, cleared once it takes it
+	bool runnable;
+	// Set when the task has been deleted and its thread should exit
+	bool dying;
+	jmp_buf exit;
+	task_fn_t code;
+	void* parameters;
+} port_thread_s_t;
+
+extern void* volatile pxCurrentTCB;
+
+uint32_t ulPortYieldRequired = pdFALSE;
+// The tick always has the interrupted context at hand, so this is unused
+volatile uint32_t ulPortSaveInterruptedContext = pdFALSE;
+
+static sigset_t tick_signal;
+static __thread port_thread_s_t* current_thread;
+static __thread uint32_t critical_nesting;
+// Context of the code the tick interrupted, while the tick runs
+static __thread ucontext_t* tick_context;
+
+/**
+ * Gets the thread of a task. pxPortInitialiseStack stores a pointer to it at
+ * the top of the task's stack, and pxTopOfStack is the first member of the TCB.
+ */
+static port_thread_s_t* _thread_of(void* tcb) {
+	return **(port_thread_s_t***)tcb;
+}
+
+static void _thread_resume(port_thread_s_t* thread) {
+	pthread_mutex_lock(&thread->lock);
+	thread->runnable = true;
+	pthread_cond_signal(&thread->wake);
+	pthread_mutex_unlock(&thread->lock);
+}
+
+/**
+ * Puts the calling thread to sleep until it is given the CPU again, or exits
+ * it if its task was deleted in the meantime.
+ */
+static void _thread_wait(port_thread_s_t* self) {
+	pthread_mutex_lock(&self->lock);
+	while (!self->runnable && !self->dying) pthread_cond_wait(&self->wake, &self->lock);
+	bool dying = self->dying;
+	self->runnable = false;
+	pthread_mutex_unlock(&self->lock);
+	if (dying) longjmp(self->exit, 1);
+}
+
+/**
+ * Switches to the task FreeRTOS selects. SIGALRM must be blocked.
+ */
+static void _port_switch(void) {
+	port_thread_s_t* self = current_thread;
+	vTaskSwitchContext();
+	port_thread_s_t* next = _thread_of(pxCurrentTCB);
+	if (next == self) return;
+	_thread_resume(next);
+	_thread_wait(self);
+}
+
+static void* _thread_entry(void* arg) {
+	port_thread_s_t* self = (port_thread_s_t*)arg;
+	current_thread = self;
+	if (setjmp(self->exit) == 0) {
+		_thread_wait(self);
+		critical_nesting = 0;
+		pthread_sigmask(SIG_UNBLOCK, &tick_signal, NULL);
+
+		extern void task_fn_wrapper(task_fn_t fn, void* args);
+		task_fn_wrapper(self->code, self->parameters);
+		task_delete(NULL);
+	}
+	pthread_cond_destroy(&self->wake);
+	pthread_mutex_destroy(&self->lock);
+	free(self);
+	return NULL;
+}
+
+task_stack_t* pxPortInitialiseStack(task_stack_t* pxTopOfStack, task_fn_t pxCode, void* pvParameters) {
+	port_thread_s_t* thread = (port_thread_s_t*)calloc(1, sizeof(port_thread_s_t));
+	configASSERT(thread != NULL);
+	pthread_mutex_init(&thread->lock, NULL);
+	pthread_cond_init(&thread->wake, NULL);
+	thread->code = pxCode;
+	thread->parameters = pvParameters;
+
+	// The thread starts with every signal blocked, and only unblocks the tick
+	// once it is first scheduled
+	sigset_t all, previous;
+	sigfillset(&all);
+	pthread_sigmask(SIG_SETMASK, &all, &previous);
+	pthread_attr_t attr;
+	pthread_attr_init(&attr);
+	pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+	int result = pthread_create(&thread->thread, &attr, _thread_entry, thread);
+	pthread_attr_destroy(&attr);
+	pthread_sigmask(SIG_SETMASK, &previous, NULL);
+	configASSERT(result == 0);
+
+	pxTopOfStack -= sizeof(port_thread_s_t*) / sizeof(task_stack_t);
+	*(port_thread_s_t**)pxTopOfStack = thread;
+	return pxTopOfStack;
+}
+
+void vPortCleanUpTCB(void* pxTCB) {
+	port_thread_s_t* thread = _thread_of(pxTCB);
+	pthread_mutex_lock(&thread->lock);
+	thread->dying = true;
+	pthread_cond_signal(&thread->wake);
+	pthread_mutex_unlock(&thread->lock);
+}
+
+static void _port_tick(int signal, siginfo_t* info, void* context) {
+	// The tick "interrupt" ends before the switch, since the switch blocks this
+	// thread until its task runs again
+	trace_hook(E_TRACE_ISR_ENTER, 0, signal, 0);
+	tick_context = (ucontext_t*)context;
+	int32_t switch_required = xTaskIncrementTick();
+	tick_context = NULL;
+	trace_hook(E_TRACE_ISR_EXIT, 0, signal, 0);
+	if (switch_required != pdFALSE) _port_switch();
+}
+
+int32_t xPortStartScheduler(void) {
+	struct sigaction tick;
+	tick.sa_sigaction = _port_tick;
+	tick.sa_flags = SA_RESTART | SA_SIGINFO;
+	sigemptyset(&tick.sa_mask);
+	sigaction(SIGALRM, &tick, NULL);
+
+	// The main thread never runs a task, so it must never take the tick
+	pthread_sigmask(SIG_BLOCK, &tick_signal, NULL);
+	portCONFIGURE_TIMER_FOR_RUN_TIME_STATS();
+	struct itimerval period = {.it_interval = {.tv_sec = 0, .tv_usec = portTICK_PERIOD_MS * 1000},
+	                           .it_value = {.tv_sec = 0, .tv_usec = portTICK_PERIOD_MS * 1000}};
+	setitimer(ITIMER_REAL, &period, NULL);
+
+	_thread_resume(_thread_of(pxCurrentTCB));
+	for (;;) pause();
+	return 0;
+}
+
+// There is nothing for rtos_sched_start to return to that wouldn't report the
+// scheduler as having failed, so stopping the scheduler ends the process
+void vPortEndScheduler(void) {
+	struct itimerval stop = {{0, 0}, {0, 0}};
+	setitimer(ITIMER_REAL, &stop, NULL);
+	exit(EXIT_SUCCESS);
+}
+
+void vPortYield(void) {
+	if (current_thread == NULL) return;
+	sigset_t previous;
+	pthread_sigmask(SIG_BLOCK, &tick_signal, &previous);
+	_port_switch();
+	pthread_sigmask(SIG_SETMASK, &previous, NULL);
+}
+
+uint32_t ulPortSetInterruptMask(void) {
+	sigset_t previous;
+	pthread_sigmask(SIG_BLOCK, &tick_signal, &previous);
+	return sigismember(&previous, SIGALRM) == 1;
+}
+
+void vPortClearInterruptMask(uint32_t ulNewMaskValue) {
+	if (ulNewMaskValue == 0) pthread_sigmask(SIG_UNBLOCK, &tick_signal, NULL);
+}
+
+void vPortEnterCritical(void) {
+	ulPortSetInterruptMask();
+	critical_nesting++;
+}
+
+void vPortExitCritical(void) {
+	if (critical_nesting > 0) {
+		critical_nesting--;
+		if (critical_nesting == 0) vPortClearInterruptMask(0);
+	}
+}
+
+/******************************************************************************/
+/**                   Replacements for system/rtos_hooks.c                   **/
+/******************************************************************************/
+void rtos_initialize() {
+	sigemptyset(&tick_signal);
+	sigaddset(&tick_signal, SIGALRM);
+
+	void linked_list_initialize(void);
+	linked_list_initialize();
+
+	void task_notify_when_deleting_init();
+	task_notify_when_deleting_init();
+}
+
+void vInitialiseTimerForRunTimeStats(void) {}
+
+void vApplicationTickHook(void) {
+	profiler_tick();
+}
+
+void vApplicationMallocFailedHook(void) {
+	fprintf(stderr, "FATAL ERROR!! The kernel heap is exhausted\n");
+	extern void print_heap_stats(void);
+	print_heap_stats();
+	fflush(stdout);
+	abort();
+}
+
+void vApplicationStackOverflowHook(task_t pxTask, char* pcTaskName) {
+	(void)pxTask;
+	fprintf(stderr, "FATAL ERROR!! Task %s overflowed its stack!\n", pcTaskName);
+	abort();
+}
+
+// Sleep until the next tick instead of spinning, like a WFI would
+void vApplicationIdleHook(void) {
+	sigset_t unblocked;
+	pthread_sigmask(SIG_SETMASK, NULL, &unblocked);
+	sigdelset(&unblocked, SIGALRM);
+	sigsuspend(&unblocked);
+}
+
+void vAssertCalled(const char* pcFile, unsigned long ulLine) {
+	fprintf(stderr, "FATAL ERROR!! Kernel assertion failed at %s:%lu\n", pcFile, ulLine);
+	abort();
+}
+
+/**
+ * Replacement for the one in system/unwind.c. Samples only hold the interrupted
+ * program counter, since there is no unwinder for the host's code. Tests are
+ * linked at a fixed address below 4 GiB so that it fits in 32 bits.
+ */
+size_t backtrace_interrupted(uint32_t* pcs, size_t max) {
+	if (!max || !tick_context) return 0;
+#if defined(__x86_64__)
+	pcs[0] = (uint32_t)tick_context->uc_mcontext.gregs[REG_RIP];
+#elif defined(__aarch64__)
+	pcs[0] = (uint32_t)tick_context->uc_mcontext.pc;
+#else
+	return 0;
+#endif
+	return 1;
+}
+
+void vApplicationGetIdleTaskMemory(static_task_s_t** ppxIdleTaskTCBBuffer, task_stack_t** ppxIdleTaskStackBuffer,
+                                   uint32_t* pulIdleTaskStackSize) {
+	static static_task_s_t xIdleTaskTCB;
+	static task_stack_t uxIdleTaskStack[configMINIMAL_STACK_SIZE];
+
+	*ppxIdleTaskTCBBuffer = &xIdleTaskTCB;
+	*ppxIdleTaskStackBuffer = uxIdleTaskStack;
+	*pulIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+
+void vApplicationGetTimerTaskMemory(static_task_s_t** ppxTimerTaskTCBBuffer, task_stack_t** ppxTimerTaskStackBuffer,
+                                    uint32_t* pulTimerTaskStackSize) {
+	static static_task_s_t xTimerTaskTCB;
+	static task_stack_t uxTimerTaskStack[configTIMER_TASK_STACK_DEPTH];
+
+	*ppxTimerTaskTCBBuffer = &xTimerTaskTCB;
+	*ppxTimerTaskStackBuffer = uxTimerTaskStack;
+	*pulTimerTaskStackSize = configTIMER_TASK_STACK_DEPTH;
+}
@@ -0,0 +1,58 @@
+/**
+ * \file host/system.c
+ *
+ * Replacements for the parts of the system layer which only make sense on the
+ * V5 when the PROS kernel runs on a host machine.
+ *
+ * The host C library takes the place of newlib, so there is no reentrancy
+ * structure to switch between tasks, and there is no hot/cold linking: user
+ * code is always linked into the same program as the kernel.
+ *
+ * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <reent.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "system/hot.h"
+
+// FreeRTOS points this at the running task's reentrancy structure, which
+// nothing on the host reads
+struct _reent* _impure_ptr;
+// Already initialized, so vfs_initialize never calls __sinit
+struct _reent _host_global_reent = {._errno = 0, .__sdidinit = 1};
+
+void __sinit(struct _reent* s) {
+	(void)s;
+}
+
+// newlib's integer-only printf
+int iprintf(const char* fmt, ...) {
+	va_list args;
+	va_start(args, fmt);
+	int rtn = vprintf(fmt, args);
+	va_end(args);
+	return rtn;
+}
+
+int vsniprintf(char* str, size_t size, const char* fmt, va_list args) {
+	return vsnprintf(str, size, fmt, args);
+}
+
+// The ADI driver isn't part of the host build (see the Makefile), so there are
+// never any analog sensors to calibrate
+void adi_background_processing(void) {}
+
+static struct hot_table __HOT_TABLE = {0};
+struct hot_table* const HOT_TABLE = &__HOT_TABLE;
+
+void invoke_install_hot_table() {
+	memset(HOT_TABLE, 0, sizeof(*HOT_TABLE));
+}
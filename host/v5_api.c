@@ -0,0 +1,333 @@
+/**
+ * \file host/v5_api.c
+ *
+ * Stand-in for the VEX V5 SDK when the PROS kernel runs on a host machine.
+ *
+ * It behaves like a brain with nothing plugged into it: every smart port is
+ * empty, no controller is connected, and there is no SD card. Serial output
+ * goes to stdout and the high resolution timer is the host's monotonic clock,
+ * which is all the kernel needs to run tasks and the system daemon.
+ *
+ * The exceptions are an Inertial Sensor which sits still and produces a sample
+ * every millisecond, plugged into the port given by the PROS_HOST_IMU_PORT
+ * environment variable, so that the IMU sampler can run, and a generic serial
+ * port whose output is wired back to its input, plugged into the port given by
+ * PROS_HOST_SERIAL_PORT.
+ *
+ * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "v5_api.h"
+
+// VEXos 1.0.13, new enough for everything the kernel checks for
+#define HOST_SYSTEM_VERSION 0x01000D00
+
+struct _V5_Device {
+	uint32_t index;
+};
+
+static struct _V5_Device devices[V5_MAX_DEVICE_PORTS];
+static uint64_t start_time;
+static int32_t imu_port = -1;  // index of the simulated Inertial Sensor
+static int32_t serial_port = -1;  // index of the loopback generic serial port
+
+// The loopback port's FIFO, the size of VEXos's own
+#define SERIAL_FIFO_SIZE 1024
+static uint8_t serial_fifo[SERIAL_FIFO_SIZE];
+static uint32_t serial_head;  // next byte to be written
+static uint32_t serial_count;
+
+static uint64_t _host_time_us(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000000 + (uint64_t)now.tv_nsec / 1000;
+}
+
+// Runs before the kernel's own constructors so that the brain "powers up" first
+__attribute__((constructor(101))) static void _host_power_on(void) {
+	start_time = _host_time_us();
+	for (uint32_t i = 0; i < V5_MAX_DEVICE_PORTS; i++) devices[i].index = i;
+	const char* port = getenv("PROS_HOST_IMU_PORT");
+	if (port) imu_port = atoi(port) - 1;
+	port = getenv("PROS_HOST_SERIAL_PORT");
+	if (port) serial_port = atoi(port) - 1;
+}
+
+/******************************************************************************/
+/**                                 System                                   **/
+/******************************************************************************/
+void vexBackgroundProcessing(void) {}
+
+uint64_t vexSystemHighResTimeGet(void) {
+	return _host_time_us() - start_time;
+}
+
+uint32_t vexSystemTimeGet(void) {
+	return (uint32_t)(vexSystemHighResTimeGet() / 1000);
+}
+
+uint32_t vexSystemWatchdogGet(void) {
+	return (uint32_t)vexSystemHighResTimeGet();
+}
+
+uint32_t vexSystemVersion(void) {
+	return HOST_SYSTEM_VERSION;
+}
+
+// Enabled, in driver control, and not connected to a field
+uint32_t vexCompetitionStatus(void) {
+	return 0;
+}
+
+/******************************************************************************/
+/**                             Serial & Display                             **/
+/******************************************************************************/
+int32_t vexSerialWriteBuffer(uint32_t channel, uint8_t* data, uint32_t data_len) {
+	(void)channel;
+	// Bypass stdio: a task preempted while it holds the stdout lock would
+	// otherwise block the system daemon
+	return (int32_t)write(STDOUT_FILENO, data, data_len);
+}
+
+int32_t vexSerialReadChar(uint32_t channel) {
+	(void)channel;
+	return -1;
+}
+
+int32_t vexSerialWriteFree(uint32_t channel) {
+	(void)channel;
+	return 2048;
+}
+
+void vexDisplayForegroundColor(uint32_t col) {}
+void vexDisplayBackgroundColor(uint32_t col) {}
+void vexDisplayErase(void) {}
+void vexDisplayRectFill(int32_t x1, int32_t y1, int32_t x2, int32_t y2) {}
+void vexDisplayRectClear(int32_t x1, int32_t y1, int32_t x2, int32_t y2) {}
+void vexDisplayString(const int32_t nLineNumber, const char* format, ...) {}
+void vexDisplayCenteredString(const int32_t nLineNumber, const char* format, ...) {}
+void vexDisplayPrintf(int32_t xpos, int32_t ypos, uint32_t bOpaque, const char* format, ...) {}
+
+/******************************************************************************/
+/**                           Battery & Controller                           **/
+/******************************************************************************/
+int32_t vexBatteryVoltageGet(void) {
+	return 12800;
+}
+int32_t vexBatteryCurrentGet(void) {
+	return 0;
+}
+double vexBatteryTemperatureGet(void) {
+	return 25.0;
+}
+double vexBatteryCapacityGet(void) {
+	return 100.0;
+}
+
+int32_t vexControllerGet(V5_ControllerId id, V5_ControllerIndex index) {
+	return 0;
+}
+V5_ControllerStatus vexControllerConnectionStatusGet(V5_ControllerId id) {
+	return kV5ControllerOffline;
+}
+bool vexControllerTextSet(V5_ControllerId id, uint32_t line, uint32_t col, const char* str) {
+	return true;
+}
+
+/******************************************************************************/
+/**                                 Devices                                  **/
+/******************************************************************************/
+int32_t vexDeviceGetStatus(V5_DeviceType* buffer) {
+	for (uint32_t i = 0; i < V5_MAX_DEVICE_PORTS; i++) buffer[i] = kDeviceTypeNoSensor;
+	if (imu_port >= 0 && imu_port < V5_MAX_DEVICE_PORTS) buffer[imu_port] = kDeviceTypeImuSensor;
+	if (serial_port >= 0 && serial_port < V5_MAX_DEVICE_PORTS) buffer[serial_port] = kDeviceTypeGenericSerial;
+	return 0;
+}
+
+V5_DeviceT vexDeviceGetByIndex(uint32_t index) {
+	return index < V5_MAX_DEVICE_PORTS ? &devices[index] : NULL;
+}
+
+uint32_t vexDeviceTimestampGet(V5_DeviceT device) {
+	return vexSystemTimeGet();
+}
+
+// Apart from the simulated Inertial Sensor and serial port nothing is ever
+// plugged in, so the kernel never gets far enough to use these for anything but
+// their return values
+
+void vexDeviceMotorVelocitySet(V5_DeviceT device, int32_t velocity) {}
+void vexDeviceMotorVelocityUpdate(V5_DeviceT device, int32_t velocity) {}
+int32_t vexDeviceMotorVelocityGet(V5_DeviceT device) { return 0; }
+double vexDeviceMotorActualVelocityGet(V5_DeviceT device) { return 0; }
+int32_t vexDeviceMotorDirectionGet(V5_DeviceT device) { return 0; }
+void vexDeviceMotorCurrentLimitSet(V5_DeviceT device, int32_t value) {}
+int32_t vexDeviceMotorCurrentLimitGet(V5_DeviceT device) { return 0; }
+int32_t vexDeviceMotorCurrentGet(V5_DeviceT device) { return 0; }
+double vexDeviceMotorPowerGet(V5_DeviceT device) { return 0; }
+double vexDeviceMotorTorqueGet(V5_DeviceT device) { return 0; }
+double vexDeviceMotorEfficiencyGet(V5_DeviceT device) { return 0; }
+double vexDeviceMotorTemperatureGet(V5_DeviceT device) { return 0; }
+bool vexDeviceMotorOverTempFlagGet(V5_DeviceT device) { return false; }
+bool vexDeviceMotorCurrentLimitFlagGet(V5_DeviceT device) { return false; }
+uint32_t vexDeviceMotorFaultsGet(V5_DeviceT device) { return 0; }
+bool vexDeviceMotorZeroVelocityFlagGet(V5_DeviceT device) { return true; }
+bool vexDeviceMotorZeroPositionFlagGet(V5_DeviceT device) { return true; }
+uint32_t vexDeviceMotorFlagsGet(V5_DeviceT device) { return 0; }
+void vexDeviceMotorReverseFlagSet(V5_DeviceT device, bool value) {}
+bool vexDeviceMotorReverseFlagGet(V5_DeviceT device) { return false; }
+void vexDeviceMotorEncoderUnitsSet(V5_DeviceT device, V5MotorEncoderUnits units) {}
+V5MotorEncoderUnits vexDeviceMotorEncoderUnitsGet(V5_DeviceT device) { return kMotorEncoderDegrees; }
+void vexDeviceMotorBrakeModeSet(V5_DeviceT device, V5MotorBrakeMode mode) {}
+V5MotorBrakeMode vexDeviceMotorBrakeModeGet(V5_DeviceT device) { return kV5MotorBrakeModeCoast; }
+void vexDeviceMotorPositionSet(V5_DeviceT device, double position) {}
+double vexDeviceMotorPositionGet(V5_DeviceT device) { return 0; }
+int32_t vexDeviceMotorPositionRawGet(V5_DeviceT device, uint32_t* timestamp) {
+	if (timestamp) *timestamp = vexSystemTimeGet();
+	return 0;
+}
+void vexDeviceMotorPositionReset(V5_DeviceT device) {}
+double vexDeviceMotorTargetGet(V5_DeviceT device) { return 0; }
+void vexDeviceMotorAbsoluteTargetSet(V5_DeviceT device, double position, int32_t veloctiy) {}
+void vexDeviceMotorRelativeTargetSet(V5_DeviceT device, double position, int32_t velocity) {}
+void vexDeviceMotorGearingSet(V5_DeviceT device, V5MotorGearset value) {}
+V5MotorGearset vexDeviceMotorGearingGet(V5_DeviceT device) { return kMotorGearSet_18; }
+void vexDeviceMotorVoltageSet(V5_DeviceT device, int32_t value) {}
+int32_t vexDeviceMotorVoltageGet(V5_DeviceT device) { return 0; }
+void vexDeviceMotorVoltageLimitSet(V5_DeviceT device, int32_t value) {}
+int32_t vexDeviceMotorVoltageLimitGet(V5_DeviceT device) { return 0; }
+void vexDeviceMotorPositionPidSet(V5_DeviceT device, V5_DeviceMotorPid* pid) {}
+
+void vexDeviceAdiPortConfigSet(V5_DeviceT device, uint32_t port, V5_AdiPortConfiguration type) {}
+V5_AdiPortConfiguration vexDeviceAdiPortConfigGet(V5_DeviceT device, uint32_t port) { return kAdiPortTypeUndefined; }
+void vexDeviceAdiValueSet(V5_DeviceT device, uint32_t port, int32_t value) {}
+int32_t vexDeviceAdiValueGet(V5_DeviceT device, uint32_t port) { return 0; }
+
+int32_t vexDeviceVisionObjectCountGet(V5_DeviceT device) { return 0; }
+int32_t vexDeviceVisionObjectGet(V5_DeviceT device, uint32_t indexObj, V5_DeviceVisionObject* pObject) { return 0; }
+void vexDeviceVisionSignatureSet(V5_DeviceT device, V5_DeviceVisionSignature* pSignature) {}
+bool vexDeviceVisionSignatureGet(V5_DeviceT device, uint32_t id, V5_DeviceVisionSignature* pSignature) {
+	return false;
+}
+void vexDeviceVisionBrightnessSet(V5_DeviceT device, uint8_t value) {}
+uint8_t vexDeviceVisionBrightnessGet(V5_DeviceT device) { return 0; }
+void vexDeviceVisionWhiteBalanceModeSet(V5_DeviceT device, V5VisionWBMode mode) {}
+void vexDeviceVisionWhiteBalanceSet(V5_DeviceT device, V5_DeviceVisionRgb color) {}
+V5_DeviceVisionRgb vexDeviceVisionWhiteBalanceGet(V5_DeviceT device) {
+	V5_DeviceVisionRgb rgb = {0};
+	return rgb;
+}
+void vexDeviceVisionLedModeSet(V5_DeviceT device, V5VisionLedMode mode) {}
+void vexDeviceVisionLedColorSet(V5_DeviceT device, V5_DeviceVisionRgb color) {}
+void vexDeviceVisionWifiModeSet(V5_DeviceT device, V5VisionWifiMode mode) {}
+
+void vexDeviceImuReset(V5_DeviceT device) {}
+double vexDeviceImuHeadingGet(V5_DeviceT device) { return 0; }
+double vexDeviceImuDegreesGet(V5_DeviceT device) { return 0; }
+void vexDeviceImuQuaternionGet(V5_DeviceT device, V5_DeviceImuQuaternion* data) {
+	memset(data, 0, sizeof(*data));
+}
+void vexDeviceImuAttitudeGet(V5_DeviceT device, V5_DeviceImuAttitude* data) {
+	memset(data, 0, sizeof(*data));
+}
+void vexDeviceImuRawGyroGet(V5_DeviceT device, V5_DeviceImuRaw* data) {
+	memset(data, 0, sizeof(*data));
+}
+void vexDeviceImuRawAccelGet(V5_DeviceT device, V5_DeviceImuRaw* data) {
+	// Level and at rest
+	memset(data, 0, sizeof(*data));
+	data->z = 1;
+}
+uint32_t vexDeviceImuStatusGet(V5_DeviceT device) { return 0; }
+void vexDeviceImuDataRateSet(V5_DeviceT device, uint32_t rate) {}
+
+void vexDeviceGenericSerialEnable(V5_DeviceT device, int32_t options) {}
+void vexDeviceGenericSerialBaudrate(V5_DeviceT device, int32_t baudrate) {}
+
+static bool _serial_is_loopback(V5_DeviceT device) {
+	return (int32_t)device->index == serial_port;
+}
+
+int32_t vexDeviceGenericSerialTransmit(V5_DeviceT device, uint8_t* buffer, int32_t length) {
+	if (!_serial_is_loopback(device)) return -1;
+	int32_t n = 0;
+	for (; n < length && serial_count < SERIAL_FIFO_SIZE; n++, serial_count++) {
+		serial_fifo[serial_head] = buffer[n];
+		serial_head = (serial_head + 1) % SERIAL_FIFO_SIZE;
+	}
+	return n;
+}
+int32_t vexDeviceGenericSerialWriteChar(V5_DeviceT device, uint8_t c) {
+	return vexDeviceGenericSerialTransmit(device, &c, 1) == 1 ? c : -1;
+}
+int32_t vexDeviceGenericSerialWriteFree(V5_DeviceT device) {
+	return _serial_is_loopback(device) ? SERIAL_FIFO_SIZE - serial_count : 0;
+}
+int32_t vexDeviceGenericSerialReceive(V5_DeviceT device, uint8_t* buffer, int32_t length) {
+	if (!_serial_is_loopback(device)) return 0;
+	int32_t n = 0;
+	for (; n < length && serial_count > 0; n++, serial_count--) {
+		buffer[n] = serial_fifo[(serial_head + SERIAL_FIFO_SIZE - serial_count) % SERIAL_FIFO_SIZE];
+	}
+	return n;
+}
+int32_t vexDeviceGenericSerialPeekChar(V5_DeviceT device) {
+	if (!_serial_is_loopback(device) || serial_count == 0) return -1;
+	return serial_fifo[(serial_head + SERIAL_FIFO_SIZE - serial_count) % SERIAL_FIFO_SIZE];
+}
+int32_t vexDeviceGenericSerialReadChar(V5_DeviceT device) {
+	uint8_t c;
+	return vexDeviceGenericSerialReceive(device, &c, 1) == 1 ? c : -1;
+}
+int32_t vexDeviceGenericSerialReceiveAvail(V5_DeviceT device) {
+	return _serial_is_loopback(device) ? serial_count : 0;
+}
+void vexDeviceGenericSerialFlush(V5_DeviceT device) {
+	if (_serial_is_loopback(device)) serial_count = 0;
+}
+
+/******************************************************************************/
+/**                               File System                                **/
+/******************************************************************************/
+FRESULT vexFileMountSD(void) {
+	return FR_NOT_READY;
+}
+bool vexFileDriveStatus(uint32_t drive) {
+	return false;
+}
+FIL* vexFileOpen(const char* filename, const char* mode) {
+	return NULL;
+}
+FIL* vexFileOpenWrite(const char* filename) {
+	return NULL;
+}
+FIL* vexFileOpenCreate(const char* filename) {
+	return NULL;
+}
+void vexFileClose(FIL* fdp) {}
+int32_t vexFileRead(char* buf, uint32_t size, uint32_t nItems, FIL* fdp) {
+	return 0;
+}
+int32_t vexFileWrite(char* buf, uint32_t size, uint32_t nItems, FIL* fdp) {
+	return 0;
+}
+int32_t vexFileSize(FIL* fdp) {
+	return 0;
+}
+FRESULT vexFileSeek(FIL* fdp, uint32_t offset, int32_t whence) {
+	return FR_INVALID_OBJECT;
+}
+int32_t vexFileTell(FIL* fdp) {
+	return 0;
+}
@@ -49,10 +49,13 @@
 
 #include "pros/adi.h"
 #include "pros/colors.h"
+#include "pros/control_loop.h"
+#include "pros/frame.h"
 #include "pros/imu.h"
 #include "pros/llemu.h"
 #include "pros/misc.h"
 #include "pros/motors.h"
+#include "pros/odometry.h"
 #include "pros/rtos.h"
 #include "pros/vision.h"
 
@@ -17,7 +17,9 @@
 
 #include <stdint.h>
 
-#define COBS_ENCODE_MEASURE_MAX(src_len) ((src_len) + (((src_len) + 253) / 254))
+// One code byte for every 254 bytes of src, plus the one which starts it, so
+// src_len + 1 bytes when src_len is 0 or a multiple of 254
+#define COBS_ENCODE_MEASURE_MAX(src_len) ((src_len) + ((src_len) / 254) + 1)
 
 /**
  * Encodes src in the Consistent Overhead Byte Stuffing algorithm, and writes
@@ -52,3 +54,37 @@ int cobs_encode(uint8_t* restrict dest, const uint8_t* restrict src, const size_
  * \return The size of src when encoded
  */
 size_t cobs_encode_measure(const uint8_t* restrict src, const size_t src_len, const uint32_t prefix);
+
+/**
+ * Same as cobs_encode() but without the four character stream identifier.
+ * dest needs at most COBS_ENCODE_MEASURE_MAX(src_len) bytes, which is exactly
+ * what a src without any zero bytes takes.
+ *
+ * \param[out] dest
+ *             The location to write the stuffed data to
+ * \param[in] src
+ *            The location of the incoming data
+ * \param src_len
+ *        The length of the source data
+ *
+ * \return The number of bytes written
+ */
+int cobs_encode_raw(uint8_t* restrict dest, const uint8_t* restrict src, const size_t src_len);
+
+/**
+ * Decodes data stuffed with cobs_encode_raw(). The trailing zero delimiter
+ * must not be included in src.
+ *
+ * Decoding never writes ahead of the read position, so dest may be the same
+ * buffer as src to decode in place.
+ *
+ * \param[out] dest
+ *             The location to write the decoded data to
+ * \param[in] src
+ *            The location of the stuffed data
+ * \param src_len
+ *        The length of the stuffed data
+ *
+ * \return The number of bytes written, or -1 if src is not valid COBS
+ */
+int cobs_decode(uint8_t* dest, const uint8_t* src, const size_t src_len);
@@ -0,0 +1,39 @@
+/**
+ * \file common/crc.h
+ *
+ * Cyclic Redundancy Check header
+ *
+ * See common/crc.c for discussion
+ *
+ * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define CRC16_INIT 0xFFFF
+
+/**
+ * Computes the CRC-16/CCITT-FALSE (polynomial 0x1021) of data, continuing
+ * from a previous value.
+ *
+ * Pass CRC16_INIT as crc to start a new checksum. The result of a previous
+ * call may be passed to checksum data which is split across several buffers.
+ *
+ * \param crc
+ *        The running checksum
+ * \param[in] data
+ *            The data to checksum
+ * \param len
+ *        The length of the data
+ *
+ * \return The updated checksum
+ */
+uint16_t crc16(uint16_t crc, const uint8_t* data, size_t len);
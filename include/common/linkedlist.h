@@ -29,6 +29,12 @@ typedef struct {
 	ll_node_s_t* head;
 } linked_list_s_t;
 
+/**
+ * Creates the pool linked lists and their nodes are allocated from. Called by
+ * rtos_initialize before any list is made.
+ */
+void linked_list_initialize(void);
+
 /**
  * Initialize a linked list node storing an arbitrary function pointer
  *
@@ -0,0 +1,92 @@
+/**
+ * \file common/seqlock.h
+ *
+ * Sequence lock header
+ *
+ * See common/seqlock.c for discussion
+ *
+ * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct seqlock {
+	volatile uint32_t sequence;  // odd while a write is in progress
+} seqlock_s_t;
+
+/**
+ * Marks the start of an update to the data protected by lock. There must only
+ * be one writer.
+ *
+ * \param lock
+ *        The sequence lock
+ */
+static inline void seqlock_write_begin(seqlock_s_t* lock) {
+	lock->sequence++;
+	__sync_synchronize();
+}
+
+/**
+ * Marks the end of an update to the data protected by lock.
+ *
+ * \param lock
+ *        The sequence lock
+ */
+static inline void seqlock_write_end(seqlock_s_t* lock) {
+	__sync_synchronize();
+	lock->sequence++;
+}
+
+/**
+ * Marks the start of a read of the data protected by lock.
+ *
+ * \param lock
+ *        The sequence lock
+ *
+ * \return The sequence number to pass to seqlock_read_retry()
+ */
+static inline uint32_t seqlock_read_begin(const seqlock_s_t* lock) {
+	uint32_t sequence = lock->sequence;
+	__sync_synchronize();
+	return sequence;
+}
+
+/**
+ * Checks whether a read which began with seqlock_read_begin() overlapped with a
+ * write, in which case the data read may be torn and must be read again.
+ *
+ * \param lock
+ *        The sequence lock
+ * \param sequence
+ *        The value returned by seqlock_read_begin()
+ *
+ * \return True if the read must be retried
+ */
+static inline bool seqlock_read_retry(const seqlock_s_t* lock, uint32_t sequence) {
+	__sync_synchronize();
+	return (sequence & 1) || lock->sequence != sequence;
+}
+
+/**
+ * Copies size bytes of data protected by lock from src to dest, retrying until
+ * the copy is consistent.
+ *
+ * \param lock
+ *        The sequence lock
+ * \param[out] dest
+ *             The location to copy the data to
+ * \param[in] src
+ *            The data protected by the lock
+ * \param size
+ *        The number of bytes to copy
+ */
+void seqlock_read(const seqlock_s_t* lock, void* dest, const void* src, size_t size);
@@ -239,18 +239,24 @@ int32_t adi_port_set_value(uint8_t smart_port, uint8_t adi_port, int32_t value);
  * calibration value.
  *
  * This method assumes that the true sensor value is not actively changing at
- * this time and computes an average from approximately 500 samples, 1 ms apart,
- * for a 0.5 s period of calibration. The average value thus calculated is
- * returned and stored for later calls to the adi_analog_read_calibrated() and
- * adi_analog_read_calibrated_HR() functions. These functions will return
- * the difference between this value and the current sensor value when called.
+ * this time and computes an average from 50 samples, 10 ms apart (the ADI
+ * update rate), for a 0.5 s period of calibration. The average value thus
+ * calculated is returned and stored for later calls to the
+ * adi_analog_read_calibrated() and adi_analog_read_calibrated_HR() functions.
+ * These functions will return the difference between this value and the
+ * current sensor value when called.
  *
  * Do not use this function when the sensor value might be unstable
  * (gyro rotation, accelerometer movement).
  *
+ * This is equivalent to adi_analog_calibrate_async() followed by
+ * adi_analog_calibrate_wait(). To calibrate several sensors, start them all
+ * with adi_analog_calibrate_async() first so that they calibrate concurrently.
+ *
  * This function uses the following values of errno when an error state is
  * reached:
  * ENXIO - The given value is not within the range of ADI Ports
+ * EADDRINUSE - The port is not configured as an analog input
  *
  * \param smart_port
  *        The smart port number that the ADI Expander is on (INTERNAL_ADI_PORT for ADI ports on the brain)
@@ -261,6 +267,77 @@ int32_t adi_port_set_value(uint8_t smart_port, uint8_t adi_port, int32_t value);
  */
 int32_t adi_analog_calibrate(uint8_t smart_port, uint8_t adi_port);
 
+/**
+ * Starts calibrating the analog sensor on the specified port in the
+ * background.
+ *
+ * The system daemon samples every port with a calibration in progress each
+ * time the ADI values update, so any number of sensors calibrate concurrently
+ * in the time it takes adi_analog_calibrate() to calibrate one. Use
+ * adi_analog_calibrate_wait() to wait for the result. Restarting a calibration
+ * in progress discards the samples taken so far.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of ADI Ports
+ * EADDRINUSE - The port is not configured as an analog input
+ *
+ * \param smart_port
+ *        The smart port number that the ADI Expander is on (INTERNAL_ADI_PORT for ADI ports on the brain)
+ * \param adi_port
+ *        The ADI port number (from 1-8, 'a'-'h', 'A'-'H') to calibrate
+ *
+ * \return 1 if the calibration was started, or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t adi_analog_calibrate_async(uint8_t smart_port, uint8_t adi_port);
+
+/**
+ * Waits for a calibration started by adi_analog_calibrate_async() to finish.
+ *
+ * Returns immediately if the calibration has already finished.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of ADI Ports
+ * EINVAL - No calibration was started on the port
+ * EADDRINUSE - The port stopped being an analog input during the calibration
+ * EAGAIN - The timeout expired before the calibration finished
+ *
+ * \param smart_port
+ *        The smart port number that the ADI Expander is on (INTERNAL_ADI_PORT for ADI ports on the brain)
+ * \param adi_port
+ *        The ADI port number (from 1-8, 'a'-'h', 'A'-'H') to wait for
+ * \param timeout
+ *        The maximum time to wait, in milliseconds, or TIMEOUT_MAX to wait
+ *        until the calibration finishes
+ *
+ * \return The average sensor value computed by the calibration, or PROS_ERR if
+ * the operation failed, setting errno.
+ */
+int32_t adi_analog_calibrate_wait(uint8_t smart_port, uint8_t adi_port, uint32_t timeout);
+
+/**
+ * Gets the variance of the samples taken by the last finished calibration of
+ * the specified port.
+ *
+ * A large variance means the sensor was moving or noisy during calibration.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of ADI Ports
+ * EINVAL - No calibration has finished on the port
+ *
+ * \param smart_port
+ *        The smart port number that the ADI Expander is on (INTERNAL_ADI_PORT for ADI ports on the brain)
+ * \param adi_port
+ *        The ADI port number (from 1-8, 'a'-'h', 'A'-'H')
+ *
+ * \return The variance of the calibration samples, in squared 12-bit sensor
+ * units, or PROS_ERR_F if the operation failed, setting errno.
+ */
+double adi_analog_get_calibration_variance(uint8_t smart_port, uint8_t adi_port);
+
 /**
  * Gets the 12-bit value of the specified port.
  *
@@ -21,6 +21,7 @@
 #include <cstdint>
 
 #include "pros/adi.h"
+#include "pros/rtos.h"
 
 namespace pros {
 class ADIPort {
@@ -85,7 +86,7 @@ class ADIPort {
 	protected:
 	ADIPort(void);
 	std::uint8_t _adi_port;
-	std::uint8_t _smart_port
+	std::uint8_t _smart_port;
 };
 
 class ADIAnalogIn : private ADIPort {
@@ -114,8 +115,8 @@ class ADIAnalogIn : private ADIPort {
 	 * calibration value.
 	 *
 	 * This method assumes that the true sensor value is not actively changing at
-	 * this time and computes an average from approximately 500 samples, 1 ms
-	 * apart, for a 0.5 s period of calibration. The average value thus calculated
+	 * this time and computes an average from 50 samples, 10 ms apart, for a
+	 * 0.5 s period of calibration. The average value thus calculated
 	 * is returned and stored for later calls to the
 	 * pros::ADIAnalogIn::get_value_calibrated() and
 	 * pros::ADIAnalogIn::get_value_calibrated_HR() functions. These functions
@@ -133,6 +134,40 @@ class ADIAnalogIn : private ADIPort {
 	 */
 	std::int32_t calibrate(void) const;
 
+	/**
+	 * Starts calibrating the analog sensor in the background.
+	 *
+	 * Any number of sensors calibrate concurrently in the time it takes
+	 * pros::ADIAnalogIn::calibrate() to calibrate one. Use
+	 * pros::ADIAnalogIn::calibrate_wait() to wait for the result.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * EADDRINUSE - The port is not configured as an analog input
+	 *
+	 * \return 1 if the calibration was started, or PROS_ERR if the operation
+	 * failed, setting errno.
+	 */
+	std::int32_t calibrate_async(void) const;
+
+	/**
+	 * Waits for a calibration started by pros::ADIAnalogIn::calibrate_async() to
+	 * finish.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * EINVAL - No calibration was started on the port
+	 * EADDRINUSE - The port stopped being an analog input during the calibration
+	 * EAGAIN - The timeout expired before the calibration finished
+	 *
+	 * \param timeout
+	 *        The maximum time to wait, in milliseconds
+	 *
+	 * \return The average sensor value computed by the calibration, or PROS_ERR
+	 * if the operation failed, setting errno.
+	 */
+	std::int32_t calibrate_wait(std::uint32_t timeout = TIMEOUT_MAX) const;
+
 	/**
 	 * Gets the 12 bit calibrated value of an analog input port.
 	 *
@@ -79,6 +79,49 @@ bool task_abort_delay(task_t task);
 void task_notify_when_deleting(task_t target_task, task_t task_to_notify, uint32_t value,
                                notify_action_e_t notify_action);
 
+/**
+ * CPU and stack usage of a task, as recorded by the scheduler
+ *
+ * The run time counters are in microseconds and wrap around every 71 minutes,
+ * so CPU usage should be worked out from the difference between two calls to
+ * task_get_runtime_stats(): a task's share of the CPU is the change in its
+ * run_time divided by the change in total_run_time.
+ */
+typedef struct task_runtime_stats_s {
+	task_t task;
+	char name[32];
+	uint32_t state;             // One of the task_state_e_t values
+	uint32_t priority;
+	uint32_t run_time;          // Time spent running since the task was created
+	uint32_t context_switches;  // Number of times the task has been switched in
+	uint32_t stack_free_min;    // Fewest words the stack has had free, ever
+} task_runtime_stats_s_t;
+
+/**
+ * Gets the CPU and stack usage of every task.
+ *
+ * The scheduler is suspended while the tasks are read, which takes a few
+ * microseconds per task plus the time to scan each task's unused stack for its
+ * high water mark. Sampling every second or so costs next to nothing.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - stats is NULL
+ * ENOMEM - There are more than count tasks
+ *
+ * \param[out] stats
+ *             An array to fill in with one entry per task
+ * \param count
+ *        The length of stats. task_get_count() tasks are enough, but tasks
+ *        could be created in the meantime.
+ * \param[out] total_run_time
+ *             The run time counter at the time the tasks were read, or NULL
+ *
+ * \return The number of entries filled in, or PROS_ERR upon failure
+ */
+int32_t task_get_runtime_stats(task_runtime_stats_s_t* const stats, const uint32_t count,
+                               uint32_t* const total_run_time);
+
 /**
  * Creates a recursive mutex which can be locked recursively by the owner.
  *
@@ -418,6 +461,567 @@ int registry_bind_port(uint8_t port, v5_device_e_t device_type);
  */
 int registry_unbind_port(uint8_t port);
 
+/*
+ * Hot-plug events that can be published by the registry
+ *
+ * The values are bit flags so that they can be combined into the event mask
+ * passed to registry_subscribe_task or registry_subscribe_queue.
+ */
+typedef enum registry_event_e {
+	E_REGISTRY_EVENT_PLUGGED = (1 << 0),    // A device was plugged into an empty port
+	E_REGISTRY_EVENT_UNPLUGGED = (1 << 1),  // A device was removed from a port
+	E_REGISTRY_EVENT_MISMATCH = (1 << 2)    // The plugged device differs from the bound device
+} registry_event_e_t;
+
+#define REGISTRY_EVENT_ALL (E_REGISTRY_EVENT_PLUGGED | E_REGISTRY_EVENT_UNPLUGGED | E_REGISTRY_EVENT_MISMATCH)
+
+/*
+ * A single hot-plug event, as posted to queues subscribed with
+ * registry_subscribe_queue
+ */
+typedef struct registry_event_s {
+	registry_event_e_t event;
+	uint8_t port;                // The port number from 1-21
+	v5_device_e_t plugged_type;  // What is now plugged into the port
+	v5_device_e_t bound_type;    // What the port is registered as
+	uint32_t timestamp;          // millis() when the event was detected
+} registry_event_s_t;
+
+/*
+ * Subscribes a task to registry hot-plug events.
+ *
+ * Whenever one of the events in event_mask occurs, the task is notified with
+ * task_notify_ext(task, 1 << (port - 1), E_NOTIFY_ACTION_BITS, NULL), so the
+ * notification value is a bitmap of the ports which have changed since the
+ * task last cleared it. Events are detected by the system daemon, so a
+ * subscribed task will be woken within one background processing cycle. The
+ * subscription is removed when the task is deleted.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - The task is NULL or the event mask is empty.
+ * ENOMEM - The maximum number of subscribers has been reached.
+ *
+ * \param task
+ *        The task to notify
+ * \param event_mask
+ *        A combination of E_REGISTRY_EVENT_* values, or REGISTRY_EVENT_ALL
+ *
+ * \return 1 upon success, PROS_ERR upon failure
+ */
+int32_t registry_subscribe_task(task_t task, uint32_t event_mask);
+
+/*
+ * Subscribes a queue to registry hot-plug events.
+ *
+ * Whenever one of the events in event_mask occurs, a registry_event_s_t is
+ * appended to the queue. The queue must have been created with an item size
+ * of sizeof(registry_event_s_t). The system daemon never waits for space in
+ * the queue, so events are dropped if the queue is full. The queue must be
+ * unsubscribed with registry_unsubscribe before it is deleted.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - The queue is NULL or the event mask is empty.
+ * ENOMEM - The maximum number of subscribers has been reached.
+ *
+ * \param queue
+ *        The queue to post events to
+ * \param event_mask
+ *        A combination of E_REGISTRY_EVENT_* values, or REGISTRY_EVENT_ALL
+ *
+ * \return 1 upon success, PROS_ERR upon failure
+ */
+int32_t registry_subscribe_queue(queue_t queue, uint32_t event_mask);
+
+/*
+ * Removes a task or queue subscription created by registry_subscribe_task or
+ * registry_subscribe_queue.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENOENT - The task or queue is not subscribed.
+ *
+ * \param subscriber
+ *        The task or queue handle that was subscribed
+ *
+ * \return 1 upon success, PROS_ERR upon failure
+ */
+int32_t registry_unsubscribe(void* subscriber);
+
+/******************************************************************************/
+/**                              System Daemon                               **/
+/******************************************************************************/
+
+/**
+ * The stages of the system daemon's background processing, in the order they
+ * run every frame
+ */
+typedef enum daemon_stage_e {
+	E_DAEMON_STAGE_SERIAL_FLUSH = 0,  // Sends buffered serial output; takes no port mutexes
+	E_DAEMON_STAGE_DEVICE_SYNC,       // Refreshes device data; holds all of the port mutexes
+	E_DAEMON_STAGE_REGISTRY,          // Validates port bindings; takes one port mutex at a time
+	E_DAEMON_STAGE_COUNT
+} daemon_stage_e_t;
+
+/**
+ * Timing statistics of a system daemon stage, in microseconds
+ *
+ * The times include time spent waiting for port mutexes held by user tasks.
+ */
+typedef struct daemon_stage_stats_s {
+	uint32_t runs;
+	uint32_t last;
+	uint32_t max;
+	uint64_t total;  // divide by runs for the average
+} daemon_stage_stats_s_t;
+
+/**
+ * Gets the timing statistics of a stage of the system daemon's background
+ * processing.
+ *
+ * This function does not block.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - The stage is not valid or stats is NULL
+ *
+ * \param stage
+ *        The stage to get the statistics of
+ * \param[out] stats
+ *             The location to copy the statistics to
+ *
+ * \return 1 upon success, PROS_ERR upon failure
+ */
+int32_t daemon_get_stage_stats(daemon_stage_e_t stage, daemon_stage_stats_s_t* const stats);
+
+/**
+ * Clears the timing statistics of every stage of the system daemon's
+ * background processing.
+ *
+ * The statistics are cleared at the start of the next frame.
+ *
+ * \return 1 upon success, PROS_ERR upon failure
+ */
+int32_t daemon_reset_stage_stats(void);
+
+/******************************************************************************/
+/**                              Kernel Trace                                **/
+/******************************************************************************/
+
+/**
+ * Kinds of kernel trace events, to be OR'd together and passed to trace_start
+ */
+// Task switches, and priority inheritance by mutex holders
+#define TRACE_SCHEDULING 0x30C
+// Every queue, semaphore and mutex send and receive, and tasks blocking on them
+#define TRACE_QUEUES 0x0F0
+// Interrupt handlers
+#define TRACE_INTERRUPTS 0xC00
+#define TRACE_ALL (TRACE_SCHEDULING | TRACE_QUEUES | TRACE_INTERRUPTS)
+
+/**
+ * Starts recording kernel trace events.
+ *
+ * While the trace runs, the selected events are recorded with microsecond
+ * timestamps and sent over the 'trce' serial stream, which this enables. Run
+ * trace-to-json.py from the PROS kernel repository on a capture of the serial
+ * output to view it in chrome://tracing or Perfetto. Calling this while a trace
+ * is running changes which events are recorded.
+ *
+ * Events which are recorded faster than the serial line can send them are
+ * dropped, and the trace says how many were. TRACE_QUEUES in particular is
+ * easily faster than that, since the kernel takes every port mutex each frame.
+ *
+ * The trace can also be started by sending pRT over the serial port, which
+ * records TRACE_SCHEDULING and TRACE_INTERRUPTS events.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - events is 0 or contains bits which are not TRACE_* flags
+ *
+ * \param events
+ *        The TRACE_* flags of the events to record
+ *
+ * \return 1 upon success, PROS_ERR upon failure
+ */
+int32_t trace_start(uint32_t events);
+
+/**
+ * Stops recording kernel trace events. Events which were already recorded are
+ * still sent.
+ *
+ * The trace can also be stopped by sending pRt over the serial port.
+ *
+ * \return 1 upon success, PROS_ERR upon failure
+ */
+int32_t trace_stop(void);
+
+/******************************************************************************/
+/**                            Sampling Profiler                             **/
+/******************************************************************************/
+
+/**
+ * Starts the sampling profiler.
+ *
+ * Every period ticks (milliseconds), the tick interrupt records the program
+ * counter of the code it interrupted and up to depth - 1 of its callers, along
+ * with the task which was running. Samples are sent over the 'prof' serial
+ * stream, which this enables. Run profile-to-flamegraph.py from the PROS
+ * kernel repository on a capture of the serial output and the program's ELF
+ * files to get a flame graph. Calling this while the profiler runs changes its
+ * rate and depth.
+ *
+ * Unwinding callers takes time in the tick interrupt, so keep depth small at
+ * high rates. Samples which are taken faster than the serial line can send
+ * them are dropped, and the profile says how many were.
+ *
+ * The profiler can also be started by sending pRP followed by a byte for the
+ * period and a byte for the depth over the serial port.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - period is 0, or depth is 0 or greater than 16
+ *
+ * \param period
+ *        The number of ticks between samples
+ * \param depth
+ *        The most program counters to record per sample, including the
+ *        interrupted one
+ *
+ * \return 1 upon success, PROS_ERR upon failure
+ */
+int32_t profiler_start(uint32_t period, uint8_t depth);
+
+/**
+ * Stops the sampling profiler. Samples which were already taken are still
+ * sent.
+ *
+ * The profiler can also be stopped by sending pRp over the serial port.
+ *
+ * \return 1 upon success, PROS_ERR upon failure
+ */
+int32_t profiler_stop(void);
+
+/******************************************************************************/
+/**                               Object Pools                               **/
+/******************************************************************************/
+
+/**
+ * A pool hands out objects of one size from a fixed block of memory. Allocating
+ * and freeing an object takes the same short time however the pool has been
+ * used, never blocks or suspends the scheduler, and can't fragment the kernel
+ * heap.
+ */
+typedef void* pool_t;
+
+// Most objects in one pool
+#define POOL_MAX_COUNT 0xFFFF
+
+/**
+ * The size of each object in a pool of objects of obj_size bytes. Objects are
+ * 8 byte aligned.
+ */
+#define POOL_OBJECT_SIZE(obj_size) (((obj_size) + 7) & ~(size_t)7)
+
+/**
+ * The number of bytes of storage to give pool_create_static for count objects
+ * of obj_size bytes
+ */
+#define POOL_STORAGE_SIZE(obj_size, count) (POOL_OBJECT_SIZE(obj_size) * (count))
+
+/**
+ * The memory for a pool's bookkeeping, for pools created with
+ * pool_create_static. Its fields are not meant to be used directly.
+ */
+typedef struct static_pool_s {
+	uint8_t* storage;
+	uint32_t obj_size;
+	uint32_t count;
+	uint32_t free_head;
+	uint32_t used;
+	uint32_t max_used;
+	uint32_t failed;
+	bool is_static;
+} static_pool_s_t;
+
+/**
+ * Usage statistics of a pool
+ */
+typedef struct pool_stats_s {
+	uint32_t obj_size;  // size of each object, after rounding up to 8 bytes
+	uint32_t count;     // number of objects in the pool
+	uint32_t used;      // number of objects allocated right now
+	uint32_t max_used;  // most objects ever allocated at once
+	uint32_t failed;    // number of allocations which found the pool empty
+} pool_stats_s_t;
+
+/**
+ * Creates a pool of count objects of obj_size bytes. The pool's bookkeeping
+ * and objects are allocated from the kernel heap in one block.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - obj_size is 0, or count is 0 or greater than POOL_MAX_COUNT
+ * ENOMEM - The kernel heap doesn't have room for the pool
+ *
+ * \param obj_size
+ *        The size of each object in bytes
+ * \param count
+ *        The number of objects
+ *
+ * \return A handle to the pool, or NULL upon failure
+ */
+pool_t pool_create(size_t obj_size, size_t count);
+
+/**
+ * Creates a pool of count objects of obj_size bytes in memory provided by the
+ * caller, which must stay valid for as long as the pool is used.
+ *
+ * \b Example
+ * \code
+ * static static_pool_s_t node_pool_buf;
+ * static uint8_t node_pool_storage[POOL_STORAGE_SIZE(sizeof(node_t), 32)] __attribute__((aligned(8)));
+ * pool_t node_pool = pool_create_static(sizeof(node_t), 32, node_pool_storage, &node_pool_buf);
+ * \endcode
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - obj_size is 0, count is 0 or greater than POOL_MAX_COUNT, storage
+ *          isn't 8 byte aligned, or storage or pool_buffer is NULL
+ *
+ * \param obj_size
+ *        The size of each object in bytes
+ * \param count
+ *        The number of objects
+ * \param storage
+ *        POOL_STORAGE_SIZE(obj_size, count) bytes of 8 byte aligned memory for
+ *        the objects
+ * \param pool_buffer
+ *        Memory for the pool's bookkeeping
+ *
+ * \return A handle to the pool, or NULL upon failure
+ */
+pool_t pool_create_static(size_t obj_size, size_t count, void* storage, static_pool_s_t* pool_buffer);
+
+/**
+ * Deletes a pool created with pool_create, giving its memory back to the
+ * kernel heap. Objects allocated from the pool must not be used afterwards.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - The pool is NULL or was created with pool_create_static
+ *
+ * \param pool
+ *        The pool to delete
+ *
+ * \return 1 upon success, PROS_ERR upon failure
+ */
+int32_t pool_delete(pool_t pool);
+
+/**
+ * Allocates an object from a pool. Its contents are undefined.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENOMEM - Every object in the pool is allocated
+ *
+ * \param pool
+ *        The pool to allocate from
+ *
+ * \return The object, or NULL upon failure
+ */
+void* pool_alloc(pool_t pool);
+
+/**
+ * Gives an object back to the pool it was allocated from.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - obj is not an object of the pool
+ *
+ * \param pool
+ *        The pool obj was allocated from
+ * \param obj
+ *        The object to free
+ *
+ * \return 1 upon success, PROS_ERR upon failure
+ */
+int32_t pool_free(pool_t pool, void* obj);
+
+/**
+ * Checks whether a pointer is an object of a pool, for code which allocates
+ * from the kernel heap when a pool runs out.
+ *
+ * \param pool
+ *        The pool
+ * \param obj
+ *        The pointer to check
+ *
+ * \return True if obj is one of the pool's objects, false otherwise
+ */
+bool pool_contains(pool_t pool, const void* obj);
+
+/**
+ * Gets the usage statistics of a pool.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - The pool or stats is NULL
+ *
+ * \param pool
+ *        The pool
+ * \param[out] stats
+ *             The location to copy the statistics to
+ *
+ * \return 1 upon success, PROS_ERR upon failure
+ */
+int32_t pool_get_stats(pool_t pool, pool_stats_s_t* const stats);
+
+/******************************************************************************/
+/**                               Heap Tracing                               **/
+/******************************************************************************/
+
+/**
+ * The heaps memory is allocated from
+ */
+typedef enum heap_e {
+	E_HEAP_KERNEL = 0,  // The kernel heap: kmalloc, and every FreeRTOS object
+	E_HEAP_NEWLIB       // The C library heap: malloc, and new in C++
+} heap_e_t;
+
+/**
+ * Usage and fragmentation of the kernel heap
+ */
+typedef struct heap_stats_s {
+	size_t free_bytes;          // bytes free right now, in all free blocks
+	size_t min_free_bytes;      // fewest bytes there have ever been free
+	size_t largest_free_block;  // largest allocation which can succeed right now
+	size_t free_blocks;         // number of blocks the free bytes are split into
+	uint32_t allocs;            // number of allocations which have succeeded
+	uint32_t frees;             // number of blocks which have been freed
+} heap_stats_s_t;
+
+/**
+ * The allocations made from one place in the program while heap tracing ran
+ */
+typedef struct heap_site_stats_s {
+	void* site;         // address the allocation returns to, or NULL for the
+	                    // sites which didn't fit in the trace
+	heap_e_t heap;      // heap the site allocates from
+	uint32_t allocs;    // number of allocations which succeeded
+	uint32_t failures;  // number of allocations which failed
+	uint32_t blocks;    // number of blocks which haven't been freed yet
+	size_t bytes;       // size of those blocks
+} heap_site_stats_s_t;
+
+/**
+ * The allocations made by one task while heap tracing ran
+ */
+typedef struct heap_task_stats_s {
+	task_t task;                   // the task, which may have been deleted since,
+	                               // or NULL for tasks which didn't fit in the trace
+	char name[TASK_NAME_MAX_LEN];  // name of the task
+	uint32_t allocs;               // number of allocations which succeeded
+	uint32_t blocks;               // number of blocks which haven't been freed yet
+	size_t bytes;                  // size of those blocks
+	size_t max_bytes;              // most bytes the task has had allocated at once
+} heap_task_stats_s_t;
+
+/**
+ * Gets the usage and fragmentation of the kernel heap. This walks the free
+ * blocks with the scheduler suspended, so it takes longer the more fragmented
+ * the heap is.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - stats is NULL
+ *
+ * \param[out] stats
+ *             The location to copy the statistics to
+ *
+ * \return 1 upon success, PROS_ERR upon failure
+ */
+int32_t heap_get_stats(heap_stats_s_t* const stats);
+
+/**
+ * Starts heap tracing, clearing any previous trace.
+ *
+ * While the trace runs, each allocation from the kernel heap and from malloc,
+ * calloc and realloc is recorded against the address it returns to and the
+ * task which made it, until the block is freed. Sizes are those of the blocks
+ * the kernel heap hands out, which include its bookkeeping, and those asked
+ * for from malloc. Blocks allocated before the trace started, or while it was
+ * stopped, are never recorded, and neither are allocations made by the C
+ * library itself. Allocations with new are recorded where operator new calls
+ * malloc, so C++ code shows up by task rather than by site.
+ *
+ * The trace holds up to 768 blocks at once, 96 sites and 32 tasks. Blocks past
+ * that are counted by heap_trace_get_untracked, and sites or tasks past that
+ * are recorded together.
+ *
+ * The trace can also be started by sending pRH over the serial port, and
+ * printed, along with heap_get_stats, by sending pRm. It is also printed if
+ * the kernel heap runs out.
+ *
+ * \return 1 upon success, PROS_ERR upon failure
+ */
+int32_t heap_trace_start(void);
+
+/**
+ * Stops heap tracing. What was recorded can still be read, but doesn't change
+ * when blocks are freed.
+ *
+ * The trace can also be stopped by sending pRh over the serial port.
+ *
+ * \return 1 upon success, PROS_ERR upon failure
+ */
+int32_t heap_trace_stop(void);
+
+/**
+ * Gets the allocation sites of the heap trace with the most bytes still
+ * allocated, in decreasing order of bytes and then allocations.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - sites is NULL
+ *
+ * \param[out] sites
+ *             The array to copy the sites to
+ * \param size
+ *        The length of the array
+ *
+ * \return The number of sites copied, which is less than size if the trace
+ * has fewer, or PROS_ERR upon failure
+ */
+int32_t heap_trace_get_sites(heap_site_stats_s_t* const sites, uint32_t size);
+
+/**
+ * Gets the tasks of the heap trace with the most bytes still allocated, in
+ * decreasing order of bytes and then allocations.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - tasks is NULL
+ *
+ * \param[out] tasks
+ *             The array to copy the tasks to
+ * \param size
+ *        The length of the array
+ *
+ * \return The number of tasks copied, which is less than size if the trace
+ * has fewer, or PROS_ERR upon failure
+ */
+int32_t heap_trace_get_tasks(heap_task_stats_s_t* const tasks, uint32_t size);
+
+/**
+ * Gets the number of allocations the heap trace had no room to hold. They are
+ * counted by their site and task, but their bytes aren't.
+ *
+ * \return The number of untracked allocations since the trace started
+ */
+uint32_t heap_trace_get_untracked(void);
+
 /******************************************************************************/
 /**                               Filesystem                                 **/
 /******************************************************************************/
@@ -554,6 +1158,69 @@ int32_t fdctl(int file, const uint32_t action, void* const extra_arg);
  */
 #define DEVCTL_SET_BAUDRATE 17
 
+/**
+ * Action macro to enable, resize or disable the Generic Serial Device's kernel
+ * receive buffer.
+ *
+ * The extra argument is the size of the buffer in bytes, or 0 to disable it.
+ * See serial_set_rx_buffer for details.
+ */
+#define DEVCTL_SET_RX_BUFFER 19
+
+/**
+ * Action macro to get the number of received bytes which were dropped because
+ * the Generic Serial Device's kernel receive buffer was full.
+ *
+ * The extra argument is not used with this action, provide any value (e.g.
+ * NULL) instead
+ */
+#define DEVCTL_GET_RX_OVERRUNS 20
+
+/**
+ * Action macro to put a Generic Serial Device file into framed mode.
+ *
+ * In framed mode, each write() sends its buffer as one packet, encoded with
+ * Consistent Overhead Byte Stuffing and protected by a CRC-16. Each read()
+ * returns exactly one packet which passed its CRC check; corrupted packets are
+ * dropped and counted (see DEVCTL_GET_FRAME_ERRORS). A payload larger than the
+ * buffer passed to read() is truncated. Writing more than the maximum payload
+ * fails with EMSGSIZE, and writing an empty payload fails with EINVAL.
+ *
+ * The extra argument is the maximum payload size in bytes (at most 4096), or
+ * 0 for the default of 256.
+ */
+#define DEVCTL_ENABLE_FRAMING 21
+
+/**
+ * Action macro to return a Generic Serial Device file to raw mode.
+ *
+ * The extra argument is not used with this action, provide any value (e.g.
+ * NULL) instead
+ */
+#define DEVCTL_DISABLE_FRAMING 22
+
+/**
+ * Action macro to get the number of packets which were dropped by a framed
+ * Generic Serial Device file because they were malformed, too long, or failed
+ * their CRC check.
+ *
+ * The extra argument is not used with this action, provide any value (e.g.
+ * NULL) instead
+ */
+#define DEVCTL_GET_FRAME_ERRORS 23
+
+/**
+ * Action macro to set how long a blocking read() on a Generic Serial Device
+ * file waits for data before giving up.
+ *
+ * A read() which times out returns 0 and sets errno to EAGAIN, as a
+ * non-blocking read with no data would.
+ *
+ * The extra argument is the timeout in milliseconds, or TIMEOUT_MAX (the
+ * default) to wait forever.
+ */
+#define DEVCTL_SET_READ_TIMEOUT 24
+
 #ifdef __cplusplus
 }
 }
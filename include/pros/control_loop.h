@@ -0,0 +1,169 @@
+/**
+ * \file pros/control_loop.h
+ *
+ * Contains prototypes for the kernel control loop scheduler.
+ *
+ * Control loops are periodic callbacks (e.g. PID or feedforward controllers)
+ * run by a dedicated kernel task at a higher priority than any user task. The
+ * task is released by the system daemon as soon as it has refreshed the device
+ * data, so a loop reads sensor values from the current frame and its motor
+ * commands are sent out with the next one.
+ *
+ * The system daemon refreshes devices every 2 milliseconds. The control loop
+ * task also runs on the millisecond between two frames, so loops can be
+ * scheduled at up to 1 kHz, but sensor values only change on every other run
+ * of a 1 millisecond loop.
+ *
+ * This file should not be modified by users, since it gets replaced whenever
+ * a kernel upgrade occurs.
+ *
+ * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef _PROS_CONTROL_LOOP_H_
+#define _PROS_CONTROL_LOOP_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+namespace pros {
+#endif
+
+/**
+ * The maximum number of control loops which can be registered at once
+ */
+#define CONTROL_LOOP_MAX 8
+
+/**
+ * The number of buckets in the control loop timing histograms
+ *
+ * Bucket 0 counts samples of 0 microseconds and bucket i counts samples from
+ * 2^(i-1) to 2^i - 1 microseconds. The last bucket also counts everything
+ * larger.
+ */
+#define CONTROL_LOOP_HISTOGRAM_BUCKETS 20
+
+typedef int32_t control_loop_t;
+
+typedef void (*control_loop_fn_t)(void*);
+
+/**
+ * This structure contains the timing statistics of a control loop
+ *
+ * All times are in microseconds. The jitter of a run is how far the time since
+ * the previous run was from the loop's period, in either direction.
+ */
+typedef struct control_loop_stats_s {
+	// Number of times the callback has run
+	uint32_t runs;
+	// Number of runs which were skipped because the previous ones overran
+	uint32_t overruns;
+	uint32_t period_min;
+	uint32_t period_max;
+	uint32_t jitter_max;
+	// An upper bound on the 99th percentile jitter, from the histogram
+	uint32_t jitter_p99;
+	uint32_t exec_min;
+	uint32_t exec_max;
+	// An upper bound on the 99th percentile execution time, from the histogram
+	uint32_t exec_p99;
+	uint32_t jitter_histogram[CONTROL_LOOP_HISTOGRAM_BUCKETS];
+	uint32_t exec_histogram[CONTROL_LOOP_HISTOGRAM_BUCKETS];
+} control_loop_stats_s_t;
+
+#ifdef __cplusplus
+namespace c {
+#endif
+
+/**
+ * Registers a periodic control loop.
+ *
+ * The callback runs on the control loop task, which has a higher priority than
+ * every user task, so it must not block for long. It may call any PROS device
+ * function, and may remove its own loop.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - The callback is NULL or the period is 0
+ * ENOSPC - CONTROL_LOOP_MAX loops are already registered
+ *
+ * \param function
+ *        The function to call every period
+ * \param parameter
+ *        The parameter to pass to the function
+ * \param period
+ *        The period of the loop in milliseconds
+ *
+ * \return A handle to the loop, or PROS_ERR if the operation failed, setting
+ * errno.
+ */
+control_loop_t control_loop_register(control_loop_fn_t function, void* const parameter, uint32_t period);
+
+/**
+ * Removes a control loop.
+ *
+ * Once this function returns, the loop's callback is not running and won't be
+ * called again, so its parameter may be freed. The handle may be reused by a
+ * later call to control_loop_register().
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - The handle does not refer to a registered loop
+ *
+ * \param loop
+ *        The handle returned by control_loop_register()
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t control_loop_remove(control_loop_t loop);
+
+/**
+ * Gets the timing statistics of a control loop.
+ *
+ * This function does not block the control loop task.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - The handle does not refer to a registered loop, or stats is NULL
+ *
+ * \param loop
+ *        The handle returned by control_loop_register()
+ * \param[out] stats
+ *             The location to copy the statistics to
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t control_loop_get_stats(control_loop_t loop, control_loop_stats_s_t* const stats);
+
+/**
+ * Clears the timing statistics of a control loop.
+ *
+ * The statistics are cleared before the next run of the loop.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - The handle does not refer to a registered loop
+ *
+ * \param loop
+ *        The handle returned by control_loop_register()
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t control_loop_reset_stats(control_loop_t loop);
+
+#ifdef __cplusplus
+}  // namespace c
+}  // namespace pros
+}
+#endif
+
+#endif  // _PROS_CONTROL_LOOP_H_
@@ -0,0 +1,141 @@
+/**
+ * \file pros/frame.h
+ *
+ * Contains prototypes for reading sensors by background processing frame.
+ *
+ * VEXos refreshes the data of every smart device once per background
+ * processing frame, which the system daemon runs every 2 milliseconds. Each
+ * frame is numbered and stamped with the time it completed, so readings from
+ * different devices can be matched up by the frame they came from.
+ *
+ * This file should not be modified by users, since it gets replaced whenever
+ * a kernel upgrade occurs.
+ *
+ * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef _PROS_FRAME_H_
+#define _PROS_FRAME_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+namespace pros {
+#endif
+
+/**
+ * Identifies a background processing frame
+ */
+typedef struct frame_stamp_s {
+	// Number of frames since PROS initialized
+	uint32_t frame;
+	// Time the frame's device data was refreshed, in microseconds since the
+	// brain powered up
+	uint64_t timestamp;
+} frame_stamp_s_t;
+
+/**
+ * The value to read from a device with frame_read()
+ */
+typedef enum frame_source_e {
+	E_FRAME_SOURCE_MOTOR_POSITION = 0,  // in the motor's encoder units
+	E_FRAME_SOURCE_MOTOR_VELOCITY,      // in RPM
+	E_FRAME_SOURCE_MOTOR_CURRENT,       // in mA
+	E_FRAME_SOURCE_MOTOR_VOLTAGE,       // in mV
+	E_FRAME_SOURCE_IMU_ROTATION,        // in degrees, not wrapped
+	E_FRAME_SOURCE_IMU_HEADING,         // in degrees, from 0 to 360
+	E_FRAME_SOURCE_IMU_PITCH,           // in degrees
+	E_FRAME_SOURCE_IMU_ROLL,            // in degrees
+	E_FRAME_SOURCE_IMU_YAW,             // in degrees
+	E_FRAME_SOURCE_IMU_GYRO_X,          // in degrees per second
+	E_FRAME_SOURCE_IMU_GYRO_Y,
+	E_FRAME_SOURCE_IMU_GYRO_Z,
+	E_FRAME_SOURCE_IMU_ACCEL_X,  // in g
+	E_FRAME_SOURCE_IMU_ACCEL_Y,
+	E_FRAME_SOURCE_IMU_ACCEL_Z,
+	E_FRAME_SOURCE_ADI_VALUE,           // the raw value of an ADI port, as configured
+	E_FRAME_SOURCE_VISION_OBJECT_COUNT  // number of objects detected
+} frame_source_e_t;
+
+/**
+ * A single reading for frame_read()
+ *
+ * The source and ports are filled in by the caller; the value and
+ * device_timestamp are filled in by frame_read().
+ */
+typedef struct frame_read_s {
+	frame_source_e_t source;
+	// The V5 port number from 1-21
+	uint8_t port;
+	// The ADI port from 1-8 or 'a'-'h' for E_FRAME_SOURCE_ADI_VALUE
+	uint8_t adi_port;
+	// The reading, or PROS_ERR_F if the device could not be read
+	double value;
+	// The device's own timestamp of its latest data, in milliseconds
+	uint32_t device_timestamp;
+} frame_read_s_t;
+
+#ifdef __cplusplus
+namespace c {
+#endif
+
+/**
+ * Gets the number and time of the latest background processing frame.
+ *
+ * This function does not block.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - stamp is NULL
+ *
+ * \param[out] stamp
+ *             The location to copy the frame stamp to
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t frame_get_stamp(frame_stamp_s_t* const stamp);
+
+/**
+ * Reads several devices from the same background processing frame.
+ *
+ * The port mutexes of every device in the list are held for the whole read,
+ * so the system daemon cannot refresh the device data part way through. A
+ * reading which fails has its value set to PROS_ERR_F and does not stop the
+ * others from being read.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - reads or stamp is NULL, or a reading has an invalid source
+ * ENXIO - A port is not within the range of V5 or ADI ports
+ * ENODEV - A port cannot be configured as the device needed by its source
+ * EAGAIN - An Inertial Sensor is still calibrating
+ *
+ * \param[in,out] reads
+ *                The readings to take
+ * \param count
+ *        The number of readings
+ * \param[out] stamp
+ *             The location to copy the stamp of the frame the readings came
+ *             from to
+ *
+ * \return The number of readings which succeeded, or PROS_ERR if the arguments
+ * were invalid, setting errno. If fewer than count readings succeeded, errno
+ * is set by the last one to fail.
+ */
+int32_t frame_read(frame_read_s_t* const reads, size_t count, frame_stamp_s_t* const stamp);
+
+#ifdef __cplusplus
+}  // namespace c
+}  // namespace pros
+}
+#endif
+
+#endif  // _PROS_FRAME_H_
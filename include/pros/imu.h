@@ -57,6 +57,27 @@ typedef struct __attribute__((__packed__)) euler_s {
 } euler_s_t;
 
 #define IMU_MINIMUM_DATA_RATE 5
+// Number of raw samples kept by the IMU sampler
+#define IMU_SAMPLER_BUFFER_SIZE 64
+
+typedef enum imu_filter_e {
+	E_IMU_FILTER_COMPLEMENTARY = 0,  // gain is the gyro weight, default 0.98
+	E_IMU_FILTER_MADGWICK = 1        // gain is beta, default 0.1
+} imu_filter_e_t;
+
+typedef struct imu_sample_s {
+	imu_gyro_s_t gyro;    // degrees per second
+	imu_accel_s_t accel;  // g
+	uint32_t timestamp;   // ms, device time of the sample
+} imu_sample_s_t;
+
+typedef struct imu_fused_s {
+	quaternion_s_t attitude;
+	euler_s_t euler;       // degrees
+	double gyro_rotation;  // integrated z gyro rate in degrees, unbounded
+	uint32_t samples;      // number of samples fused since the sampler was enabled
+	uint32_t timestamp;    // ms, device time of the latest sample
+} imu_fused_s_t;
 
 /**
  * Calibrate IMU
@@ -272,6 +293,100 @@ imu_accel_s_t imu_get_accel(uint8_t port);
  */
 imu_status_e_t imu_get_status(uint8_t port);
 
+/**
+ * Starts sampling the Inertial Sensor in the kernel.
+ *
+ * While the sampler is enabled, the system daemon reads the raw gyroscope and
+ * accelerometer values each time the sensor produces a new sample (see
+ * imu_set_data_rate), stores them in a buffer of the last
+ * IMU_SAMPLER_BUFFER_SIZE samples, and runs them through an attitude filter.
+ * The results can be read with imu_sampler_get_fused and imu_sampler_read
+ * without taking the port's mutex.
+ *
+ * Enabling the sampler on a port where it is already enabled resets it.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of V5 ports (1-21).
+ * ENODEV - The port cannot be configured as an Inertial Sensor
+ * EINVAL - The filter is not one of imu_filter_e_t or the gain is negative
+ * ENOMEM - The sampler could not be allocated
+ *
+ * \param  port
+ * 				 The V5 Inertial Sensor port number from 1-21
+ * \param  filter
+ *         The attitude filter to run on the samples
+ * \param  gain
+ *         The gain of the filter, or 0 for the filter's default
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t imu_sampler_enable(uint8_t port, imu_filter_e_t filter, double gain);
+
+/**
+ * Stops sampling the Inertial Sensor in the kernel.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of V5 ports (1-21).
+ * ENODEV - The port cannot be configured as an Inertial Sensor
+ *
+ * \param  port
+ * 				 The V5 Inertial Sensor port number from 1-21
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t imu_sampler_disable(uint8_t port);
+
+/**
+ * Gets the latest output of the kernel IMU sampler's attitude filter.
+ *
+ * This function does not block and does not take the port's mutex.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of V5 ports (1-21).
+ * EINVAL - The sampler is not enabled on the port
+ *
+ * \param  port
+ * 				 The V5 Inertial Sensor port number from 1-21
+ * \param[out] fused
+ *             The location to copy the filter output to
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t imu_sampler_get_fused(uint8_t port, imu_fused_s_t* const fused);
+
+/**
+ * Reads raw samples collected by the kernel IMU sampler.
+ *
+ * cursor holds the number of the next sample to read, and is advanced past the
+ * samples read. Start with a cursor of 0. Only the last
+ * IMU_SAMPLER_BUFFER_SIZE - 1 samples can be read, since the writer may be
+ * filling the slot of the one before them, so a reader which falls further
+ * behind skips to the oldest of those.
+ *
+ * This function does not block and does not take the port's mutex.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of V5 ports (1-21).
+ * EINVAL - The sampler is not enabled on the port
+ *
+ * \param  port
+ * 				 The V5 Inertial Sensor port number from 1-21
+ * \param[in,out] cursor
+ *                The number of the next sample to read
+ * \param[out] sample_arr
+ *             The location to copy the samples to
+ * \param  sample_count
+ *         The most samples to copy
+ * \return The number of samples copied, or PROS_ERR if the operation failed,
+ * setting errno.
+ */
+int32_t imu_sampler_read(uint8_t port, uint32_t* const cursor, imu_sample_s_t* const sample_arr,
+                         const uint32_t sample_count);
+
 // NOTE: not used
 // void imu_set_mode(uint8_t port, uint32_t mode);
 // uint32_t imu_get_mode(uint8_t port);
@@ -232,6 +232,69 @@ class Imu {
 	 * false if it is not.
 	 */
 	virtual bool is_calibrating() const;
+	/**
+	 * Starts sampling the Inertial Sensor in the kernel, running the samples
+	 * through an attitude filter.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * ENODEV - The port cannot be configured as an Inertial Sensor
+	 * EINVAL - The filter is not one of imu_filter_e_t or the gain is negative
+	 * ENOMEM - The sampler could not be allocated
+	 *
+	 * \param  filter
+	 *         The attitude filter to run on the samples
+	 * \param  gain
+	 *         The gain of the filter, or 0 for the filter's default
+	 * \return 1 if the operation was successful or PROS_ERR if the operation
+	 * failed, setting errno.
+	 */
+	virtual std::int32_t enable_sampler(pros::c::imu_filter_e_t filter = pros::c::E_IMU_FILTER_COMPLEMENTARY,
+	                                    double gain = 0) const;
+	/**
+	 * Stops sampling the Inertial Sensor in the kernel.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * ENODEV - The port cannot be configured as an Inertial Sensor
+	 *
+	 * \return 1 if the operation was successful or PROS_ERR if the operation
+	 * failed, setting errno.
+	 */
+	virtual std::int32_t disable_sampler() const;
+	/**
+	 * Gets the latest output of the kernel sampler's attitude filter without
+	 * blocking.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * EINVAL - The sampler is not enabled
+	 *
+	 * \param[out] fused
+	 *             The location to copy the filter output to
+	 * \return 1 if the operation was successful or PROS_ERR if the operation
+	 * failed, setting errno.
+	 */
+	virtual std::int32_t get_fused(pros::c::imu_fused_s_t* const fused) const;
+	/**
+	 * Reads raw samples collected by the kernel sampler without blocking.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * EINVAL - The sampler is not enabled
+	 *
+	 * \param[in,out] cursor
+	 *                The number of the next sample to read, advanced past the
+	 *                samples read
+	 * \param[out] sample_arr
+	 *             The location to copy the samples to
+	 * \param  sample_count
+	 *         The most samples to copy
+	 * \return The number of samples copied, or PROS_ERR if the operation failed,
+	 * setting errno.
+	 */
+	virtual std::int32_t read_samples(std::uint32_t* const cursor, pros::c::imu_sample_s_t* const sample_arr,
+	                                  const std::uint32_t sample_count) const;
 };
 }  // namespace pros
 
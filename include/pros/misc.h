@@ -85,6 +85,27 @@ typedef enum {
 	E_CONTROLLER_DIGITAL_A
 } controller_digital_e_t;
 
+/**
+ * Returns the bit corresponding to a controller_digital_e_t button in the
+ * held, pressed and released bitmasks of controller_state_s_t.
+ */
+#define CONTROLLER_BUTTON_BIT(button) (1 << ((button)-E_CONTROLLER_DIGITAL_L1))
+
+/**
+ * A snapshot of every input on a controller, as returned by
+ * controller_get_state.
+ */
+typedef struct controller_state_s {
+	int32_t analog[4];         // Indexed by controller_analog_e_t, [-127, 127]
+	uint16_t held;             // Buttons currently held down
+	uint16_t pressed;          // Buttons which went down since the last call
+	uint16_t released;         // Buttons which went up since the last call
+	int32_t connected;         // 1 if the controller is connected, 0 otherwise
+	int32_t battery_capacity;  // The controller's battery capacity
+	int32_t battery_level;     // The controller's battery level
+	uint32_t timestamp;        // millis() when the snapshot was taken
+} controller_state_s_t;
+
 #ifdef PROS_USE_SIMPLE_NAMES
 #ifdef __cplusplus
 #define CONTROLLER_MASTER pros::E_CONTROLLER_MASTER
@@ -254,16 +275,48 @@ int32_t controller_get_digital(controller_id_e_t id, controller_digital_e_t butt
  */
 int32_t controller_get_digital_new_press(controller_id_e_t id, controller_digital_e_t button);
 
+/**
+ * Gets the state of every input on a controller at once.
+ *
+ * The controller is sampled once per system daemon cycle (every 2 ms), so
+ * this reads all 4 axes, 12 buttons, the connection status and the battery
+ * with a single port lock. Test a button with
+ * state.held & CONTROLLER_BUTTON_BIT(E_CONTROLLER_DIGITAL_A).
+ *
+ * The pressed and released bitmasks accumulate every edge seen since the
+ * previous call to this function, and are cleared when they are returned.
+ * As with controller_get_digital_new_press, only one task should consume edges
+ * from a given controller.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - A value other than E_CONTROLLER_MASTER or E_CONTROLLER_PARTNER is
+ * given, or state is NULL.
+ * EACCES - Another resource is currently trying to access the controller port.
+ *
+ * \param id
+ *        The ID of the controller (e.g. the master or partner controller).
+ *        Must be one of CONTROLLER_MASTER or CONTROLLER_PARTNER
+ * \param[out] state
+ *        The snapshot of the controller's inputs
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t controller_get_state(controller_id_e_t id, controller_state_s_t* state);
+
 /**
  * Sets text to the controller LCD screen.
  *
- * \note Controller text setting is currently in beta, so continuous, fast
- * updates will not work well.
+ * \note Text is written to a buffer in the kernel and sent to the controller
+ * in the background at the fastest rate the controller reliably accepts
+ * (about one update every 50 ms). Only the newest text for each position is
+ * sent, so this function does not wait for the controller.
  *
  * This function uses the following values of errno when an error state is
  * reached:
  * EINVAL - A value other than E_CONTROLLER_MASTER or E_CONTROLLER_PARTNER is
- * given.
+ * given, or the line is out of range.
  * EACCES - Another resource is currently trying to access the controller port.
  *
  * \param id
@@ -286,13 +339,15 @@ int32_t controller_print(controller_id_e_t id, uint8_t line, uint8_t col, const
 /**
  * Sets text to the controller LCD screen.
  *
- * \note Controller text setting is currently in beta, so continuous, fast
- * updates will not work well.
+ * \note Text is written to a buffer in the kernel and sent to the controller
+ * in the background at the fastest rate the controller reliably accepts
+ * (about one update every 50 ms). Only the newest text for each position is
+ * sent, so this function does not wait for the controller.
  *
  * This function uses the following values of errno when an error state is
  * reached:
  * EINVAL - A value other than E_CONTROLLER_MASTER or E_CONTROLLER_PARTNER is
- * given.
+ * given, or the line is out of range.
  * EACCES - Another resource is currently trying to access the controller port.
  *
  * \param id
@@ -313,13 +368,13 @@ int32_t controller_set_text(controller_id_e_t id, uint8_t line, uint8_t col, con
 /**
  * Clears an individual line of the controller screen.
  *
- * \note Controller text setting is currently in beta, so continuous, fast
- * updates will not work well.
+ * \note The line is cleared in the background, like the text written by
+ * controller_set_text.
  *
  * This function uses the following values of errno when an error state is
  * reached:
  * EINVAL - A value other than E_CONTROLLER_MASTER or E_CONTROLLER_PARTNER is
- * given.
+ * given, or the line is out of range.
  * EACCES - Another resource is currently trying to access the controller port.
  *
  * \param id
@@ -336,9 +391,8 @@ int32_t controller_clear_line(controller_id_e_t id, uint8_t line);
 /**
  * Clears all of the lines on the controller screen.
  *
- * \note Controller text setting is currently in beta, so continuous, fast
- * updates will not work well. On vexOS version 1.0.0 this function will block
- * for 110ms.
+ * \note The screen is cleared in the background, so this function does not
+ * wait for the controller.
  *
  * This function uses the following values of errno when an error state is
  * reached:
@@ -358,8 +412,8 @@ int32_t controller_clear(controller_id_e_t id);
 /**
  * Rumble the controller.
  *
- * \note Controller rumble activation is currently in beta, so continuous, fast
- * updates will not work well.
+ * \note The rumble pattern is sent to the controller in the background,
+ * sharing the controller's update rate fairly with the screen text.
  *
  * This function uses the following values of errno when an error state is
  * reached:
@@ -135,6 +135,27 @@ class Controller {
 	 */
 	std::int32_t get_digital_new_press(controller_digital_e_t button);
 
+	/**
+	 * Gets the state of every input on the controller at once.
+	 *
+	 * The pressed and released bitmasks accumulate every edge seen since the
+	 * previous call to this function, and are cleared when they are returned.
+	 * Only one task should consume edges from a given controller.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * EINVAL - state is NULL.
+	 * EACCES - Another resource is currently trying to access the controller
+	 * port.
+	 *
+	 * \param[out] state
+	 * 			  The snapshot of the controller's inputs
+	 *
+	 * \return 1 if the operation was successful or PROS_ERR if the operation
+	 * failed, setting errno.
+	 */
+	std::int32_t get_state(controller_state_s_t* state);
+
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-function"
 	template <typename T>
@@ -149,8 +170,10 @@ class Controller {
 	/**
 	 * Sets text to the controller LCD screen.
 	 *
-	 * \note Controller text setting is currently in beta, so continuous, fast
-	 * updates will not work well.
+	 * \note Text is written to a buffer in the kernel and sent to the controller
+	 * in the background at the fastest rate the controller reliably accepts
+	 * (about one update every 50 ms). Only the newest text for each position is
+	 * sent, so this function does not wait for the controller.
 	 *
 	 * This function uses the following values of errno when an error state is
 	 * reached:
@@ -177,8 +200,10 @@ class Controller {
 	/**
 	 * Sets text to the controller LCD screen.
 	 *
-	 * \note Controller text setting is currently in beta, so continuous, fast
-	 * updates will not work well.
+	 * \note Text is written to a buffer in the kernel and sent to the controller
+	 * in the background at the fastest rate the controller reliably accepts
+	 * (about one update every 50 ms). Only the newest text for each position is
+	 * sent, so this function does not wait for the controller.
 	 *
 	 * This function uses the following values of errno when an error state is
 	 * reached:
@@ -201,8 +226,8 @@ class Controller {
 	/**
 	 * Clears an individual line of the controller screen.
 	 *
-	 * \note Controller text setting is currently in beta, so continuous, fast
-	 * updates will not work well.
+	 * \note The line is cleared in the background, like the text written by
+	 * pros::Controller::set_text.
 	 *
 	 * This function uses the following values of errno when an error state is
 	 * reached:
@@ -220,8 +245,8 @@ class Controller {
 	/**
 	 * Rumble the controller.
 	 *
-	 * \note Controller rumble activation is currently in beta, so continuous, fast
-	 * updates will not work well.
+	 * \note The rumble pattern is sent to the controller in the background,
+	 * sharing the controller's update rate fairly with the screen text.
 	 *
 	 * This function uses the following values of errno when an error state is
 	 * reached:
@@ -241,9 +266,8 @@ class Controller {
 	/**
 	 * Clears all of the lines on the controller screen.
 	 *
-	 * \note Controller text setting is currently in beta, so continuous, fast
-	 * updates will not work well. On vexOS version 1.0.0 this function will
-	 * block for 110ms.
+	 * \note The screen is cleared in the background, so this function does not
+	 * wait for the controller.
 	 *
 	 * This function uses the following values of errno when an error state is
 	 * reached:
@@ -41,6 +41,9 @@ namespace c {
  * stick for simple opcontrol use. The actual behavior of the motor is analogous
  * to use of motor_move_voltage(), or motorSet() from the PROS 2 API.
  *
+ * The command is not sent again if the motor is already being driven at this
+ * voltage; see motor_refresh_command().
+ *
  * This function uses the following values of errno when an error state is
  * reached:
  * ENXIO - The given value is not within the range of V5 ports (1-21).
@@ -119,6 +122,9 @@ int32_t motor_move_relative(uint8_t port, const double position, const int32_t v
  * is held with PID to ensure consistent speed, as opposed to setting the
  * motor's voltage.
  *
+ * The command is not sent again if the motor is already being driven at this
+ * velocity; see motor_refresh_command().
+ *
  * This function uses the following values of errno when an error state is
  * reached:
  * ENXIO - The given value is not within the range of V5 ports (1-21).
@@ -138,6 +144,9 @@ int32_t motor_move_velocity(uint8_t port, const int32_t velocity);
 /**
  * Sets the output voltage for the motor from -12000 to 12000 in millivolts
  *
+ * The command is not sent again if the motor is already being driven at this
+ * voltage; see motor_refresh_command().
+ *
  * This function uses the following values of errno when an error state is
  * reached:
  * ENXIO - The given value is not within the range of V5 ports (1-21).
@@ -206,6 +215,63 @@ double motor_get_target_position(uint8_t port);
  */
 int32_t motor_get_target_velocity(uint8_t port);
 
+#ifdef __cplusplus
+}  // namespace c
+#endif
+
+/**
+ * Counters of the movement commands given to a motor
+ *
+ * motor_move(), motor_move_voltage() and motor_move_velocity() don't send a
+ * command to the motor when it is already being driven with the same mode and
+ * value; those calls are counted as suppressed.
+ */
+typedef struct motor_command_stats_s {
+	uint32_t issued;      // Commands sent to the motor
+	uint32_t suppressed;  // Commands skipped because they matched the last one
+} motor_command_stats_s_t;
+
+#ifdef __cplusplus
+namespace c {
+#endif
+
+/**
+ * Forces the next movement command to be sent to the motor even if it is the
+ * same as the last one.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of V5 ports (1-21).
+ * ENODEV - The port cannot be configured as a motor
+ *
+ * \param port
+ *        The V5 port number from 1-21
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t motor_refresh_command(uint8_t port);
+
+/**
+ * Gets the number of movement commands which were sent to the motor and which
+ * were suppressed because they didn't change anything.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of V5 ports (1-21).
+ * ENODEV - The port cannot be configured as a motor
+ * EINVAL - stats is NULL
+ *
+ * \param port
+ *        The V5 port number from 1-21
+ * \param[out] stats
+ *             The location to copy the counters to
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t motor_get_command_stats(uint8_t port, motor_command_stats_s_t* const stats);
+
 /******************************************************************************/
 /**                        Motor telemetry functions                         **/
 /**                                                                          **/
@@ -226,6 +226,36 @@ class Motor {
 	 */
 	virtual std::int32_t get_target_velocity(void) const;
 
+	/**
+	 * Forces the next movement command to be sent to the motor even if it is
+	 * the same as the last one.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * ENODEV - The port cannot be configured as a motor
+	 *
+	 * \return 1 if the operation was successful or PROS_ERR if the operation
+	 * failed, setting errno.
+	 */
+	virtual std::int32_t refresh_command(void) const;
+
+	/**
+	 * Gets the number of movement commands which were sent to the motor and
+	 * which were suppressed because they didn't change anything.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * ENODEV - The port cannot be configured as a motor
+	 * EINVAL - stats is NULL
+	 *
+	 * \param[out] stats
+	 *             The location to copy the counters to
+	 *
+	 * \return 1 if the operation was successful or PROS_ERR if the operation
+	 * failed, setting errno.
+	 */
+	virtual std::int32_t get_command_stats(motor_command_stats_s_t* const stats) const;
+
 	/****************************************************************************/
 	/**                        Motor telemetry functions                       **/
 	/**                                                                        **/
@@ -0,0 +1,170 @@
+/**
+ * \file pros/odometry.h
+ *
+ * Contains prototypes for the kernel odometry service.
+ *
+ * The odometry service tracks the position of the robot on the field from
+ * tracking wheels (ADI encoders or motor encoders) and, optionally, an Inertial
+ * Sensor. It is updated by the system daemon every background processing cycle
+ * and the pose can be read without blocking.
+ *
+ * This file should not be modified by users, since it gets replaced whenever
+ * a kernel upgrade occurs.
+ *
+ * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef _PROS_ODOMETRY_H_
+#define _PROS_ODOMETRY_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "pros/adi.h"
+
+#ifdef __cplusplus
+extern "C" {
+namespace pros {
+namespace c {
+#endif
+
+typedef enum odom_sensor_e {
+	E_ODOM_SENSOR_NONE = 0,        // the wheel is not used
+	E_ODOM_SENSOR_ADI_ENCODER = 1,  // a quadrature encoder on the ADI
+	E_ODOM_SENSOR_MOTOR = 2         // the integrated encoder of a motor
+} odom_sensor_e_t;
+
+/**
+ * This structure describes one tracking wheel
+ *
+ * The robot frame has x pointing forward and y pointing to the left of the
+ * robot, with its origin at the tracking center.
+ */
+typedef struct odom_wheel_s {
+	odom_sensor_e_t type;
+	// The motor port (1-21) for E_ODOM_SENSOR_MOTOR
+	uint8_t motor_port;
+	// The encoder returned by adi_encoder_init() for E_ODOM_SENSOR_ADI_ENCODER.
+	// The reverse setting given to adi_encoder_init() is not used; set reversed
+	// instead.
+	adi_encoder_t encoder;
+	// Whether the sensor counts down when the wheel moves in its positive
+	// direction (forward for the left and right wheels, left for the back wheel)
+	bool reversed;
+	// Sensor units (ADI encoder ticks, or motor position in the motor's encoder
+	// units) per unit of distance travelled by the wheel
+	double units_per_distance;
+	// Distance from the tracking center to the wheel: to the left for the left
+	// wheel, to the right for the right wheel, and behind for the back wheel
+	double offset;
+} odom_wheel_s_t;
+
+/**
+ * This structure describes the sensors used by the odometry service
+ *
+ * The left and right wheels measure forward motion and the back wheel measures
+ * sideways motion. The back wheel is optional; without one, the robot is
+ * assumed not to slide sideways. The heading is taken from the Inertial Sensor
+ * if imu_port is set, in which case only one of the left and right wheels is
+ * needed. Otherwise it is computed from the difference between the left and
+ * right wheels.
+ */
+typedef struct odom_config_s {
+	odom_wheel_s_t left;
+	odom_wheel_s_t right;
+	odom_wheel_s_t back;
+	// The Inertial Sensor port (1-21), or 0 to not use one
+	uint8_t imu_port;
+} odom_config_s_t;
+
+/**
+ * This structure contains the position of the robot on the field
+ */
+typedef struct odom_pose_s {
+	// Position of the tracking center, in the distance units of the config
+	double x;
+	double y;
+	// Heading of the robot in radians, counterclockwise positive
+	double theta;
+	// The time (in milliseconds since PROS initialized) of the update
+	uint32_t timestamp;
+	// Number of updates integrated since the service was started
+	uint32_t updates;
+} odom_pose_s_t;
+
+/**
+ * Starts the odometry service, or restarts it with a new configuration.
+ *
+ * The pose is reset to (0, 0, 0).
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - The configuration does not have enough wheels to track the robot,
+ *          a wheel's units_per_distance is 0, or the left and right wheel
+ *          offsets sum to 0 without an Inertial Sensor
+ * ENXIO - A port in the configuration is not within the range of V5 ports
+ *
+ * \param[in] config
+ *            The configuration of the tracking wheels and sensors
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t odom_start(const odom_config_s_t* const config);
+
+/**
+ * Stops the odometry service.
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t odom_stop(void);
+
+/**
+ * Gets the latest pose computed by the odometry service.
+ *
+ * This function does not block and does not take any port mutexes.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - The odometry service is not running
+ *
+ * \param[out] pose
+ *             The location to copy the pose to
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t odom_get_pose(odom_pose_s_t* const pose);
+
+/**
+ * Sets the current pose of the robot, e.g. at the start of autonomous.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - The odometry service is not running
+ *
+ * \param x
+ *        The x coordinate of the tracking center
+ * \param y
+ *        The y coordinate of the tracking center
+ * \param theta
+ *        The heading of the robot in radians, counterclockwise positive
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t odom_set_pose(double x, double y, double theta);
+
+#ifdef __cplusplus
+}  // namespace c
+}  // namespace pros
+}
+#endif
+
+#endif  // _PROS_ODOMETRY_H_
@@ -21,6 +21,7 @@
 #ifndef _PROS_RTOS_H_
 #define _PROS_RTOS_H_
 
+#include <reent.h>
 #include <stdbool.h>
 #include <stdint.h>
 
@@ -105,6 +106,21 @@ typedef enum {
 
 typedef void* mutex_t;
 
+/**
+ * The number of bytes the kernel needs to keep track of a task, most of which
+ * is the task's C library state. Tasks created with task_create_buffered keep
+ * this in a task_buffer_s_t which the caller provides.
+ */
+#define TASK_BUFFER_SIZE (sizeof(struct _reent) + TASK_NAME_MAX_LEN + 32 * sizeof(void*))
+
+/**
+ * Memory for the kernel's bookkeeping of a task created with
+ * task_create_buffered. Its contents are not meant to be used directly.
+ */
+typedef struct task_buffer_s {
+	uint8_t data[TASK_BUFFER_SIZE];
+} __attribute__((aligned(8))) task_buffer_s_t;
+
 /**
  * Refers to the current task handle
  */
@@ -125,6 +141,17 @@ namespace c {
  */
 uint32_t millis(void);
 
+/**
+ * Gets the number of microseconds since the V5 Brain turned on.
+ *
+ * Unlike millis(), this is read from the brain's high resolution timer rather
+ * than the RTOS tick, so it advances between ticks and can be used to time
+ * code which runs for less than a millisecond.
+ *
+ * \return The number of microseconds since the V5 Brain turned on
+ */
+uint64_t micros(void);
+
 /**
  * Creates a new task and add it to the list of tasks that are ready to run.
  *
@@ -168,6 +195,65 @@ task_t task_create(task_fn_t function, void* const parameters, uint32_t prio, co
  */
 void task_delete(task_t task);
 
+/**
+ * Creates a new task, like task_create, in memory provided by the caller
+ * instead of the kernel heap. Creating the task never allocates, so it can't
+ * fail for lack of memory and takes the same time every time.
+ *
+ * The stack and task buffer must stay valid until task_release_buffers has
+ * been called for the task, even if it has returned or been deleted.
+ *
+ * \b Example
+ * \code
+ * static uint32_t logger_stack[TASK_STACK_DEPTH_MIN];
+ * static task_buffer_s_t logger_buffer;
+ * task_t logger = task_create_buffered(log_fn, NULL, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_MIN, "Logger",
+ *                                      logger_stack, &logger_buffer);
+ * \endcode
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - stack_depth is 0, or stack_buffer or task_buffer is NULL
+ *
+ * \param function
+ *        Pointer to the task entry function
+ * \param parameters
+ *        Pointer to memory that will be used as a parameter for the task being
+ *        created
+ * \param prio
+ *        The priority at which the task should run.
+ *        TASK_PRIO_DEFAULT plus/minus 1 or 2 is typically used.
+ * \param stack_depth
+ *        The number of words in stack_buffer
+ * \param name
+ *        A descriptive name for the task.  This is mainly used to facilitate
+ *        debugging. The name may be up to 32 characters long.
+ * \param stack_buffer
+ *        Memory for the task's stack, of stack_depth words
+ * \param task_buffer
+ *        Memory for the kernel's bookkeeping of the task
+ *
+ * \return A handle by which the newly created task can be referenced. If an
+ * error occurred, NULL will be returned and errno can be checked for hints as
+ * to why task_create_buffered failed.
+ */
+task_t task_create_buffered(task_fn_t function, void* const parameters, uint32_t prio, const uint16_t stack_depth,
+                            const char* const name, uint32_t* const stack_buffer, task_buffer_s_t* const task_buffer);
+
+/**
+ * Deletes a task created with task_create_buffered, if it is still running,
+ * and finishes deleting it right away rather than leaving that to the idle
+ * task, so that its stack and task buffer can be reused or go out of scope.
+ *
+ * A task cannot release its own buffers. If the idle task is already partway
+ * through deleting the task, this blocks until it is done, so it must not be
+ * called with the scheduler suspended.
+ *
+ * \param task
+ *        The handle of a task created with task_create_buffered
+ */
+void task_release_buffers(task_t task);
+
 /**
  * Delays a task for a given number of milliseconds.
  *
@@ -197,6 +283,39 @@ void delay(const uint32_t milliseconds);
  */
 void task_delay_until(uint32_t* const prev_time, const uint32_t delta);
 
+/**
+ * Delays a task for a given number of microseconds.
+ *
+ * The task sleeps for as many whole milliseconds as it can without waking up
+ * late, and then busy-waits on micros() for the rest of the delay. Delays
+ * shorter than about a millisecond are therefore spent entirely busy-waiting,
+ * and every delay busy-waits for up to a millisecond at the end, during which
+ * tasks of the same or lower priority do not run.
+ *
+ * The delay only ends late if the task is preempted, so the task should run at
+ * a high priority if that matters.
+ *
+ * \param microseconds
+ *        The number of microseconds to wait (1000 microseconds per millisecond)
+ */
+void task_delay_micros(const uint32_t microseconds);
+
+/**
+ * Delays a task until a specified time in microseconds. This is the same as
+ * task_delay_until(), but with the precision of task_delay_micros(), so it can
+ * be used to run code at a period which isn't a whole number of milliseconds.
+ *
+ * The task will be woken up at the time *prev_time + delta, and *prev_time will
+ * be updated to reflect the time at which the task will unblock.
+ *
+ * \param prev_time
+ *        A pointer to the location storing the setpoint time. This should
+ *        typically be initialized to the return value of micros().
+ * \param delta
+ *        The number of microseconds to wait (1000 microseconds per millisecond)
+ */
+void task_delay_until_micros(uint64_t* const prev_time, const uint32_t delta);
+
 /**
  * Gets the priority of the specified task.
  *
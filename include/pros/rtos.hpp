@@ -23,11 +23,14 @@
 
 #include "pros/rtos.h"
 #undef delay
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <functional>
 #include <memory>
+#include <new>
 #include <type_traits>
+#include <utility>
 
 namespace pros {
 class Task {
@@ -306,6 +309,33 @@ class Task {
 	 */
 	static void delay_until(std::uint32_t* const prev_time, const std::uint32_t delta);
 
+	/**
+	 * Delays a task for a given number of microseconds, sleeping for whole
+	 * milliseconds and busy-waiting for the rest of the delay.
+	 *
+	 * See task_delay_micros() for details.
+	 *
+	 * \param microseconds
+	 *        The number of microseconds to wait (1000 microseconds per
+	 *        millisecond)
+	 */
+	static void delay_micros(const std::uint32_t microseconds);
+
+	/**
+	 * Delays a task until a specified time in microseconds. This function can
+	 * be used by periodic tasks with periods shorter than a millisecond.
+	 *
+	 * See task_delay_until_micros() for details.
+	 *
+	 * \param prev_time
+	 *        A pointer to the location storing the setpoint time. This should
+	 *        typically be initialized to the return value from pros::micros().
+	 * \param delta
+	 *        The number of microseconds to wait (1000 microseconds per
+	 *        millisecond)
+	 */
+	static void delay_until_micros(std::uint64_t* const prev_time, const std::uint32_t delta);
+
 	/**
 	 * Gets the number of tasks the kernel is currently managing, including all
 	 * ready, blocked, or suspended tasks. A task that has been deleted, but not
@@ -320,6 +350,93 @@ class Task {
 	task_t task;
 };
 
+/**
+ * A task whose stack, kernel bookkeeping and entry function are all stored in
+ * the StaticTask object itself, so creating it never touches the heap. Declare
+ * it static, or as a member of a longer lived object, since the task stops
+ * when the StaticTask is destroyed.
+ *
+ * The callable is stored in CallableSize bytes inside the object, which is
+ * enough for a lambda capturing a few pointers or references. A larger callable
+ * fails to compile rather than being moved to the heap.
+ *
+ * \b Example
+ * \code
+ * static pros::StaticTask<TASK_STACK_DEPTH_MIN> logger([] { log_loop(); }, "Logger");
+ * \endcode
+ *
+ * \tparam StackWords
+ *         The number of words (i.e. 4 * StackWords bytes) on the task's stack
+ * \tparam CallableSize
+ *         The most bytes the callable can take up
+ */
+template <std::uint16_t StackWords, std::size_t CallableSize = 4 * sizeof(void*)>
+class StaticTask : public Task {
+	public:
+	/**
+	 * Creates a new task and add it to the list of tasks that are ready to run.
+	 *
+	 * \param function
+	 *        Callable object to use as entry function, which is moved or copied
+	 *        into the StaticTask
+	 * \param prio
+	 *        The priority at which the task should run.
+	 *        TASK_PRIO_DEFAULT plus/minus 1 or 2 is typically used.
+	 * \param name
+	 *        A descriptive name for the task.  This is mainly used to facilitate
+	 *        debugging. The name may be up to 32 characters long.
+	 */
+	template <class F>
+	explicit StaticTask(F&& function, std::uint32_t prio = TASK_PRIORITY_DEFAULT, const char* name = "")
+	    : Task(static_cast<task_t>(NULL)) {
+		using Callable = std::decay_t<F>;
+		static_assert(StackWords > 0);
+		static_assert(std::is_invocable_r_v<void, Callable&>);
+		static_assert(sizeof(Callable) <= CallableSize, "the callable doesn't fit in the StaticTask's CallableSize");
+		static_assert(alignof(Callable) <= alignof(std::max_align_t));
+		// The task may run as soon as it is created, so the callable has to be in
+		// place first
+		new (callable) Callable(std::forward<F>(function));
+		destroy_callable = [](void* callable) { static_cast<Callable*>(callable)->~Callable(); };
+		Task::operator=(c::task_create_buffered([](void* callable) { (*static_cast<Callable*>(callable))(); },
+		                                        callable, prio, StackWords, name, stack, &task_buffer));
+	}
+
+	/**
+	 * Creates a new task and add it to the list of tasks that are ready to run.
+	 *
+	 * \param function
+	 *        Callable object to use as entry function, which is moved or copied
+	 *        into the StaticTask
+	 * \param name
+	 *        A descriptive name for the task.  This is mainly used to facilitate
+	 *        debugging. The name may be up to 32 characters long.
+	 */
+	template <class F>
+	StaticTask(F&& function, const char* name) : StaticTask(std::forward<F>(function), TASK_PRIORITY_DEFAULT, name) {}
+
+	/**
+	 * Deletes the task if it is still running, then destroys the callable.
+	 *
+	 * A task must not destroy its own StaticTask.
+	 */
+	~StaticTask() {
+		c::task_release_buffers(*this);
+		destroy_callable(callable);
+	}
+
+	// The task refers to memory inside the object, so it can't be moved
+	StaticTask(const StaticTask&) = delete;
+	StaticTask& operator=(const StaticTask&) = delete;
+
+	private:
+	// The stack comes first so that it overflows away from the task's bookkeeping
+	std::uint32_t stack[StackWords];
+	task_buffer_s_t task_buffer;
+	alignas(std::max_align_t) unsigned char callable[CallableSize];
+	void (*destroy_callable)(void*);
+};
+
 class Mutex {
 	public:
 	Mutex(void);
@@ -367,6 +484,13 @@ class Mutex {
  */
 using pros::c::millis;
 
+/**
+ * Gets the number of microseconds since the V5 Brain turned on.
+ *
+ * \return The number of microseconds since the V5 Brain turned on
+ */
+using pros::c::micros;
+
 /**
  * Delays a task for a given number of milliseconds.
  *
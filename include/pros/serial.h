@@ -238,6 +238,51 @@ int32_t serial_write_byte(uint8_t port, uint8_t buffer);
  */
 int32_t serial_write(uint8_t port, uint8_t* buffer, int32_t length);
 
+// Receive buffer functions
+
+/**
+ * Enables, resizes or disables the kernel receive buffer for the port.
+ *
+ * The VEXos input FIFO is small, so at high baudrates bytes are lost if a task
+ * does not read them quickly enough. When a receive buffer is enabled, the
+ * system daemon moves every received byte into it right after the VEXos
+ * background processing (every 2 ms), and the serial_read* and
+ * serial_get_read_avail functions are served from it instead. Any data already
+ * in the previous buffer is discarded.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - The given value is not within the range of V5 ports (1-21).
+ * EACCES - Another resource is currently trying to access the port.
+ * ENOMEM - The buffer could not be allocated.
+ *
+ * \param port
+ *        The V5 port number from 1-21
+ * \param size
+ *        The size of the buffer in bytes, or 0 to disable it
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t serial_set_rx_buffer(uint8_t port, uint32_t size);
+
+/**
+ * Returns the number of received bytes which were dropped because the port's
+ * receive buffer was full.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - The given value is not within the range of V5 ports (1-21).
+ * EACCES - Another resource is currently trying to access the port.
+ *
+ * \param port
+ *        The V5 port number from 1-21
+ *
+ * \return The number of bytes dropped since the receive buffer was enabled, or
+ * PROS_ERR if the operation failed, setting errno.
+ */
+int32_t serial_get_rx_overruns(uint8_t port);
+
 #ifdef __cplusplus
 }  // namespace c
 }  // namespace pros
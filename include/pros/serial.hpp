@@ -217,6 +217,41 @@ class Serial {
 	 */
 	virtual std::int32_t write(std::uint8_t* buffer, std::int32_t length) const;
 
+	/**
+	 * Enables, resizes or disables the kernel receive buffer for the port.
+	 *
+	 * When a receive buffer is enabled, the system daemon moves every received
+	 * byte into it every 2 ms, and the read functions are served from it
+	 * instead of the small VEXos input FIFO.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * EINVAL - The given value is not within the range of V5 ports (1-21).
+	 * EACCES - Another resource is currently trying to access the port.
+	 * ENOMEM - The buffer could not be allocated.
+	 *
+	 * \param size
+	 *        The size of the buffer in bytes, or 0 to disable it
+	 *
+	 * \return 1 if the operation was successful or PROS_ERR if the operation
+	 * failed, setting errno.
+	 */
+	virtual std::int32_t set_rx_buffer(std::uint32_t size) const;
+
+	/**
+	 * Returns the number of received bytes which were dropped because the port's
+	 * receive buffer was full.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * EINVAL - The given value is not within the range of V5 ports (1-21).
+	 * EACCES - Another resource is currently trying to access the port.
+	 *
+	 * \return The number of bytes dropped, or PROS_ERR if the operation failed,
+	 * setting errno.
+	 */
+	virtual std::int32_t get_rx_overruns() const;
+
 	private:
 	const std::uint8_t _port;
 };
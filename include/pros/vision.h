@@ -24,6 +24,8 @@
 // Parameters given by VEX
 #define VISION_FOV_WIDTH 316
 #define VISION_FOV_HEIGHT 212
+// The most objects the vision tracker follows at once
+#define VISION_TRACKER_MAX_TRACKS 16
 
 #include <stdint.h>
 
@@ -95,6 +97,34 @@ typedef enum vision_zero {
 	E_VISION_ZERO_CENTER = 1    // (0,0) coordinate is the center of the FOV
 } vision_zero_e_t;
 
+/**
+ * This structure contains the state of an object followed by the vision
+ * tracker across frames
+ */
+typedef struct vision_track {
+	// Identifier of the track, which is stable for as long as the object is
+	// tracked and is never reused
+	uint32_t id;
+	// Signature or color code of the tracked object
+	uint16_t signature;
+	// Number of frames in which the object was detected
+	uint16_t hits;
+	// Number of consecutive frames in which the object was not detected
+	uint16_t missed;
+	// Size of the object when it was last detected
+	int16_t width;
+	int16_t height;
+	// Filtered coordinates of the middle of the object
+	float x;
+	float y;
+	// Filtered velocity of the object, in coordinate units per second
+	float vx;
+	float vy;
+	// The time (in milliseconds since PROS initialized) of the frame which the
+	// state above corresponds to
+	uint32_t timestamp;
+} vision_track_s_t;
+
 #ifdef PROS_USE_SIMPLE_NAMES
 #ifdef __cplusplus
 #define VISION_OBJECT_NORMAL pros::E_VISION_OBJECT_NORMAL
@@ -276,6 +306,11 @@ int32_t vision_get_exposure(uint8_t port);
 /**
  * Gets the number of objects currently detected by the Vision Sensor.
  *
+ * All of the object functions are served from a snapshot of the sensor's most
+ * recent frame, which is read once per new frame. Repeated queries within the
+ * same frame, such as reading several signatures, are consistent with each
+ * other and do not re-read the sensor.
+ *
  * This function uses the following values of errno when an error state is
  * reached:
  * ENXIO - The given value is not within the range of V5 ports (1-21).
@@ -548,6 +583,92 @@ int32_t vision_set_zero_point(uint8_t port, vision_zero_e_t zero_point);
  */
 int32_t vision_set_wifi_mode(uint8_t port, const uint8_t enable);
 
+/**
+ * Enables the multi-object tracker on a Vision Sensor.
+ *
+ * While the tracker is enabled, the kernel matches the objects of every new
+ * frame against the objects seen in previous frames, and keeps a filtered
+ * position and velocity for each of them under a stable track ID. Objects are
+ * only matched with tracks of the same signature. Tracks which go undetected
+ * for several frames are dropped.
+ *
+ * Enabling the tracker on a port where it is already enabled resets it.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of V5 ports (1-21).
+ * ENODEV - The port cannot be configured as a vision sensor
+ * EACCES - Another resource is currently trying to access the port.
+ * ENOMEM - The tracker could not be allocated.
+ *
+ * \param port
+ *        The V5 port number from 1-21
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t vision_tracker_enable(uint8_t port);
+
+/**
+ * Disables the multi-object tracker on a Vision Sensor, discarding its tracks.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of V5 ports (1-21).
+ * ENODEV - The port cannot be configured as a vision sensor
+ * EACCES - Another resource is currently trying to access the port.
+ *
+ * \param port
+ *        The V5 port number from 1-21
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t vision_tracker_disable(uint8_t port);
+
+/**
+ * Reads up to track_count of the objects currently followed by the tracker.
+ *
+ * Tracks are ordered by how long they have been followed, oldest first.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of V5 ports (1-21).
+ * ENODEV - The port cannot be configured as a vision sensor
+ * EACCES - Another resource is currently trying to access the port.
+ * EINVAL - The tracker is not enabled on the port.
+ *
+ * \param port
+ *        The V5 port number from 1-21
+ * \param track_count
+ *        The number of tracks to read
+ * \param[out] track_arr
+ *             A pointer to copy the tracks into
+ *
+ * \return The number of tracks copied, or PROS_ERR if the operation failed,
+ * setting errno.
+ */
+int32_t vision_get_tracks(uint8_t port, const uint32_t track_count, vision_track_s_t* const track_arr);
+
+/**
+ * Predicts where a tracked object will be at a given time, assuming it keeps
+ * moving at its current velocity.
+ *
+ * This can be used to estimate the position of an object between frames, or to
+ * compensate for the latency of the sensor.
+ *
+ * \param[in] track
+ *            The track to extrapolate
+ * \param time
+ *        The time (in milliseconds since PROS initialized) to predict the
+ *        position at, e.g. millis()
+ * \param[out] x
+ *             The predicted x coordinate of the middle of the object
+ * \param[out] y
+ *             The predicted y coordinate of the middle of the object
+ */
+void vision_track_predict(const vision_track_s_t* const track, const uint32_t time, float* const x, float* const y);
+
 #ifdef __cplusplus
 }  // namespace c
 }  // namespace pros
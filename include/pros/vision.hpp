@@ -438,6 +438,55 @@ class Vision {
 	 */
 	std::int32_t set_wifi_mode(const std::uint8_t enable) const;
 
+	/**
+	 * Enables the multi-object tracker on the Vision Sensor.
+	 *
+	 * While the tracker is enabled, the kernel matches the objects of every new
+	 * frame against the objects seen in previous frames, and keeps a filtered
+	 * position and velocity for each of them under a stable track ID.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * ENODEV - The port cannot be configured as a vision sensor
+	 * ENOMEM - The tracker could not be allocated.
+	 *
+	 * \return 1 if the operation was successful or PROS_ERR if the operation
+	 * failed, setting errno.
+	 */
+	std::int32_t enable_tracker(void) const;
+
+	/**
+	 * Disables the multi-object tracker on the Vision Sensor, discarding its
+	 * tracks.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * ENODEV - The port cannot be configured as a vision sensor
+	 *
+	 * \return 1 if the operation was successful or PROS_ERR if the operation
+	 * failed, setting errno.
+	 */
+	std::int32_t disable_tracker(void) const;
+
+	/**
+	 * Reads up to track_count of the objects currently followed by the tracker,
+	 * oldest first.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * ENODEV - The port cannot be configured as a vision sensor
+	 * EINVAL - The tracker is not enabled.
+	 *
+	 * \param track_count
+	 *        The number of tracks to read
+	 * \param[out] track_arr
+	 *             A pointer to copy the tracks into
+	 *
+	 * \return The number of tracks copied, or PROS_ERR if the operation failed,
+	 * setting errno.
+	 */
+	std::int32_t get_tracks(const std::uint32_t track_count, vision_track_s_t* const track_arr) const;
+
 	private:
 	std::uint8_t _port;
 };
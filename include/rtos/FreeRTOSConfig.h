@@ -119,11 +119,16 @@
 #define configPERIPHERAL_CLOCK_HZ               ( 33333000UL )
 #define configUSE_PREEMPTION                    1
 #define configUSE_IDLE_HOOK                     1
-#define configUSE_TICK_HOOK                     0
+#define configUSE_TICK_HOOK                     1
 #define configMAX_PRIORITIES                    ( 16 )
 #define configMINIMAL_STACK_SIZE                ( ( unsigned short ) 250 )
 // allocate 1 MB for FreeRTOS heap
 #define configTOTAL_HEAP_SIZE                   ( 0x100000 )
+// kmalloc is heap_4's first fit by default, or the constant time two-level
+// segregated fit allocator in heap_tlsf.c if this is 1
+#ifndef configUSE_TLSF_HEAP
+#define configUSE_TLSF_HEAP                     0
+#endif
 #define configMAX_TASK_NAME_LEN                 ( 32 )
 #define configUSE_TRACE_FACILITY                1
 #define INCLUDE_uxTaskGetStackHighWaterMark     1
@@ -189,6 +194,28 @@ extern uint32_t vexSystemWatchdogGet( void );
 #define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() vInitialiseTimerForRunTimeStats()
 #define portGET_RUN_TIME_COUNTER_VALUE()         vexSystemWatchdogGet()
 
+/* Trace hooks for the kernel trace recorder (system/trace.c).  They record
+nothing until trace_start() is called.  Mutexes and semaphores are queues, so
+taking and giving them is traced as a queue receive and send. */
+#include "system/trace.h"
+#define traceTASK_SWITCHED_IN()                       trace_hook( E_TRACE_TASK_SWITCH_IN, 0, 0, 0 )
+#define traceTASK_SWITCHED_OUT()                      trace_hook( E_TRACE_TASK_SWITCH_OUT, 0, 0, 0 )
+#define traceTASK_CREATE( pxNewTCB )                  do { if( trace_mask ) trace_record_task_name( ( pxNewTCB )->uxTCBNumber, ( pxNewTCB )->pcTaskName ); } while( 0 )
+#define traceQUEUE_SEND( pxQueue )                    trace_hook( E_TRACE_QUEUE_SEND, ( pxQueue )->ucQueueType, ( pxQueue ), 0 )
+#define traceQUEUE_SEND_FROM_ISR( pxQueue )           trace_hook( E_TRACE_QUEUE_SEND, ( pxQueue )->ucQueueType, ( pxQueue ), 0 )
+#define traceQUEUE_RECEIVE( pxQueue )                 trace_hook( E_TRACE_QUEUE_RECEIVE, ( pxQueue )->ucQueueType, ( pxQueue ), 0 )
+#define traceQUEUE_RECEIVE_FROM_ISR( pxQueue )        trace_hook( E_TRACE_QUEUE_RECEIVE, ( pxQueue )->ucQueueType, ( pxQueue ), 0 )
+#define traceBLOCKING_ON_QUEUE_SEND( pxQueue )        trace_hook( E_TRACE_QUEUE_BLOCK_SEND, ( pxQueue )->ucQueueType, ( pxQueue ), 0 )
+#define traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue )     trace_hook( E_TRACE_QUEUE_BLOCK_RECV, ( pxQueue )->ucQueueType, ( pxQueue ), 0 )
+#define traceTASK_PRIORITY_INHERIT( pxTCB, uxPrio )   trace_hook( E_TRACE_PRIORITY_INHERIT, 0, ( pxTCB )->uxTCBNumber, ( uxPrio ) )
+#define traceTASK_PRIORITY_DISINHERIT( pxTCB, uxPrio ) trace_hook( E_TRACE_PRIORITY_RESTORE, 0, ( pxTCB )->uxTCBNumber, ( uxPrio ) )
+
+/* Heap hooks for heap tracing (system/heap_trace.c).  They record nothing until
+heap_trace_start() is called. */
+#include "system/heap_trace.h"
+#define traceMALLOC( pvAddress, uiSize )              heap_trace_kmalloc_hook( ( pvAddress ), ( uiSize ) )
+#define traceFREE( pvAddress, uiSize )                heap_trace_kfree_hook( ( pvAddress ) )
+
 /* The size of the global output buffer that is available for use when there
 are multiple command interpreters running at once (for example, one on a UART
 and one on TCP/IP).  This is done to prevent an output buffer being defined by
@@ -37,7 +37,13 @@ did not result in a portmacro.h header file being included - and it should be
 included here.  In this case the path to the correct portmacro.h header file
 must be set in the compiler's include path. */
 #ifndef portENTER_CRITICAL
-	#include "portmacro.h"
+	#ifdef PROS_HOST
+		/* The host port's portmacro.h is found on the include path (host/include),
+		not next to this file. */
+		#include <portmacro.h>
+	#else
+		#include "portmacro.h"
+	#endif
 #endif
 
 #if portBYTE_ALIGNMENT == 32
@@ -104,6 +110,18 @@ typedef struct HeapRegion
  */
 void vPortDefineHeapRegions( const HeapRegion_t * const pxHeapRegions ) ;
 
+/* Used to pass information about the heap out of vPortGetHeapStats(). */
+typedef struct xHeapStats
+{
+	size_t xAvailableHeapSpaceInBytes;		/* The total heap size currently available - this is the sum of all the free blocks, not the largest block that can be allocated. */
+	size_t xSizeOfLargestFreeBlockInBytes;	/* The maximum size, in bytes, of all the free blocks within the heap at the time vPortGetHeapStats() is called. */
+	size_t xSizeOfSmallestFreeBlockInBytes;	/* The minimum size, in bytes, of all the free blocks within the heap at the time vPortGetHeapStats() is called. */
+	size_t xNumberOfFreeBlocks;				/* The number of free memory blocks within the heap at the time vPortGetHeapStats() is called. */
+	size_t xMinimumEverFreeBytesRemaining;	/* The minimum amount of total free memory (sum of all free blocks) there has been in the heap since the system booted. */
+	size_t xNumberOfSuccessfulAllocations;	/* The number of calls to kmalloc() that have returned a valid memory block. */
+	size_t xNumberOfSuccessfulFrees;		/* The number of calls to kfree() that has successfully freed a block of memory. */
+} HeapStats_t;
+
 
 /*
  * Map to the memory management routines required for the port.
@@ -113,6 +131,8 @@ void kfree( void *pv ) ;
 void vPortInitialiseBlocks( void ) ;
 size_t xPortGetFreeHeapSize( void ) ;
 size_t xPortGetMinimumEverFreeHeapSize( void ) ;
+size_t xPortGetLargestFreeBlockSize( void ) ;
+void vPortGetHeapStats( HeapStats_t *pxHeapStats );
 
 /*
  * Setup the hardware ready for the scheduler to take control.  This generally
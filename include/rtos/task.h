@@ -1353,6 +1353,23 @@ task_t xTaskGetIdleTaskHandle( void ) ;
  */
 uint32_t uxTaskGetSystemState( TaskStatus_t * const pxTaskStatusArray, const uint32_t uxArraySize, uint32_t * const pulTotalRunTime ) ;
 
+/**
+ * task. h
+ * <PRE>void vTaskForEachTask( void ( *pxCallback )( task_t, void * ), void *pvArg );</PRE>
+ *
+ * configUSE_TRACE_FACILITY must be defined as 1 for this function to be
+ * available.
+ *
+ * Calls pxCallback with every task in the system, in the same order as
+ * uxTaskGetSystemState().  The scheduler is suspended while the callbacks run,
+ * so they can safely read the tasks' TCBs but must not block.
+ *
+ * @param pxCallback The function to call with each task's handle and pvArg.
+ *
+ * @param pvArg Passed to pxCallback.
+ */
+void vTaskForEachTask( void ( *pxCallback )( task_t, void * ), void *pvArg ) ;
+
 /**
  * task. h
  * <PRE>void vTaskList( char *pcWriteBuffer );</PRE>
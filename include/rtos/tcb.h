@@ -47,6 +47,7 @@ typedef struct tskTaskControlBlock
 
 	#if( configGENERATE_RUN_TIME_STATS == 1 )
 		uint32_t		ulRunTimeCounter;	/*< Stores the amount of time the task has spent in the Running state. */
+		uint32_t		ulSwitchInCount;	/*< Stores the number of times the task has been switched in. */
 	#endif
 
 	#if ( configUSE_NEWLIB_REENTRANT == 1 )
@@ -35,10 +35,23 @@ struct file_entry {
 	void* arg;
 };
 
-// adds an entry to the file table
+// adds an entry to the file table. If the table is full, arg is given back
+// with vfs_file_arg_free.
 int vfs_add_entry_r(struct _reent* r, struct fs_driver const* const driver, void* arg);
 
 // update an entry to the file table. Returns -1 if there was an error.
 // If driver is NULL, then the driver isn't updated. If arg is (void*)-1, then
 // the arg isn't updated.
 int vfs_update_entry(int file, struct fs_driver const* const driver, void* arg);
+
+// Most bytes a driver argument from vfs_file_arg_alloc can hold
+#define VFS_FILE_ARG_SIZE (4 * sizeof(void*))
+
+// allocates a driver argument for a file being opened from a pool with one for
+// every file which can be open. Returns NULL and sets ENFILE if there are none
+// left. The VFS gives the argument back when the file is closed.
+void* vfs_file_arg_alloc(struct _reent* r);
+
+// gives back a driver argument from vfs_file_arg_alloc. Anything else is
+// ignored, so drivers can pass static arguments too.
+void vfs_file_arg_free(void* arg);
@@ -0,0 +1,84 @@
+/**
+ * \file system/heap_trace.h
+ *
+ * Heap allocation tracing
+ *
+ * While heap tracing runs, every allocation from the kernel heap (kmalloc) and
+ * from newlib (malloc) is recorded against the code which made it and the task
+ * which was running, and every free takes its block back off both. The FreeRTOS
+ * heap reports to the trace through traceMALLOC and traceFREE, and newlib
+ * through the malloc family in system/malloc.c.
+ *
+ * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Which heap a block came from. Same values as heap_e_t in pros/apix.h
+#define HEAP_TRACE_KERNEL 0
+#define HEAP_TRACE_NEWLIB 1
+
+// Set while allocations are being recorded
+extern volatile bool heap_trace_running;
+
+/**
+ * Records an allocation of size bytes by the code at site. ptr is NULL if the
+ * allocation failed.
+ */
+void heap_trace_record_alloc(uint8_t heap, void* ptr, size_t size, void* site);
+
+/**
+ * Takes a block off the trace. Blocks which weren't recorded are ignored.
+ */
+void heap_trace_record_free(void* ptr);
+
+/**
+ * Records a kmalloc, if heap tracing is running. This is what traceMALLOC
+ * expands to inside kmalloc, so the site is kmalloc's caller.
+ */
+#define heap_trace_kmalloc_hook(ptr, size)                                                    \
+	do {                                                                                        \
+		if (heap_trace_running && ((ptr) || (size))) {                                            \
+			heap_trace_record_alloc(HEAP_TRACE_KERNEL, (ptr), (size), __builtin_return_address(0)); \
+		}                                                                                         \
+	} while (0)
+
+#define heap_trace_kfree_hook(ptr)     \
+	do {                                 \
+		if (heap_trace_running) {          \
+			heap_trace_record_free((ptr));   \
+		}                                  \
+	} while (0)
+
+// Enough for the whole heap report
+#define HEAP_REPORT_SIZE 3072
+
+/**
+ * Formats the heap report printed by the pRm command into buffer, truncating
+ * it to fit. Doesn't block, so it can be used where stdio can't.
+ *
+ * \return The length of the report, not counting the terminating null
+ */
+size_t format_heap_stats(char* buffer, size_t size);
+
+/**
+ * Prints the heap report to stdout.
+ */
+void print_heap_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
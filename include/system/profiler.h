@@ -0,0 +1,72 @@
+/**
+ * \file system/profiler.h
+ *
+ * Sampling profiler
+ *
+ * While the profiler runs, the tick interrupt samples the code it interrupted
+ * every few ticks: the program counter and, optionally, a few callers found by
+ * the unwinder. The system daemon sends the samples over the 'prof' serial
+ * stream, and profile-to-flamegraph.py in the root of the repository turns a
+ * capture of that stream into a flame graph using the program's ELF files.
+ *
+ * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PROFILER_STREAM_ID 0x666f7270  // 'prof' little endian
+
+// Most program counters in one sample: the interrupted one and its callers
+#define PROFILER_MAX_DEPTH 16
+
+/**
+ * Types of profiler records. Every record is a profiler_record_s_t followed by
+ * length 32-bit words.
+ */
+typedef enum profiler_record_type_e {
+	E_PROFILER_SAMPLE = 1,  // The interrupted program counter, then its callers
+	E_PROFILER_TASK_NAME,   // The name of a task, NUL padded to length words
+	E_PROFILER_DROPPED      // How many samples didn't fit in the ring
+} profiler_record_type_e_t;
+
+typedef struct profiler_record_s {
+	uint8_t type;    // A profiler_record_type_e_t
+	uint8_t length;  // Number of words which follow
+	uint16_t task;   // TCB number of the task which was sampled or named
+} profiler_record_s_t;
+
+/**
+ * Takes a sample if one is due. Called by the tick hook.
+ */
+void profiler_tick(void);
+
+/**
+ * Sends as many samples as fit in the serial output buffer. Called by the
+ * system daemon right before it flushes serial output.
+ */
+void profiler_flush(void);
+
+/**
+ * Fills pcs with the program counter the tick interrupted and then as many of
+ * its callers as can be unwound, up to max. Only valid in the tick hook while
+ * the profiler runs. Implemented by the port.
+ *
+ * \return The number of program counters stored
+ */
+size_t backtrace_interrupted(uint32_t* pcs, size_t max);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,90 @@
+/**
+ * \file system/trace.h
+ *
+ * Kernel trace recorder
+ *
+ * The FreeRTOS trace hooks in FreeRTOSConfig.h record scheduling, queue and
+ * interrupt events into a RAM ring while tracing is on. The system daemon
+ * drains the ring to the 'trce' serial stream, and trace-to-json.py in the
+ * root of the repository turns a capture of that stream into a Chrome trace.
+ *
+ * This header is included by FreeRTOSConfig.h, so it must not include any
+ * kernel headers itself.
+ *
+ * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TRACE_STREAM_ID 0x65637274  // 'trce' little endian
+
+/**
+ * Types of trace events. Zero marks a ring slot which is still being written.
+ */
+typedef enum trace_event_type_e {
+	E_TRACE_TASK_NAME = 1,      // 8 bytes of a task's name; data is which 8
+	E_TRACE_TASK_SWITCH_IN,     // task is the task which now runs
+	E_TRACE_TASK_SWITCH_OUT,    // task is the task which stops running
+	E_TRACE_QUEUE_SEND,         // arg is the queue, data its queueQUEUE_TYPE
+	E_TRACE_QUEUE_RECEIVE,      // arg is the queue, data its queueQUEUE_TYPE
+	E_TRACE_QUEUE_BLOCK_SEND,   // arg is the queue, data its queueQUEUE_TYPE
+	E_TRACE_QUEUE_BLOCK_RECV,   // arg is the queue, data its queueQUEUE_TYPE
+	E_TRACE_PRIORITY_INHERIT,   // arg is the mutex holder, extra its new priority
+	E_TRACE_PRIORITY_RESTORE,   // arg is the mutex holder, extra its new priority
+	E_TRACE_ISR_ENTER,          // arg is the interrupt ID
+	E_TRACE_ISR_EXIT,           // arg is the interrupt ID
+	E_TRACE_DROPPED             // arg is how many events didn't fit in the ring
+} trace_event_type_e_t;
+
+/**
+ * A trace event, as stored in the ring and sent over serial: 16 bytes, little
+ * endian, with no padding
+ */
+typedef struct trace_event_s {
+	uint32_t time;  // Low 32 bits of micros()
+	uint8_t type;   // A trace_event_type_e_t
+	uint8_t data;
+	uint16_t task;  // TCB number of the running task, or the task named by type
+	uint32_t arg;
+	uint32_t extra;
+} trace_event_s_t;
+
+// Bit (1 << type) is set for every type of event which is being recorded
+extern volatile uint32_t trace_mask;
+
+void trace_record(uint8_t type, uint8_t data, uint32_t arg, uint32_t extra);
+void trace_record_task_name(uint16_t task, const char* name);
+
+/**
+ * Records an event if events of its type are being recorded. This is what the
+ * FreeRTOS trace hooks expand to, so it is only a load, a test and a branch
+ * while tracing is off.
+ */
+#define trace_hook(type, data, arg, extra)                                                   \
+	do {                                                                                       \
+		if (trace_mask & (1u << (type))) {                                                       \
+			trace_record((type), (uint8_t)(data), (uint32_t)(uintptr_t)(arg), (uint32_t)(extra)); \
+		}                                                                                        \
+	} while (0)
+
+/**
+ * Sends as many recorded events as fit in the serial output buffer. Called by
+ * the system daemon right before it flushes serial output.
+ */
+void trace_flush(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -95,6 +95,46 @@ v5_device_e_t registry_get_bound_type(uint8_t port);
  */
 v5_device_e_t registry_get_plugged_type(uint8_t port);
 
+/*
+ * Returns the type of the device that was plugged into the port before the
+ * last call to registry_update_types.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of V5 ports (1-21).
+ *
+ * \param port
+ *        The V5 port number from 0-20
+ *
+ * \return The type of device that was plugged into the port on the previous
+ * background processing cycle
+ */
+v5_device_e_t registry_get_last_plugged_type(uint8_t port);
+
+/*
+ * Publishes a hot-plug event to every task and queue that subscribed to it.
+ *
+ * Intended to be called only by the VDML background processing, which detects
+ * the events by comparing successive registry_types arrays.
+ *
+ * \param port
+ *        The V5 port number from 0-20
+ * \param event
+ *        The event which occurred on the port
+ */
+void registry_publish_event(uint8_t port, registry_event_e_t event);
+
+/*
+ * Removes the registry subscriptions of a task which is being deleted.
+ *
+ * Called by task_delete, so that the system daemon never notifies a deleted
+ * task, or a task which has since been created in its memory.
+ *
+ * \param task
+ *        The task being deleted, or NULL for the calling task
+ */
+void registry_task_delete_hook(task_t task);
+
 /*
  * Checks whether there is a discrepancy between the binding of the port and
  * what is actually plugged in.
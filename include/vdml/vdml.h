@@ -235,6 +235,73 @@ int internal_port_mutex_take(uint8_t port);
  */
 int internal_port_mutex_give(uint8_t port);
 
+/**
+ * Blocks the calling task until the generic serial port has received data, or
+ * until the timeout expires.
+ *
+ * Data is considered received once it is in the port's kernel receive buffer
+ * if one is enabled, or in the VEXos input FIFO otherwise. The system daemon
+ * checks waiting ports right after vexBackgroundProcessing, so readers are
+ * woken within one background processing cycle of the data arriving. Waiters
+ * are also woken if the device is unplugged.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of V5 ports (1-21).
+ * EACCES - Another resource is currently trying to access the port.
+ *
+ * \param port
+ *        The V5 port number from 1-21
+ * \param timeout
+ *        The maximum time to wait, in milliseconds
+ *
+ * \return 1 if data may be available, 0 if the timeout expired, or PROS_ERR
+ * if the operation failed, setting errno.
+ */
+int32_t serial_rx_wait(uint8_t port, uint32_t timeout);
+
+/**
+ * Blocks the calling task until the generic serial port's output FIFO has free
+ * space, or until the timeout expires.
+ *
+ * Like serial_rx_wait, waiting writers are woken by the system daemon within
+ * one background processing cycle of space opening up.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of V5 ports (1-21).
+ * EACCES - Another resource is currently trying to access the port.
+ *
+ * \param port
+ *        The V5 port number from 1-21
+ * \param timeout
+ *        The maximum time to wait, in milliseconds
+ *
+ * \return 1 if space may be available, 0 if the timeout expired, or PROS_ERR
+ * if the operation failed, setting errno.
+ */
+int32_t serial_tx_wait(uint8_t port, uint32_t timeout);
+
+/**
+ * Forgets the last movement command sent to a motor, so that the next one is
+ * sent even if it's the same.
+ *
+ * The port's mutex must be held by the caller.
+ *
+ * \param port
+ *        The V5 port number from 0-20
+ */
+void motor_command_invalidate(uint8_t port);
+
+/**
+ * Forgets the last movement command sent to every motor.
+ *
+ * VEXos stops the motors while the robot is disabled, so the system daemon
+ * calls this whenever the competition state changes. It takes each motor's
+ * port mutex itself.
+ */
+void motor_command_invalidate_all(void);
+
 #define V5_PORT_BATTERY 24
 #define V5_PORT_CONTROLLER_1 25
 #define V5_PORT_CONTROLLER_2 26
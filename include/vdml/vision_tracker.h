@@ -0,0 +1,99 @@
+/**
+ * \file vdml/vision_tracker.h
+ *
+ * This file contains the multi-object tracker used by the vision sensor.
+ *
+ * The tracker only depends on the vision object types, so that it can also be
+ * built and replayed on a host (see tests/vision_tracker_replay.c).
+ *
+ * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "pros/vision.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Largest distance (in coordinate units) between a track's predicted position
+// and an object for them to be matched
+#define VISION_TRACKER_GATE 48.0f
+// Tracks are dropped after this many consecutive frames without a match
+#define VISION_TRACKER_MAX_MISSED 5
+// Standard deviation of the measured object position, in coordinate units
+#define VISION_TRACKER_MEASUREMENT_NOISE 2.0f
+// Standard deviation of the object acceleration, in coordinate units per s^2
+#define VISION_TRACKER_ACCEL_NOISE 800.0f
+// Frames further apart than this (in ms) are treated as this far apart
+#define VISION_TRACKER_MAX_DT 500
+
+/**
+ * Constant-velocity Kalman filter for one axis. The state is [position,
+ * velocity] and p holds the upper triangle of its covariance.
+ */
+typedef struct vision_tracker_axis {
+	float pos;
+	float vel;
+	float p_pos;
+	float p_cross;
+	float p_vel;
+} vision_tracker_axis_s_t;
+
+typedef struct vision_tracker_entry {
+	vision_track_s_t track;
+	vision_tracker_axis_s_t x;
+	vision_tracker_axis_s_t y;
+} vision_tracker_entry_s_t;
+
+typedef struct vision_tracker {
+	uint32_t next_id;
+	uint32_t last_frame;  // device timestamp of the last frame, in ms
+	uint8_t count;
+	vision_tracker_entry_s_t entries[VISION_TRACKER_MAX_TRACKS];
+} vision_tracker_s_t;
+
+/**
+ * Resets a tracker, discarding all of its tracks.
+ *
+ * \param tracker
+ *        The tracker to reset
+ */
+void vision_tracker_init(vision_tracker_s_t* tracker);
+
+/**
+ * Advances a tracker by one frame.
+ *
+ * Every track is predicted forward to the frame, then objects are assigned to
+ * tracks of the same signature greedily by increasing distance, within
+ * VISION_TRACKER_GATE. Matched tracks are corrected with their object,
+ * unmatched objects start new tracks while there is room, and tracks missed for
+ * more than VISION_TRACKER_MAX_MISSED frames are dropped.
+ *
+ * The work done is bounded by VISION_TRACKER_MAX_TRACKS * object_count
+ * distance computations plus the assignment over them.
+ *
+ * \param tracker
+ *        The tracker to update
+ * \param[in] objects
+ *            The objects detected in the frame, with transformed coordinates
+ * \param object_count
+ *        The number of objects
+ * \param frame_time
+ *        The device timestamp of the frame, in ms, used to compute the time
+ *        step
+ * \param now
+ *        The time to stamp the updated tracks with, in ms since PROS
+ *        initialized
+ */
+void vision_tracker_update(vision_tracker_s_t* tracker, const vision_object_s_t* objects, uint32_t object_count,
+                           uint32_t frame_time, uint32_t now);
+
+#ifdef __cplusplus
+}
+#endif
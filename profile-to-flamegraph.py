@@ -0,0 +1,189 @@
+#!/usr/bin/env python3
+"""Turns samples from the PROS sampling profiler into a flame graph.
+
+Start the profiler with profiler_start() or by sending pRP to the brain,
+capture the raw serial output (e.g. cat /dev/ttyACM1 > capture.bin), then run
+
+    python3 profile-to-flamegraph.py capture.bin profile.svg bin/cold.package.elf bin/hot.package.elf
+
+with the ELF files of the program which was profiled: both halves of a hot/cold
+build, or bin/monolith.elf. Each address is looked up in whichever ELF has a
+function containing it. An output file not ending in .svg gets the stacks in
+folded form ("task;caller;callee count" per line) instead, for flamegraph.pl
+or speedscope. Frames of other streams in the capture are ignored.
+
+Symbols are read with arm-none-eabi-nm; pass --nm to use another nm.
+"""
+import argparse
+import bisect
+import collections
+import html
+import struct
+import subprocess
+import sys
+import zlib
+
+PROFILER_STREAM_ID = b'prof'
+RECORD = struct.Struct('<BBH')
+
+SAMPLE = 1
+TASK_NAME = 2
+DROPPED = 3
+
+
+def cobs_decode(frame):
+    """Returns the decoded contents of a COBS frame, or None if it isn't one"""
+    out = bytearray()
+    i = 0
+    while i < len(frame):
+        code = frame[i]
+        if code == 0 or i + code > len(frame):
+            return None
+        out += frame[i + 1:i + code]
+        i += code
+        if code < 0xff and i < len(frame):
+            out.append(0)
+    return bytes(out)
+
+
+def records(body):
+    """Returns (type, task, words) for every record in a frame, or nothing if the frame is malformed"""
+    parsed = []
+    offset = 0
+    while offset + RECORD.size <= len(body):
+        kind, length, task = RECORD.unpack_from(body, offset)
+        offset += RECORD.size
+        if kind not in (SAMPLE, TASK_NAME, DROPPED) or offset + length * 4 > len(body):
+            return []
+        parsed.append((kind, task, body[offset:offset + length * 4]))
+        offset += length * 4
+    return parsed if offset == len(body) else []
+
+
+def profile_records(data):
+    for chunk in data.split(b'\0'):
+        frame = cobs_decode(chunk)
+        if frame is None or frame[:4] != PROFILER_STREAM_ID:
+            # Output which wasn't COBS encoded has no delimiter of its own, so it
+            # ends up in front of the next frame. Look for a frame at the end.
+            frame = next((f for f in map(cobs_decode, (chunk[i:] for i in range(1, len(chunk))))
+                          if f is not None and f[:4] == PROFILER_STREAM_ID and records(f[4:])), None)
+            if frame is None:
+                continue
+        yield from records(frame[4:])
+
+
+class Symbols:
+    def __init__(self, elfs, nm):
+        self.starts = []
+        self.functions = []
+        for elf in elfs:
+            output = subprocess.run([nm, '-C', '-S', '--defined-only', elf], check=True,
+                                    stdout=subprocess.PIPE, universal_newlines=True).stdout
+            for line in output.splitlines():
+                parts = line.split(None, 3)
+                if len(parts) != 4 or parts[2] not in 'tTwW':
+                    continue
+                start, size = int(parts[0], 16), int(parts[1], 16)
+                if size:
+                    self.functions.append((start & ~1, size, parts[3]))
+        self.functions.sort()
+        self.starts = [f[0] for f in self.functions]
+
+    def lookup(self, address):
+        i = bisect.bisect_right(self.starts, address) - 1
+        if i >= 0:
+            start, size, name = self.functions[i]
+            if address < start + size:
+                return name
+        return '0x{:08x}'.format(address)
+
+
+def fold(data, symbols):
+    names = {}
+    stacks = collections.Counter()
+    dropped = 0
+    for kind, task, words in profile_records(data):
+        if kind == TASK_NAME:
+            names[task] = words.split(b'\0')[0].decode(errors='replace')
+        elif kind == DROPPED:
+            dropped += struct.unpack('<I', words)[0]
+        elif kind == SAMPLE:
+            pcs = struct.unpack('<{}I'.format(len(words) // 4), words)
+            # Callers are return addresses, which may be past the end of the call
+            frames = [symbols.lookup(pcs[0])] + [symbols.lookup(pc - 1) for pc in pcs[1:]]
+            task_name = '{} ({})'.format(names[task], task) if task in names else 'task {}'.format(task)
+            stacks[tuple([task_name] + frames[::-1])] += 1
+    return stacks, dropped
+
+
+def svg(stacks, title):
+    """Renders folded stacks as a flame graph"""
+    width, row, font = 1200, 16, 11
+    total = sum(stacks.values())
+    tree = {}
+    for stack, count in stacks.items():
+        node = tree
+        for frame in stack:
+            entry = node.setdefault(frame, [0, {}])
+            entry[0] += count
+            node = entry[1]
+
+    rects = []
+    depth_max = [0]
+
+    def walk(node, x, depth):
+        for frame, (count, children) in sorted(node.items()):
+            w = count * (width - 20) / total
+            if w >= 0.5:
+                rects.append((x, depth, w, frame, count))
+                depth_max[0] = max(depth_max[0], depth)
+                walk(children, x, depth + 1)
+            x += w
+
+    walk(tree, 10, 0)
+    height = (depth_max[0] + 1) * row + 40
+    out = ['<svg xmlns="http://www.w3.org/2000/svg" width="{}" height="{}" font-family="monospace" '
+           'font-size="{}">'.format(width, height, font),
+           '<text x="{}" y="20" text-anchor="middle" font-size="14">{}</text>'.format(width / 2, html.escape(title))]
+    for x, depth, w, frame, count in rects:
+        y = height - (depth + 1) * row - 5
+        hue = 20 + zlib.crc32(frame.encode()) % 40
+        label = '{} ({} samples, {:.1f}%)'.format(frame, count, 100 * count / total)
+        out.append('<g><title>{}</title><rect x="{:.1f}" y="{}" width="{:.1f}" height="{}" fill="hsl({},90%,60%)" '
+                   'stroke="white" stroke-width="0.5"/>'.format(html.escape(label), x, y, w, row - 1, hue))
+        chars = int(w / (font * 0.6))
+        if chars >= 3:
+            text = frame if len(frame) <= chars else frame[:chars - 2] + '..'
+            out.append('<text x="{:.1f}" y="{}">{}</text>'.format(x + 2, y + row - 4, html.escape(text)))
+        out.append('</g>')
+    out.append('</svg>')
+    return '\n'.join(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Turns a PROS profiler capture into a flame graph')
+    parser.add_argument('capture')
+    parser.add_argument('output', help='.svg for a flame graph, anything else for folded stacks')
+    parser.add_argument('elf', nargs='+')
+    parser.add_argument('--nm', default='arm-none-eabi-nm')
+    args = parser.parse_args()
+
+    with open(args.capture, 'rb') as f:
+        data = f.read()
+    stacks, dropped = fold(data, Symbols(args.elf, args.nm))
+    total = sum(stacks.values())
+    print('{} samples, {} dropped'.format(total, dropped), file=sys.stderr)
+    if not total:
+        sys.exit(1)
+
+    with open(args.output, 'w') as f:
+        if args.output.endswith('.svg'):
+            f.write(svg(stacks, '{} samples'.format(total)))
+        else:
+            for stack, count in sorted(stacks.items()):
+                f.write('{} {}\n'.format(';'.join(stack), count))
+
+
+if __name__ == '__main__':
+    main()
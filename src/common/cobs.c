@@ -55,45 +55,78 @@ size_t cobs_encode_measure(const uint8_t* restrict src, const size_t src_len, co
 	return write_idx;
 }
 
+// Appends one byte to an in-progress encoding
+static inline void _cobs_encode_byte(uint8_t* restrict dest, size_t* write_idx, size_t* code_idx, uint8_t* code,
+                                     const uint8_t byte) {
+	if (byte == 0) {
+		dest[*code_idx] = *code;
+		*code = 1;
+		*code_idx = (*write_idx)++;
+	} else {
+		dest[(*write_idx)++] = byte;
+		(*code)++;
+		if (*code == 0xff) {
+			dest[*code_idx] = *code;
+			*code = 1;
+			*code_idx = (*write_idx)++;
+		}
+	}
+}
+
 int cobs_encode(uint8_t* restrict dest, const uint8_t* restrict src, const size_t src_len, const uint32_t prefix) {
-	size_t read_idx = 0;
 	size_t write_idx = 1;
 	size_t code_idx = 0;
 	uint8_t code = 1;
 
+	// code will never reach 0xff in the prefix since its length is 4
 	uint8_t* prefix_bytes = (uint8_t*)&prefix;
-	for (read_idx = 0; read_idx < 4;) {
-		if (prefix_bytes[read_idx] == 0) {
-			dest[code_idx] = code;
-			code = 1;
-			code_idx = write_idx++;
-			read_idx++;
-		} else {
-			dest[write_idx++] = prefix_bytes[read_idx++];
-			code++;
-			// code will never be 0xff since the length of the prefix is 4
-		}
+	for (size_t read_idx = 0; read_idx < 4; read_idx++) {
+		_cobs_encode_byte(dest, &write_idx, &code_idx, &code, prefix_bytes[read_idx]);
 	}
-	read_idx = 0;
+	for (size_t read_idx = 0; read_idx < src_len; read_idx++) {
+		_cobs_encode_byte(dest, &write_idx, &code_idx, &code, src[read_idx]);
+	}
+
+	dest[code_idx] = code;
+
+	return write_idx;
+}
+
+int cobs_encode_raw(uint8_t* restrict dest, const uint8_t* restrict src, const size_t src_len) {
+	size_t write_idx = 1;
+	size_t code_idx = 0;
+	uint8_t code = 1;
+
+	for (size_t read_idx = 0; read_idx < src_len; read_idx++) {
+		_cobs_encode_byte(dest, &write_idx, &code_idx, &code, src[read_idx]);
+	}
+
+	dest[code_idx] = code;
+
+	return write_idx;
+}
+
+int cobs_decode(uint8_t* dest, const uint8_t* src, const size_t src_len) {
+	size_t read_idx = 0;
+	size_t write_idx = 0;
 
 	while (read_idx < src_len) {
-		if (src[read_idx] == 0) {
-			dest[code_idx] = code;
-			code = 1;
-			code_idx = write_idx++;
-			read_idx++;
-		} else {
-			dest[write_idx++] = src[read_idx++];
-			code++;
-			if (code == 0xff) {
-				dest[code_idx] = code;
-				code = 1;
-				code_idx = write_idx++;
+		uint8_t code = src[read_idx++];
+		if (code == 0) {
+			return -1;
+		}
+		for (uint8_t i = 1; i < code; i++) {
+			if (read_idx >= src_len || src[read_idx] == 0) {
+				return -1;
 			}
+			dest[write_idx++] = src[read_idx++];
+		}
+		// Every block except a full one ends in an implied zero, unless it is the
+		// last block
+		if (code != 0xff && read_idx < src_len) {
+			dest[write_idx++] = 0;
 		}
 	}
 
-	dest[code_idx] = code;
-
 	return write_idx;
 }
@@ -6,6 +6,9 @@
  * This file defines a linked list implementation that operates on the FreeRTOS
  * heap, and is able to generically store function pointers and data
  *
+ * Nodes and lists come from a pool, and from the kernel heap once the pool is
+ * used up.
+ *
  * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
  *
  * This Source Code Form is subject to the terms of the Mozilla Public
@@ -18,8 +21,32 @@
 #include "common/linkedlist.h"
 #include "kapi.h"
 
+#define LL_POOL_COUNT 64
+#define LL_OBJECT_SIZE (sizeof(ll_node_s_t) > sizeof(linked_list_s_t) ? sizeof(ll_node_s_t) : sizeof(linked_list_s_t))
+
+static static_pool_s_t ll_pool_buf;
+static uint8_t ll_pool_storage[POOL_STORAGE_SIZE(LL_OBJECT_SIZE, LL_POOL_COUNT)] __attribute__((aligned(8)));
+static pool_t ll_pool;
+
+void linked_list_initialize(void) {
+	ll_pool = pool_create_static(LL_OBJECT_SIZE, LL_POOL_COUNT, ll_pool_storage, &ll_pool_buf);
+}
+
+static void* _ll_alloc(size_t size) {
+	void* obj = pool_alloc(ll_pool);
+	return obj ? obj : kmalloc(size);
+}
+
+static void _ll_free(void* obj) {
+	if (pool_contains(ll_pool, obj)) {
+		pool_free(ll_pool, obj);
+	} else {
+		kfree(obj);
+	}
+}
+
 ll_node_s_t* linked_list_init_func_node(generic_fn_t func) {
-	ll_node_s_t* node = (ll_node_s_t*)kmalloc(sizeof *node);
+	ll_node_s_t* node = (ll_node_s_t*)_ll_alloc(sizeof *node);
 	node->payload.func = func;
 	node->next = NULL;
 
@@ -27,7 +54,7 @@ ll_node_s_t* linked_list_init_func_node(generic_fn_t func) {
 }
 
 ll_node_s_t* linked_list_init_data_node(void* data) {
-	ll_node_s_t* node = (ll_node_s_t*)kmalloc(sizeof *node);
+	ll_node_s_t* node = (ll_node_s_t*)_ll_alloc(sizeof *node);
 	node->payload.data = data;
 	node->next = NULL;
 
@@ -35,7 +62,7 @@ ll_node_s_t* linked_list_init_data_node(void* data) {
 }
 
 linked_list_s_t* linked_list_init() {
-	linked_list_s_t* list = (linked_list_s_t*)kmalloc(sizeof *list);
+	linked_list_s_t* list = (linked_list_s_t*)_ll_alloc(sizeof *list);
 	list->head = NULL;
 
 	return list;
@@ -88,7 +115,7 @@ void linked_list_remove_func(linked_list_s_t* list, generic_fn_t func) {
 				list->head = it->next;
 			else
 				p->next = it->next;
-			kfree(it);
+			_ll_free(it);
 			break;
 		}
 
@@ -126,7 +153,7 @@ void linked_list_remove_data(linked_list_s_t* list, void* data) {
 				list->head = it->next;
 			else
 				p->next = it->next;
-			kfree(it);
+			_ll_free(it);
 			break;
 		}
 
@@ -146,12 +173,12 @@ void linked_list_foreach(linked_list_s_t* list, linked_list_foreach_fn_t cb, voi
 }
 
 void linked_list_free(linked_list_s_t* list) {
-	if (list == NULL || list->head == NULL) return;
+	if (list == NULL) return;
 
 	while (list->head != NULL) {
 		ll_node_s_t* node = list->head;
 		list->head = node->next;
-		kfree(node);
+		_ll_free(node);
 	}
-	kfree(list);
+	_ll_free(list);
 }
@@ -0,0 +1,150 @@
+/**
+ * \file common/pool.c
+ *
+ * Fixed-size object pools
+ *
+ * The free objects of a pool form a singly linked list threaded through the
+ * objects themselves: the first word of a free object holds the index (plus
+ * one) of the next free object. The head of the list is a single word which
+ * holds the index (plus one, so that 0 means the list is empty) of the first
+ * free object in its low 16 bits and a tag in its high 16 bits, and is swapped
+ * with compare and exchange. The tag changes with every push and pop, so a
+ * task which read the head and was preempted while the object was allocated
+ * and freed again fails its exchange instead of corrupting the list.
+ *
+ * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <errno.h>
+
+#include "kapi.h"
+#include "system/optimizers.h"
+
+#define INDEX_MASK 0xFFFFu
+#define TAG_ONE 0x10000u
+
+// The bookkeeping of pools from pool_create is followed by the objects
+#define POOL_HEADER_SIZE POOL_OBJECT_SIZE(sizeof(static_pool_s_t))
+
+static inline uint32_t* _object(static_pool_s_t* pool, uint32_t index) {
+	return (uint32_t*)(pool->storage + (size_t)index * pool->obj_size);
+}
+
+static bool _valid_args(size_t obj_size, size_t count) {
+	// The total size of a pool, with its bookkeeping, must fit in a size_t
+	return obj_size && obj_size <= UINT32_MAX - 7 && count && count <= POOL_MAX_COUNT &&
+	       POOL_OBJECT_SIZE(obj_size) <= (SIZE_MAX - POOL_HEADER_SIZE) / count;
+}
+
+static pool_t _pool_init(static_pool_s_t* pool, size_t obj_size, size_t count, uint8_t* storage, bool is_static) {
+	pool->storage = storage;
+	pool->obj_size = POOL_OBJECT_SIZE(obj_size);
+	pool->count = count;
+	for (uint32_t i = 0; i < count; i++) {
+		*_object(pool, i) = i + 2 <= count ? i + 2 : 0;
+	}
+	pool->free_head = 1;
+	pool->used = 0;
+	pool->max_used = 0;
+	pool->failed = 0;
+	pool->is_static = is_static;
+	return pool;
+}
+
+pool_t pool_create(size_t obj_size, size_t count) {
+	if (!_valid_args(obj_size, count)) {
+		errno = EINVAL;
+		return NULL;
+	}
+	static_pool_s_t* pool = kmalloc(POOL_HEADER_SIZE + POOL_STORAGE_SIZE(obj_size, count));
+	if (!pool) {
+		errno = ENOMEM;
+		return NULL;
+	}
+	return _pool_init(pool, obj_size, count, (uint8_t*)pool + POOL_HEADER_SIZE, false);
+}
+
+pool_t pool_create_static(size_t obj_size, size_t count, void* storage, static_pool_s_t* pool_buffer) {
+	if (!_valid_args(obj_size, count) || !storage || ((uintptr_t)storage & 7) || !pool_buffer) {
+		errno = EINVAL;
+		return NULL;
+	}
+	return _pool_init(pool_buffer, obj_size, count, storage, true);
+}
+
+int32_t pool_delete(pool_t pool) {
+	static_pool_s_t* p = (static_pool_s_t*)pool;
+	if (!p || p->is_static) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	kfree(p);
+	return 1;
+}
+
+void* pool_alloc(pool_t pool) {
+	static_pool_s_t* p = (static_pool_s_t*)pool;
+	uint32_t head = __atomic_load_n(&p->free_head, __ATOMIC_ACQUIRE);
+	uint32_t index, next;
+	do {
+		index = head & INDEX_MASK;
+		if (unlikely(!index)) {
+			__atomic_fetch_add(&p->failed, 1, __ATOMIC_RELAXED);
+			errno = ENOMEM;
+			return NULL;
+		}
+		// If another task takes this object first, this reads whatever it wrote
+		// there, but then the head's tag has changed and the exchange fails
+		next = __atomic_load_n(_object(p, index - 1), __ATOMIC_RELAXED) & INDEX_MASK;
+	} while (!__atomic_compare_exchange_n(&p->free_head, &head, ((head + TAG_ONE) & ~INDEX_MASK) | next, true,
+	                                      __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE));
+
+	uint32_t used = __atomic_add_fetch(&p->used, 1, __ATOMIC_RELAXED);
+	uint32_t max_used = __atomic_load_n(&p->max_used, __ATOMIC_RELAXED);
+	while (used > max_used &&
+	       !__atomic_compare_exchange_n(&p->max_used, &max_used, used, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+		;
+	return _object(p, index - 1);
+}
+
+bool pool_contains(pool_t pool, const void* obj) {
+	static_pool_s_t* p = (static_pool_s_t*)pool;
+	if (!p || (const uint8_t*)obj < p->storage) return false;
+	size_t offset = (const uint8_t*)obj - p->storage;
+	return offset < (size_t)p->obj_size * p->count && offset % p->obj_size == 0;
+}
+
+int32_t pool_free(pool_t pool, void* obj) {
+	static_pool_s_t* p = (static_pool_s_t*)pool;
+	if (!pool_contains(pool, obj)) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	uint32_t index = ((uint8_t*)obj - p->storage) / p->obj_size + 1;
+	uint32_t head = __atomic_load_n(&p->free_head, __ATOMIC_RELAXED);
+	do {
+		__atomic_store_n((uint32_t*)obj, head & INDEX_MASK, __ATOMIC_RELAXED);
+	} while (!__atomic_compare_exchange_n(&p->free_head, &head, ((head + TAG_ONE) & ~INDEX_MASK) | index, true,
+	                                      __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+	__atomic_fetch_sub(&p->used, 1, __ATOMIC_RELAXED);
+	return 1;
+}
+
+int32_t pool_get_stats(pool_t pool, pool_stats_s_t* const stats) {
+	static_pool_s_t* p = (static_pool_s_t*)pool;
+	if (!p || !stats) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	stats->obj_size = p->obj_size;
+	stats->count = p->count;
+	stats->used = __atomic_load_n(&p->used, __ATOMIC_RELAXED);
+	stats->max_used = __atomic_load_n(&p->max_used, __ATOMIC_RELAXED);
+	stats->failed = __atomic_load_n(&p->failed, __ATOMIC_RELAXED);
+	return 1;
+}
@@ -0,0 +1,41 @@
+/**
+ * \file common/seqlock.c
+ *
+ * Sequence locks
+ *
+ * A sequence lock lets one writer publish a small structure to any number of
+ * readers without blocking either side. The writer bumps a sequence number to
+ * an odd value before it updates the data and back to an even value after.
+ * Readers copy the data and retry if the sequence number was odd or changed
+ * during the copy. This suits kernel services which publish state from the
+ * system daemon every cycle, since readers never take the port mutexes and can
+ * never delay the daemon.
+ *
+ * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <string.h>
+
+#include "common/seqlock.h"
+#include "kapi.h"
+
+// After this many torn reads, the writer has most likely been preempted by the
+// reader, so give it a chance to finish
+#define SEQLOCK_SPIN_LIMIT 8
+
+void seqlock_read(const seqlock_s_t* lock, void* dest, const void* src, size_t size) {
+	uint32_t attempts = 0;
+	uint32_t sequence;
+	do {
+		if (++attempts > SEQLOCK_SPIN_LIMIT) {
+			task_delay(1);
+		}
+		sequence = seqlock_read_begin(lock);
+		memcpy(dest, src, size);
+	} while (seqlock_read_retry(lock, sequence));
+}
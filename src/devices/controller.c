@@ -11,6 +11,7 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 
+#include <stdarg.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -19,14 +20,42 @@
 #include "vdml/vdml.h"
 
 #define CONTROLLER_MAX_COLS 19
+#define CONTROLLER_MAX_LINES 3
+// vexControllerTextSet treats the line after the screen as a rumble pattern
+#define CONTROLLER_RUMBLE_LINE 3
+#define CONTROLLER_RUMBLE_MAX_LEN 8
+// The controller silently drops text updates sent faster than this (in ms)
+#define CONTROLLER_TEXT_PERIOD 50
 
 // From enum in misc.h
 #define NUM_BUTTONS 12
 
 typedef struct controller_data {
 	bool button_pressed[NUM_BUTTONS];
+	controller_state_s_t state;
 } controller_data_s_t;
 
+/**
+ * Shadow of a controller's screen. Writers update it without talking to the
+ * controller; the system daemon sends only the changed spans at the rate the
+ * controller can accept.
+ */
+typedef struct controller_screen {
+	char text[CONTROLLER_MAX_LINES][CONTROLLER_MAX_COLS];
+	uint8_t dirty_start[CONTROLLER_MAX_LINES];  // First column not yet sent
+	uint8_t dirty_end[CONTROLLER_MAX_LINES];    // One past the last such column
+	char rumble[CONTROLLER_RUMBLE_MAX_LEN + 1];
+	bool rumble_pending;
+	bool clear_pending;
+	bool was_connected;
+	uint8_t next_slot;  // Round-robin position over the lines and the rumble
+	uint32_t last_send;
+} controller_screen_s_t;
+
+static controller_screen_s_t controller_screens[2];
+
+static void _controller_screen_flush(controller_id_e_t id, bool connected);
+
 bool get_button_pressed(int port, int button) {
 	return ((controller_data_s_t*)registry_get_device_internal(port)->pad)->button_pressed[button];
 }
@@ -182,7 +211,44 @@ int32_t controller_get_digital_new_press(controller_id_e_t id, controller_digita
 	}
 }
 
-int32_t controller_set_text(controller_id_e_t id, uint8_t line, uint8_t col, const char* str) {
+/**
+ * Samples both controllers into their snapshot in the device pad, and sends
+ * any pending screen or rumble update.
+ *
+ * Called by the system daemon every cycle while it holds all of the port
+ * mutexes, so no locking is done here. Edges are accumulated until they are
+ * consumed by controller_get_state.
+ */
+void controller_background_processing() {
+	for (int id = E_CONTROLLER_MASTER; id <= E_CONTROLLER_PARTNER; id++) {
+		uint8_t port = id == E_CONTROLLER_MASTER ? V5_PORT_CONTROLLER_1 : V5_PORT_CONTROLLER_2;
+		controller_state_s_t* state = &((controller_data_s_t*)registry_get_device_internal(port)->pad)->state;
+		uint16_t held = 0;
+
+		state->connected = vexControllerConnectionStatusGet(id);
+		if (state->connected) {
+			for (int i = 0; i < 4; i++) {
+				state->analog[i] = vexControllerGet(id, i);
+			}
+			for (int i = 0; i < NUM_BUTTONS; i++) {
+				if (vexControllerGet(id, E_CONTROLLER_DIGITAL_L1 + i)) held |= (1 << i);
+			}
+			state->battery_capacity = vexControllerGet(id, BatteryCapacity);
+			state->battery_level = vexControllerGet(id, BatteryLevel);
+		} else {
+			memset(state->analog, 0, sizeof(state->analog));
+		}
+
+		state->pressed |= held & ~state->held;
+		state->released |= state->held & ~held;
+		state->held = held;
+		state->timestamp = millis();
+
+		_controller_screen_flush(id, state->connected);
+	}
+}
+
+int32_t controller_get_state(controller_id_e_t id, controller_state_s_t* state) {
 	uint8_t port;
 	switch (id) {
 		case E_CONTROLLER_MASTER:
@@ -195,30 +261,105 @@ int32_t controller_set_text(controller_id_e_t id, uint8_t line, uint8_t col, con
 			errno = EINVAL;
 			return PROS_ERR;
 	}
+	if (state == NULL) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
 	if (!internal_port_mutex_take(port)) {
 		errno = EACCES;
 		return PROS_ERR;
 	}
-	line++;
-	if (col >= CONTROLLER_MAX_COLS)
-		col = CONTROLLER_MAX_COLS;
-	else
-		col++;
+	controller_state_s_t* snapshot = &((controller_data_s_t*)registry_get_device_internal(port)->pad)->state;
+	*state = *snapshot;
+	snapshot->pressed = 0;
+	snapshot->released = 0;
+	internal_port_mutex_give(port);
+	return 1;
+}
 
-	char* buf = strndup(str, CONTROLLER_MAX_COLS + 1);
+/**
+ * Copies str into the shadow framebuffer, extending the line's dirty span over
+ * every column whose contents changed. Must be called with the controller's
+ * port mutex held.
+ */
+static void _controller_screen_write(controller_screen_s_t* screen, uint8_t line, uint8_t col, const char* str) {
+	if (line == CONTROLLER_RUMBLE_LINE) {
+		strncpy(screen->rumble, str, CONTROLLER_RUMBLE_MAX_LEN);
+		screen->rumble[CONTROLLER_RUMBLE_MAX_LEN] = '\0';
+		screen->rumble_pending = true;
+		return;
+	}
+	if (col >= CONTROLLER_MAX_COLS) col = CONTROLLER_MAX_COLS - 1;
+	for (; *str && col < CONTROLLER_MAX_COLS; str++, col++) {
+		if (screen->text[line][col] == *str) continue;
+		screen->text[line][col] = *str;
+		if (screen->dirty_start[line] == screen->dirty_end[line]) {
+			screen->dirty_start[line] = col;
+			screen->dirty_end[line] = col + 1;
+		} else {
+			if (col < screen->dirty_start[line]) screen->dirty_start[line] = col;
+			if (col >= screen->dirty_end[line]) screen->dirty_end[line] = col + 1;
+		}
+	}
+}
 
-	uint32_t rtn_val = vexControllerTextSet(id, line, col, buf);
-	free(buf);
-	internal_port_mutex_give(port);
+/**
+ * Sends at most one pending update (a dirty span of one line, a screen clear,
+ * or a rumble pattern) to the controller. Lines and the rumble take turns so
+ * that neither can starve the other. Called by the system daemon with the
+ * controller's port mutex held.
+ */
+static void _controller_screen_flush(controller_id_e_t id, bool connected) {
+	controller_screen_s_t* screen = &controller_screens[id];
+	if (!connected) {
+		screen->was_connected = false;
+		return;
+	}
+	if (!screen->was_connected) {
+		// The controller's screen may not match the shadow after (re)connecting
+		for (int i = 0; i < CONTROLLER_MAX_LINES; i++) {
+			screen->dirty_start[i] = 0;
+			screen->dirty_end[i] = CONTROLLER_MAX_COLS;
+		}
+		screen->was_connected = true;
+	}
+	if (millis() - screen->last_send < CONTROLLER_TEXT_PERIOD) return;
 
-	if (!rtn_val) {
-		errno = EAGAIN;
-		return PROS_ERR;
+	for (int i = 0; i <= CONTROLLER_MAX_LINES; i++) {
+		uint8_t slot = (screen->next_slot + i) % (CONTROLLER_MAX_LINES + 1);
+		if (slot == CONTROLLER_RUMBLE_LINE) {
+			if (!screen->rumble_pending) continue;
+			if (vexControllerTextSet(id, CONTROLLER_RUMBLE_LINE + 1, 1, screen->rumble)) {
+				screen->rumble_pending = false;
+			}
+		} else if (screen->clear_pending) {
+			// A clear must reach the controller before any text written after it
+			if (vexControllerTextSet(id, 0, 1, "")) {
+				screen->clear_pending = false;
+			}
+		} else {
+			uint8_t start = screen->dirty_start[slot];
+			uint8_t end = screen->dirty_end[slot];
+			if (start == end) continue;
+			char buf[CONTROLLER_MAX_COLS + 1];
+			for (uint8_t col = start; col < end; col++) {
+				// Columns which were never written are sent as blanks
+				buf[col - start] = screen->text[slot][col] ? screen->text[slot][col] : ' ';
+			}
+			buf[end - start] = '\0';
+			if (vexControllerTextSet(id, slot + 1, start + 1, buf)) {
+				screen->dirty_start[slot] = screen->dirty_end[slot] = 0;
+			}
+		}
+		// A failed send leaves the update pending, so the newest contents are
+		// retried on a later turn
+		screen->last_send = millis();
+		screen->next_slot = (slot + 1) % (CONTROLLER_MAX_LINES + 1);
+		return;
 	}
-	return 1;
 }
 
-int32_t controller_print(controller_id_e_t id, uint8_t line, uint8_t col, const char* fmt, ...) {
+int32_t controller_set_text(controller_id_e_t id, uint8_t line, uint8_t col, const char* str) {
 	uint8_t port;
 	switch (id) {
 		case E_CONTROLLER_MASTER:
@@ -231,55 +372,76 @@ int32_t controller_print(controller_id_e_t id, uint8_t line, uint8_t col, const
 			errno = EINVAL;
 			return PROS_ERR;
 	}
+	if (line > CONTROLLER_RUMBLE_LINE || str == NULL) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
 	if (!internal_port_mutex_take(port)) {
 		errno = EACCES;
 		return PROS_ERR;
 	}
-	line++;
-	if (col >= CONTROLLER_MAX_COLS)
-		col = CONTROLLER_MAX_COLS;
-	else
-		col++;
+	_controller_screen_write(&controller_screens[id], line, col, str);
+	internal_port_mutex_give(port);
+	return 1;
+}
 
+int32_t controller_print(controller_id_e_t id, uint8_t line, uint8_t col, const char* fmt, ...) {
+	char buf[CONTROLLER_MAX_COLS + 1];
 	va_list args;
 	va_start(args, fmt);
-	char* buf = (char*)malloc(CONTROLLER_MAX_COLS + 1);
 	vsnprintf(buf, CONTROLLER_MAX_COLS + 1, fmt, args);
-
-	uint32_t rtn_val = vexControllerTextSet(id, line, col, buf);
-	free(buf);
 	va_end(args);
 
-	internal_port_mutex_give(port);
-
-	if (!rtn_val) {
-		errno = EAGAIN;
-		return PROS_ERR;
-	}
-	return 1;
+	return controller_set_text(id, line, col, buf);
 }
 
 int32_t controller_clear_line(controller_id_e_t id, uint8_t line) {
 	static const char* clear = "                   ";
 	kassert(strlen(clear) == CONTROLLER_MAX_COLS);
-	return controller_print(id, line, 0, clear);
+	if (line >= CONTROLLER_MAX_LINES) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	return controller_set_text(id, line, 0, clear);
 }
 
 int32_t controller_clear(controller_id_e_t id) {
+	uint8_t port;
+	switch (id) {
+		case E_CONTROLLER_MASTER:
+			port = V5_PORT_CONTROLLER_1;
+			break;
+		case E_CONTROLLER_PARTNER:
+			port = V5_PORT_CONTROLLER_2;
+			break;
+		default:
+			errno = EINVAL;
+			return PROS_ERR;
+	}
+	if (!internal_port_mutex_take(port)) {
+		errno = EACCES;
+		return PROS_ERR;
+	}
+	controller_screen_s_t* screen = &controller_screens[id];
+	memset(screen->text, ' ', sizeof(screen->text));
 	if (vexSystemVersion() > 0x01000000) {
-		return controller_print(id, -1, 0, "");
+		// A single clear packet replaces any pending line updates
+		memset(screen->dirty_start, 0, sizeof(screen->dirty_start));
+		memset(screen->dirty_end, 0, sizeof(screen->dirty_end));
+		screen->clear_pending = true;
 	} else {
-		for (int i = 0; i < 3; i++) {
-			int32_t rtn = controller_clear_line(id, i);
-			if (rtn == PROS_ERR) return PROS_ERR;
-			if (i != 2) delay(55);
+		// vexOS 1.0.0 can't clear the screen at once, so send three blank lines
+		for (int i = 0; i < CONTROLLER_MAX_LINES; i++) {
+			screen->dirty_start[i] = 0;
+			screen->dirty_end[i] = CONTROLLER_MAX_COLS;
 		}
-		return 1;
 	}
+	internal_port_mutex_give(port);
+	return 1;
 }
 
 int32_t controller_rumble(controller_id_e_t id, const char* rumble_pattern) {
-	return controller_set_text(id, 3, 0, rumble_pattern);
+	return controller_set_text(id, CONTROLLER_RUMBLE_LINE, 0, rumble_pattern);
 }
 
 uint8_t competition_get_status(void) {
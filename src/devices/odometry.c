@@ -0,0 +1,282 @@
+/**
+ * \file devices/odometry.c
+ *
+ * Contains the kernel odometry service.
+ *
+ * The pose is integrated by the system daemon in every background processing
+ * cycle, right after the device data has been refreshed, so it is updated at
+ * the tick rate without a dedicated task. Readers get the pose through a
+ * seqlock and never take a port mutex.
+ *
+ * Each update treats the motion since the previous update as an arc of
+ * constant curvature: the local displacement is measured in the robot frame at
+ * the start of the update and rotated onto the field by the mean heading of the
+ * arc. All of the math is done in double precision so that long runs don't
+ * accumulate rounding error.
+ *
+ * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <errno.h>
+#include <math.h>
+#include <string.h>
+
+#include "common/seqlock.h"
+#include "kapi.h"
+#include "pros/imu.h"
+#include "pros/odometry.h"
+#include "v5_api.h"
+#include "vdml/registry.h"
+#include "vdml/vdml.h"
+
+#define DEG_TO_RAD (M_PI / 180)
+
+// Below this heading change an update is integrated as a straight line, where
+// the chord factor 2sin(x/2)/x is 1 to within double precision anyway
+#define ODOM_STRAIGHT_EPSILON 1e-9
+
+typedef struct odom_wheel_state_s {
+	bool valid;
+	double last;
+} odom_wheel_state_s_t;
+
+typedef struct odom_state_s {
+	bool running;
+	odom_config_s_t config;
+	odom_wheel_state_s_t left;
+	odom_wheel_state_s_t right;
+	odom_wheel_state_s_t back;
+	bool heading_valid;
+	double last_heading;
+	// The integrated pose; only the daemon writes it while the service is running
+	odom_pose_s_t pose;
+	seqlock_s_t lock;
+	odom_pose_s_t published;
+} odom_state_s_t;
+
+static odom_state_s_t odom;
+
+/**
+ * Reads the position of a tracking wheel in units of distance.
+ *
+ * Must be called with the port mutexes held.
+ *
+ * \return true if the sensor could be read
+ */
+static bool _odom_wheel_read(const odom_wheel_s_t* wheel, double* position) {
+	double raw;
+	switch (wheel->type) {
+		case E_ODOM_SENSOR_ADI_ENCODER:
+			if (registry_get_plugged_type(wheel->encoder.smart_port - 1) != E_DEVICE_ADI) return false;
+			raw = vexDeviceAdiValueGet(registry_get_device(wheel->encoder.smart_port - 1)->device_info,
+			                           wheel->encoder.adi_port - 1);
+			break;
+		case E_ODOM_SENSOR_MOTOR:
+			if (registry_get_plugged_type(wheel->motor_port - 1) != E_DEVICE_MOTOR) return false;
+			raw = vexDeviceMotorPositionGet(registry_get_device(wheel->motor_port - 1)->device_info);
+			break;
+		default:
+			return false;
+	}
+	*position = (wheel->reversed ? -raw : raw) / wheel->units_per_distance;
+	return true;
+}
+
+/**
+ * Gets the distance a wheel travelled since the last update.
+ *
+ * The first reading after the service starts or after the sensor comes back
+ * from being unplugged only establishes a baseline and reports no motion.
+ */
+static double _odom_wheel_delta(const odom_wheel_s_t* wheel, odom_wheel_state_s_t* state) {
+	double position;
+	if (!_odom_wheel_read(wheel, &position)) {
+		state->valid = false;
+		return 0;
+	}
+	double delta = state->valid ? position - state->last : 0;
+	state->valid = true;
+	state->last = position;
+	return delta;
+}
+
+/**
+ * Gets the heading change reported by the Inertial Sensor since the last
+ * update, in radians counterclockwise.
+ */
+static double _odom_imu_delta(void) {
+	uint8_t port = odom.config.imu_port - 1;
+	if (registry_get_plugged_type(port) != E_DEVICE_IMU) {
+		odom.heading_valid = false;
+		return 0;
+	}
+	V5_DeviceT device = registry_get_device(port)->device_info;
+	if (vexDeviceImuStatusGet(device) & E_IMU_STATUS_CALIBRATING) {
+		odom.heading_valid = false;
+		return 0;
+	}
+	// The sensor's heading is in degrees, clockwise, and wraps at 360
+	double heading = -vexDeviceImuHeadingGet(device) * DEG_TO_RAD;
+	double delta = 0;
+	if (odom.heading_valid) {
+		delta = remainder(heading - odom.last_heading, 2 * M_PI);
+	}
+	odom.heading_valid = true;
+	odom.last_heading = heading;
+	return delta;
+}
+
+static void _odom_publish(void) {
+	seqlock_write_begin(&odom.lock);
+	odom.published = odom.pose;
+	seqlock_write_end(&odom.lock);
+}
+
+/**
+ * Integrates the motion of the robot since the last update.
+ *
+ * Called by the system daemon right after vexBackgroundProcessing, while it
+ * holds all of the port mutexes.
+ */
+void odom_background_processing() {
+	if (!odom.running) return;
+	const odom_config_s_t* config = &odom.config;
+	bool has_left = config->left.type != E_ODOM_SENSOR_NONE;
+	bool has_right = config->right.type != E_ODOM_SENSOR_NONE;
+
+	double d_left = has_left ? _odom_wheel_delta(&config->left, &odom.left) : 0;
+	double d_right = has_right ? _odom_wheel_delta(&config->right, &odom.right) : 0;
+	double d_back = config->back.type != E_ODOM_SENSOR_NONE ? _odom_wheel_delta(&config->back, &odom.back) : 0;
+
+	double d_theta;
+	if (config->imu_port) {
+		d_theta = _odom_imu_delta();
+	} else {
+		d_theta = (d_right - d_left) / (config->left.offset + config->right.offset);
+	}
+
+	// Remove the part of each wheel's travel that came from the robot turning, so
+	// that what's left is the translation of the tracking center
+	double local_x;
+	if (has_left && has_right) {
+		local_x = ((d_left + config->left.offset * d_theta) + (d_right - config->right.offset * d_theta)) / 2;
+	} else if (has_left) {
+		local_x = d_left + config->left.offset * d_theta;
+	} else {
+		local_x = d_right - config->right.offset * d_theta;
+	}
+	double local_y = d_back + config->back.offset * d_theta;
+
+	// Over an arc, the chord is shorter than the distance travelled along it by
+	// 2sin(dθ/2)/dθ and points along the mean heading
+	double chord = fabs(d_theta) < ODOM_STRAIGHT_EPSILON ? 1 : 2 * sin(d_theta / 2) / d_theta;
+	double mean_theta = odom.pose.theta + d_theta / 2;
+	double c = cos(mean_theta);
+	double s = sin(mean_theta);
+
+	odom.pose.x += chord * (local_x * c - local_y * s);
+	odom.pose.y += chord * (local_x * s + local_y * c);
+	odom.pose.theta = remainder(odom.pose.theta + d_theta, 2 * M_PI);
+	odom.pose.timestamp = millis();
+	odom.pose.updates++;
+	_odom_publish();
+}
+
+static bool _odom_wheel_valid(const odom_wheel_s_t* wheel) {
+	switch (wheel->type) {
+		case E_ODOM_SENSOR_NONE:
+			return true;
+		case E_ODOM_SENSOR_ADI_ENCODER:
+			if (!VALIDATE_PORT_NO(wheel->encoder.smart_port - 1) || wheel->encoder.adi_port < 1 ||
+			    wheel->encoder.adi_port > NUM_ADI_PORTS) {
+				errno = ENXIO;
+				return false;
+			}
+			break;
+		case E_ODOM_SENSOR_MOTOR:
+			if (!VALIDATE_PORT_NO(wheel->motor_port - 1)) {
+				errno = ENXIO;
+				return false;
+			}
+			break;
+		default:
+			errno = EINVAL;
+			return false;
+	}
+	if (wheel->units_per_distance == 0 || !isfinite(wheel->units_per_distance)) {
+		errno = EINVAL;
+		return false;
+	}
+	return true;
+}
+
+int32_t odom_start(const odom_config_s_t* const config) {
+	if (config == NULL) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	if (!_odom_wheel_valid(&config->left) || !_odom_wheel_valid(&config->right) ||
+	    !_odom_wheel_valid(&config->back)) {
+		return PROS_ERR;
+	}
+	if (config->imu_port && !VALIDATE_PORT_NO(config->imu_port - 1)) {
+		errno = ENXIO;
+		return PROS_ERR;
+	}
+	bool has_left = config->left.type != E_ODOM_SENSOR_NONE;
+	bool has_right = config->right.type != E_ODOM_SENSOR_NONE;
+	if (config->imu_port ? !(has_left || has_right)
+	                     : !(has_left && has_right) || config->left.offset + config->right.offset == 0) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+
+	port_mutex_take_all();
+	memset(&odom.left, 0, sizeof(odom.left));
+	memset(&odom.right, 0, sizeof(odom.right));
+	memset(&odom.back, 0, sizeof(odom.back));
+	odom.heading_valid = false;
+	odom.config = *config;
+	odom.pose = (odom_pose_s_t){.timestamp = millis()};
+	_odom_publish();
+	odom.running = true;
+	port_mutex_give_all();
+	return 1;
+}
+
+int32_t odom_stop(void) {
+	port_mutex_take_all();
+	odom.running = false;
+	port_mutex_give_all();
+	return 1;
+}
+
+int32_t odom_get_pose(odom_pose_s_t* const pose) {
+	if (!odom.running || pose == NULL) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	seqlock_read(&odom.lock, pose, &odom.published, sizeof(odom_pose_s_t));
+	return 1;
+}
+
+int32_t odom_set_pose(double x, double y, double theta) {
+	port_mutex_take_all();
+	if (!odom.running) {
+		port_mutex_give_all();
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	odom.pose.x = x;
+	odom.pose.y = y;
+	odom.pose.theta = remainder(theta, 2 * M_PI);
+	odom.pose.timestamp = millis();
+	_odom_publish();
+	port_mutex_give_all();
+	return 1;
+}
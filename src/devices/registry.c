@@ -14,6 +14,7 @@
 
 #include <errno.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "api.h"
 #include "kapi.h"
@@ -24,10 +25,24 @@
 
 static v5_smart_device_s_t registry[V5_MAX_DEVICE_PORTS];
 static V5_DeviceType registry_types[V5_MAX_DEVICE_PORTS];
+static V5_DeviceType registry_types_last[V5_MAX_DEVICE_PORTS];
+
+#define REGISTRY_MAX_SUBSCRIBERS 16
+
+typedef struct {
+	void* handle;  // task_t or queue_t, NULL if the slot is free
+	bool is_queue;
+	uint32_t event_mask;
+} registry_subscriber_s_t;
+
+static registry_subscriber_s_t registry_subscribers[REGISTRY_MAX_SUBSCRIBERS];
+static static_sem_s_t registry_subscribers_mutex_buf;
+static mutex_t registry_subscribers_mutex;
 
 void registry_init() {
 	int i;
 	kprint("[VDML][INFO]Initializing registry\n");
+	registry_subscribers_mutex = mutex_create_static(&registry_subscribers_mutex_buf);
 	registry_update_types();
 	for (i = 0; i < NUM_V5_PORTS; i++) {
 		registry[i].device_type = (v5_device_e_t)registry_types[i];
@@ -40,6 +55,7 @@ void registry_init() {
 }
 
 void registry_update_types() {
+	memcpy(registry_types_last, registry_types, sizeof(registry_types));
 	vexDeviceGetStatus(registry_types);
 }
 
@@ -61,6 +77,8 @@ int registry_bind_port(uint8_t port, v5_device_e_t device_type) {
 	}
 	kprintf("[VDML][INFO]Registering device in port %d\n", port + 1);
 	v5_smart_device_s_t device;
+	// Device state kept in the pad must not carry over from a previous binding
+	memset(&device, 0, sizeof(device));
 	device.device_type = device_type;
 	device.device_info = vexDeviceGetByIndex(port);
 	registry[port] = device;
@@ -110,6 +128,99 @@ v5_device_e_t registry_get_plugged_type(uint8_t port) {
 	return registry_types[port];
 }
 
+v5_device_e_t registry_get_last_plugged_type(uint8_t port) {
+	if (!VALIDATE_PORT_NO(port)) {
+		errno = ENXIO;
+		return -1;
+	}
+	return registry_types_last[port];
+}
+
+static int32_t _registry_subscribe(void* handle, bool is_queue, uint32_t event_mask) {
+	if (handle == NULL || !(event_mask & REGISTRY_EVENT_ALL)) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	mutex_take(registry_subscribers_mutex, TIMEOUT_MAX);
+	registry_subscriber_s_t* free_slot = NULL;
+	for (size_t i = 0; i < REGISTRY_MAX_SUBSCRIBERS; i++) {
+		if (registry_subscribers[i].handle == handle) {
+			// Already subscribed, just update the mask
+			free_slot = &registry_subscribers[i];
+			break;
+		}
+		if (free_slot == NULL && registry_subscribers[i].handle == NULL) {
+			free_slot = &registry_subscribers[i];
+		}
+	}
+	if (free_slot == NULL) {
+		mutex_give(registry_subscribers_mutex);
+		errno = ENOMEM;
+		return PROS_ERR;
+	}
+	free_slot->is_queue = is_queue;
+	free_slot->event_mask = event_mask & REGISTRY_EVENT_ALL;
+	free_slot->handle = handle;
+	mutex_give(registry_subscribers_mutex);
+	return 1;
+}
+
+int32_t registry_subscribe_task(task_t task, uint32_t event_mask) {
+	return _registry_subscribe(task, false, event_mask);
+}
+
+int32_t registry_subscribe_queue(queue_t queue, uint32_t event_mask) {
+	return _registry_subscribe(queue, true, event_mask);
+}
+
+int32_t registry_unsubscribe(void* subscriber) {
+	int32_t rtn = PROS_ERR;
+	mutex_take(registry_subscribers_mutex, TIMEOUT_MAX);
+	for (size_t i = 0; i < REGISTRY_MAX_SUBSCRIBERS; i++) {
+		if (subscriber != NULL && registry_subscribers[i].handle == subscriber) {
+			registry_subscribers[i].handle = NULL;
+			rtn = 1;
+			break;
+		}
+	}
+	mutex_give(registry_subscribers_mutex);
+	if (rtn == PROS_ERR) errno = ENOENT;
+	return rtn;
+}
+
+void registry_task_delete_hook(task_t task) {
+	// Tasks can be deleted before the registry is initialized
+	if (registry_subscribers_mutex == NULL) return;
+	if (task == NULL) task = task_get_current();
+	mutex_take(registry_subscribers_mutex, TIMEOUT_MAX);
+	for (size_t i = 0; i < REGISTRY_MAX_SUBSCRIBERS; i++) {
+		if (registry_subscribers[i].handle == task && !registry_subscribers[i].is_queue) {
+			registry_subscribers[i].handle = NULL;
+		}
+	}
+	mutex_give(registry_subscribers_mutex);
+}
+
+void registry_publish_event(uint8_t port, registry_event_e_t event) {
+	if (!VALIDATE_PORT_NO(port)) return;
+	registry_event_s_t record = {.event = event,
+	                             .port = port + 1,
+	                             .plugged_type = (v5_device_e_t)registry_types[port],
+	                             .bound_type = registry[port].device_type,
+	                             .timestamp = millis()};
+	mutex_take(registry_subscribers_mutex, TIMEOUT_MAX);
+	for (size_t i = 0; i < REGISTRY_MAX_SUBSCRIBERS; i++) {
+		registry_subscriber_s_t* sub = &registry_subscribers[i];
+		if (sub->handle == NULL || !(sub->event_mask & event)) continue;
+		if (sub->is_queue) {
+			queue_append(sub->handle, &record, 0);
+		} else {
+			task_notify_ext(sub->handle, 1 << port, E_NOTIFY_ACTION_BITS, NULL);
+		}
+	}
+	mutex_give(registry_subscribers_mutex);
+}
+
 int32_t registry_validate_binding(uint8_t port, v5_device_e_t expected_t) {
 	if (!VALIDATE_PORT_NO(port)) {
 		errno = ENXIO;
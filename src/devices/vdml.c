@@ -154,38 +154,55 @@ void vdml_reset_port_error() {
  * This function should be called by the system daemon approximately every
  * 2 milliseconds.
  *
- * Updates the registry type array, detecting what devices are actually
- * plugged in according to the system, then compares that with the registry
- * records.
+ * Compares the device types actually plugged in, which the system daemon
+ * refreshes right after vexBackgroundProcessing, with the registry records.
+ * Differences from the previous cycle are published to registry event
+ * subscribers as plug, unplug and mismatch events. Unlike the device
+ * background processing functions, this takes each port's mutex itself.
  *
  * On warnings, no operation is performed.
  */
 void vdml_background_processing() {
-	static int32_t last_port_errors = 0;
+	static uint8_t last_error_arr[NUM_V5_PORTS];
+	static bool error_display_dirty = false;
 	static int cycle = 0;
 	cycle++;
 	if (cycle % 5000 == 0) {
 		vdml_reset_port_error();
-		last_port_errors = 0;
 	}
 
-	// Refresh actual device types
-	registry_update_types();
-
-	// Validate the ports. Warn if mismatch.
+	// Validate the ports. Warn if mismatch. The device types were refreshed by
+	// the system daemon right after vexBackgroundProcessing, and each port is only
+	// locked while its own binding is checked.
 	uint8_t error_arr[NUM_V5_PORTS];
 	int num_errors = 0;
 	int mismatch_errors = 0;
 	for (int i = 0; i < NUM_V5_PORTS; i++) {
+		port_mutex_take(i);
 		error_arr[i] = registry_validate_binding(i, E_DEVICE_NONE);
 		if (error_arr[i] != 0) num_errors++;
 		if (error_arr[i] == 2) mismatch_errors++;
-	}
-	// Every 50 ms
-	if (cycle % 50 == 0) {
-		if (last_port_errors == port_errors) {
-			goto end_render_errors;
+
+		// Publish hot-plug events by diffing against the previous cycle
+		v5_device_e_t last_t = registry_get_last_plugged_type(i);
+		v5_device_e_t actual_t = registry_get_plugged_type(i);
+		// A motor which was unplugged doesn't keep the last command it was given
+		if (last_t != actual_t && registry_get_bound_type(i) == E_DEVICE_MOTOR) motor_command_invalidate(i);
+		port_mutex_give(i);
+		if (last_t != actual_t) {
+			if (last_t != E_DEVICE_NONE) registry_publish_event(i, E_REGISTRY_EVENT_UNPLUGGED);
+			if (actual_t != E_DEVICE_NONE) registry_publish_event(i, E_REGISTRY_EVENT_PLUGGED);
+		}
+		if (error_arr[i] == 2 && last_error_arr[i] != 2) {
+			registry_publish_event(i, E_REGISTRY_EVENT_MISMATCH);
 		}
+		if (error_arr[i] != last_error_arr[i]) {
+			error_display_dirty = true;
+			last_error_arr[i] = error_arr[i];
+		}
+	}
+	// Every 50 ms, and only if a port's state has changed since the last render
+	if (cycle % 50 == 0 && error_display_dirty) {
 		char line[50];
 		char* line_ptr = line;
 		if (num_errors == 0)
@@ -254,7 +271,6 @@ void vdml_background_processing() {
 		// Null terminate the string
 		*line_ptr = '\0';
 		display_error(line);
-	end_render_errors:
-		last_port_errors = port_errors;
+		error_display_dirty = false;
 	}
 }
@@ -26,6 +26,14 @@
 
 #define NUM_MAX_TWOWIRE 4
 
+// ADI values are only updated this often (in ms), so sampling faster only
+// yields repeated values
+#define ADI_UPDATE_PERIOD 10
+// Number of samples averaged by an analog calibration
+#define ADI_CALIBRATION_SAMPLES 50
+// Most tasks which can be woken at once when an expander's calibration finishes
+#define ADI_CALIBRATION_MAX_WAITERS 32
+
 // Theoretical calibration time is 1024ms, but in practice this seemed to be the
 // actual time that it takes.
 #define GYRO_CALIBRATION_TIME 1300
@@ -120,19 +128,184 @@ int32_t adi_port_set_value(uint8_t smart_port, uint8_t adi_port, int32_t value)
 	return_port(smart_port - 1, 1);
 }
 
-int32_t adi_analog_calibrate(uint8_t smart_port, uint8_t adi_port) {
+/**
+ * Background analog calibration engine
+ *
+ * ADI values only update about every ADI_UPDATE_PERIOD ms, so rather than have
+ * each caller sample its port in a loop, the system daemon samples every port
+ * with a calibration in progress once per update and accumulates the mean and
+ * variance. Any number of ports calibrate concurrently in the time it takes to
+ * calibrate one.
+ */
+
+typedef enum adi_calibration_state {
+	E_ADI_CALIBRATION_IDLE = 0,
+	E_ADI_CALIBRATION_RUNNING,
+	E_ADI_CALIBRATION_DONE,
+	E_ADI_CALIBRATION_FAILED  // the port stopped being an analog input
+} adi_calibration_state_e_t;
+
+typedef struct adi_calibration {
+	adi_calibration_state_e_t state;
+	uint32_t count;
+	uint32_t sum;
+	uint64_t sum_squares;
+	int32_t average;
+	double variance;
+} adi_calibration_s_t;
+
+// Per smart port state of the calibration engine. Protected by the port mutex.
+typedef struct adi_calibrator {
+	adi_calibration_s_t ports[8];
+	uint8_t running;      // number of ports with a calibration running
+	uint8_t waiters;      // number of tasks blocked in adi_analog_calibrate_wait
+	uint32_t last_sample;  // millis() of the last sample taken
+	sem_t done_sem;       // posted once per waiter when a calibration finishes
+} adi_calibrator_s_t;
+
+static adi_calibrator_s_t adi_calibrators[NUM_V5_PORTS];
+static static_sem_s_t adi_calibrator_sem_bufs[NUM_V5_PORTS];
+static uint32_t adi_calibrations_running = 0;
+
+static void _adi_calibration_finish(adi_calibrator_s_t* calibrator, adi_calibration_s_t* calibration,
+                                    adi_calibration_state_e_t state) {
+	calibration->state = state;
+	calibrator->running--;
+	adi_calibrations_running--;
+	// Wake every waiter, each of which checks whether its own port finished
+	for (; calibrator->waiters; calibrator->waiters--) {
+		sem_post(calibrator->done_sem);
+	}
+}
+
+/**
+ * Takes one sample of every ADI port with a calibration in progress.
+ *
+ * Called by the system daemon while it holds all of the port mutexes.
+ */
+void adi_background_processing() {
+	if (!adi_calibrations_running) return;
+	uint32_t now = millis();
+	for (int port = 0; port < NUM_V5_PORTS; port++) {
+		adi_calibrator_s_t* calibrator = &adi_calibrators[port];
+		if (!calibrator->running || now - calibrator->last_sample < ADI_UPDATE_PERIOD) continue;
+		calibrator->last_sample = now;
+		bool plugged = registry_get_plugged_type(port) == E_DEVICE_ADI;
+		v5_smart_device_s_t* device = registry_get_device(port);
+		for (uint8_t adi_port = 0; adi_port < 8; adi_port++) {
+			adi_calibration_s_t* calibration = &calibrator->ports[adi_port];
+			if (calibration->state != E_ADI_CALIBRATION_RUNNING) continue;
+			if (!plugged || (adi_port_config_e_t)vexDeviceAdiPortConfigGet(device->device_info, adi_port) != E_ADI_ANALOG_IN) {
+				_adi_calibration_finish(calibrator, calibration, E_ADI_CALIBRATION_FAILED);
+				continue;
+			}
+			uint32_t value = vexDeviceAdiValueGet(device->device_info, adi_port);
+			calibration->sum += value;
+			calibration->sum_squares += value * value;
+			if (++calibration->count < ADI_CALIBRATION_SAMPLES) continue;
+
+			const uint32_t n = ADI_CALIBRATION_SAMPLES;
+			double mean = (double)calibration->sum / n;
+			calibration->average = (calibration->sum + n / 2) / n;
+			calibration->variance = (double)calibration->sum_squares / n - mean * mean;
+			adi_data_s_t* const adi_data = &((adi_data_s_t*)(device->pad))[adi_port];
+			adi_data->analog_data.calib = (int32_t)((calibration->sum * 16 + n / 2) / n);
+			_adi_calibration_finish(calibrator, calibration, E_ADI_CALIBRATION_DONE);
+		}
+	}
+}
+
+int32_t adi_analog_calibrate_async(uint8_t smart_port, uint8_t adi_port) {
 	transform_adi_port(adi_port);
 	claim_port_i(smart_port - 1, E_DEVICE_ADI);
 	validate_type(device, adi_port, E_ADI_ANALOG_IN);
-	uint32_t total = 0;
-	for (uint32_t i = 0; i < 512; i++) {
-		total += vexDeviceAdiValueGet(device->device_info, adi_port);
-		task_delay(1);  // TODO: If smart ports (and the ADI) only update every 10ms, this really only reads 56 samples,
-		                // maybe change to a 10ms
+	adi_calibrator_s_t* calibrator = &adi_calibrators[smart_port - 1];
+	if (calibrator->done_sem == NULL) {
+		calibrator->done_sem = sem_create_static(ADI_CALIBRATION_MAX_WAITERS, 0, &adi_calibrator_sem_bufs[smart_port - 1]);
 	}
-	adi_data_s_t* const adi_data = &((adi_data_s_t*)(device->pad))[adi_port];
-	adi_data->analog_data.calib = (int32_t)((total + 16) >> 5);
-	return_port(smart_port - 1, (int32_t)((total + 256) >> 9));
+	adi_calibration_s_t* calibration = &calibrator->ports[adi_port];
+	if (calibration->state != E_ADI_CALIBRATION_RUNNING) {
+		calibrator->running++;
+		adi_calibrations_running++;
+	}
+	calibration->state = E_ADI_CALIBRATION_RUNNING;
+	calibration->count = 0;
+	calibration->sum = 0;
+	calibration->sum_squares = 0;
+	return_port(smart_port - 1, 1);
+}
+
+int32_t adi_analog_calibrate_wait(uint8_t smart_port, uint8_t adi_port, uint32_t timeout) {
+	transform_adi_port(adi_port);
+	uint32_t start = millis();
+	while (true) {
+		claim_port_i(smart_port - 1, E_DEVICE_ADI);
+		adi_calibrator_s_t* calibrator = &adi_calibrators[smart_port - 1];
+		adi_calibration_s_t* calibration = &calibrator->ports[adi_port];
+		switch (calibration->state) {
+			case E_ADI_CALIBRATION_IDLE:
+				errno = EINVAL;
+				return_port(smart_port - 1, PROS_ERR);
+			case E_ADI_CALIBRATION_FAILED:
+				errno = EADDRINUSE;
+				return_port(smart_port - 1, PROS_ERR);
+			case E_ADI_CALIBRATION_DONE:
+				return_port(smart_port - 1, calibration->average);
+			default:
+				break;
+		}
+		uint32_t remaining = TIMEOUT_MAX;
+		if (timeout != TIMEOUT_MAX) {
+			uint32_t elapsed = millis() - start;
+			if (elapsed >= timeout) {
+				errno = EAGAIN;
+				return_port(smart_port - 1, PROS_ERR);
+			}
+			remaining = timeout - elapsed;
+		}
+		// The daemon can't finish a calibration until the port mutex is given, so
+		// registering as a waiter first means the wakeup can't be missed
+		calibrator->waiters++;
+		port_mutex_give(smart_port - 1);
+		if (sem_wait(calibrator->done_sem, remaining)) continue;
+		// Timed out, so take back the count unless the daemon already posted for
+		// us, in which case consume that post so it can't wake a later waiter
+		port_mutex_take(smart_port - 1);
+		if (calibrator->waiters > 0) {
+			calibrator->waiters--;
+		} else {
+			sem_wait(calibrator->done_sem, 0);
+		}
+		port_mutex_give(smart_port - 1);
+	}
+}
+
+double adi_analog_get_calibration_variance(uint8_t smart_port, uint8_t adi_port) {
+	if (adi_port >= 'a' && adi_port <= 'h')
+		adi_port -= 'a';
+	else if (adi_port >= 'A' && adi_port <= 'H')
+		adi_port -= 'A';
+	else
+		adi_port--;
+	if (adi_port > 7) {
+		errno = ENXIO;
+		return PROS_ERR_F;
+	}
+	claim_port_f(smart_port - 1, E_DEVICE_ADI);
+	adi_calibration_s_t* calibration = &adi_calibrators[smart_port - 1].ports[adi_port];
+	if (calibration->state != E_ADI_CALIBRATION_DONE) {
+		errno = EINVAL;
+		return_port(smart_port - 1, PROS_ERR_F);
+	}
+	double rtn = calibration->variance;
+	return_port(smart_port - 1, rtn);
+}
+
+int32_t adi_analog_calibrate(uint8_t smart_port, uint8_t adi_port) {
+	if (adi_analog_calibrate_async(smart_port, adi_port) == PROS_ERR) {
+		return PROS_ERR;
+	}
+	return adi_analog_calibrate_wait(smart_port, adi_port, TIMEOUT_MAX);
 }
 
 int32_t adi_analog_read(uint8_t smart_port, uint8_t adi_port) {
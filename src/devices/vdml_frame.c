@@ -0,0 +1,194 @@
+/**
+ * \file devices/vdml_frame.c
+ *
+ * Contains functions for reading sensors by background processing frame.
+ *
+ * The system daemon holds every port mutex while it runs vexBackgroundProcessing
+ * and advances the frame counter, so a reader which holds the mutexes of the
+ * ports it reads sees all of them, and the frame stamp, from a single frame.
+ *
+ * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <errno.h>
+
+#include "common/seqlock.h"
+#include "kapi.h"
+#include "pros/frame.h"
+#include "pros/imu.h"
+#include "v5_api.h"
+#include "vdml/registry.h"
+#include "vdml/vdml.h"
+
+static seqlock_s_t frame_lock;
+static frame_stamp_s_t frame_stamp;
+
+/**
+ * Starts a new frame.
+ *
+ * Called by the system daemon right after vexBackgroundProcessing, while it
+ * holds all of the port mutexes.
+ */
+void vdml_frame_advance(void) {
+	seqlock_write_begin(&frame_lock);
+	frame_stamp.frame++;
+	frame_stamp.timestamp = vexSystemHighResTimeGet();
+	seqlock_write_end(&frame_lock);
+}
+
+int32_t frame_get_stamp(frame_stamp_s_t* const stamp) {
+	if (stamp == NULL) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	seqlock_read(&frame_lock, stamp, &frame_stamp, sizeof(frame_stamp_s_t));
+	return 1;
+}
+
+static v5_device_e_t _frame_source_device(frame_source_e_t source) {
+	if (source <= E_FRAME_SOURCE_MOTOR_VOLTAGE) return E_DEVICE_MOTOR;
+	if (source <= E_FRAME_SOURCE_IMU_ACCEL_Z) return E_DEVICE_IMU;
+	if (source == E_FRAME_SOURCE_ADI_VALUE) return E_DEVICE_ADI;
+	return E_DEVICE_VISION;
+}
+
+/**
+ * Converts an ADI port from 1-8 or 'a'-'h' to 0-7, or returns -1 if it isn't
+ * valid.
+ */
+static int32_t _frame_adi_port(uint8_t port) {
+	if (port >= 'a' && port <= 'h') return port - 'a';
+	if (port >= 'A' && port <= 'H') return port - 'A';
+	if (port >= 1 && port <= NUM_ADI_PORTS) return port - 1;
+	return -1;
+}
+
+/**
+ * Takes a single reading. The port's mutex must be held.
+ *
+ * \return true if the reading succeeded, false if it failed, setting errno
+ */
+static bool _frame_read_one(frame_read_s_t* read) {
+	V5_DeviceT device = registry_get_device(read->port - 1)->device_info;
+	if (registry_get_plugged_type(read->port - 1) != _frame_source_device(read->source)) {
+		errno = ENODEV;
+		return false;
+	}
+	if (_frame_source_device(read->source) == E_DEVICE_IMU &&
+	    (vexDeviceImuStatusGet(device) & E_IMU_STATUS_CALIBRATING)) {
+		errno = EAGAIN;
+		return false;
+	}
+
+	V5_DeviceImuAttitude euler;
+	V5_DeviceImuRaw raw;
+	switch (read->source) {
+		case E_FRAME_SOURCE_MOTOR_POSITION:
+			read->value = vexDeviceMotorPositionGet(device);
+			break;
+		case E_FRAME_SOURCE_MOTOR_VELOCITY:
+			read->value = vexDeviceMotorActualVelocityGet(device);
+			break;
+		case E_FRAME_SOURCE_MOTOR_CURRENT:
+			read->value = vexDeviceMotorCurrentGet(device);
+			break;
+		case E_FRAME_SOURCE_MOTOR_VOLTAGE:
+			read->value = vexDeviceMotorVoltageGet(device);
+			break;
+		case E_FRAME_SOURCE_IMU_ROTATION:
+			read->value = vexDeviceImuDegreesGet(device);
+			break;
+		case E_FRAME_SOURCE_IMU_HEADING:
+			read->value = vexDeviceImuHeadingGet(device);
+			break;
+		case E_FRAME_SOURCE_IMU_PITCH:
+		case E_FRAME_SOURCE_IMU_ROLL:
+		case E_FRAME_SOURCE_IMU_YAW:
+			vexDeviceImuAttitudeGet(device, &euler);
+			read->value = read->source == E_FRAME_SOURCE_IMU_PITCH
+			                  ? euler.pitch
+			                  : read->source == E_FRAME_SOURCE_IMU_ROLL ? euler.roll : euler.yaw;
+			break;
+		case E_FRAME_SOURCE_IMU_GYRO_X:
+		case E_FRAME_SOURCE_IMU_GYRO_Y:
+		case E_FRAME_SOURCE_IMU_GYRO_Z:
+			vexDeviceImuRawGyroGet(device, &raw);
+			read->value = read->source == E_FRAME_SOURCE_IMU_GYRO_X
+			                  ? raw.x
+			                  : read->source == E_FRAME_SOURCE_IMU_GYRO_Y ? raw.y : raw.z;
+			break;
+		case E_FRAME_SOURCE_IMU_ACCEL_X:
+		case E_FRAME_SOURCE_IMU_ACCEL_Y:
+		case E_FRAME_SOURCE_IMU_ACCEL_Z:
+			vexDeviceImuRawAccelGet(device, &raw);
+			read->value = read->source == E_FRAME_SOURCE_IMU_ACCEL_X
+			                  ? raw.x
+			                  : read->source == E_FRAME_SOURCE_IMU_ACCEL_Y ? raw.y : raw.z;
+			break;
+		case E_FRAME_SOURCE_ADI_VALUE:
+			read->value = vexDeviceAdiValueGet(device, _frame_adi_port(read->adi_port));
+			break;
+		case E_FRAME_SOURCE_VISION_OBJECT_COUNT:
+			read->value = vexDeviceVisionObjectCountGet(device);
+			break;
+	}
+	read->device_timestamp = vexDeviceTimestampGet(device);
+	return true;
+}
+
+int32_t frame_read(frame_read_s_t* const reads, size_t count, frame_stamp_s_t* const stamp) {
+	if (reads == NULL || stamp == NULL) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	for (size_t i = 0; i < count; i++) {
+		if (reads[i].source > E_FRAME_SOURCE_VISION_OBJECT_COUNT) {
+			errno = EINVAL;
+			return PROS_ERR;
+		}
+		if (!VALIDATE_PORT_NO(reads[i].port - 1) ||
+		    (reads[i].source == E_FRAME_SOURCE_ADI_VALUE && _frame_adi_port(reads[i].adi_port) < 0)) {
+			errno = ENXIO;
+			return PROS_ERR;
+		}
+	}
+
+	// Bind the ports like any other VDML function would, then take their mutexes
+	// in port order so that two overlapping reads can't deadlock
+	uint32_t ports = 0;
+	for (size_t i = 0; i < count; i++) {
+		reads[i].value = PROS_ERR_F;
+		reads[i].device_timestamp = 0;
+		if (registry_validate_binding(reads[i].port - 1, _frame_source_device(reads[i].source)) == 0) {
+			ports |= 1u << (reads[i].port - 1);
+		}
+	}
+	for (uint8_t port = 0; port < NUM_V5_PORTS; port++) {
+		if (ports & (1u << port)) port_mutex_take(port);
+	}
+
+	int32_t succeeded = 0;
+	int error = errno;
+	for (size_t i = 0; i < count; i++) {
+		if (!(ports & (1u << (reads[i].port - 1)))) {
+			error = ENODEV;
+		} else if (_frame_read_one(&reads[i])) {
+			succeeded++;
+		} else {
+			error = errno;
+			reads[i].value = PROS_ERR_F;
+		}
+	}
+	seqlock_read(&frame_lock, stamp, &frame_stamp, sizeof(frame_stamp_s_t));
+
+	for (uint8_t port = 0; port < NUM_V5_PORTS; port++) {
+		if (ports & (1u << port)) port_mutex_give(port);
+	}
+	errno = error;
+	return succeeded;
+}
@@ -11,6 +11,11 @@
  */
 
 #include <errno.h>
+#include <math.h>
+#include <string.h>
+
+#include "common/seqlock.h"
+#include "kapi.h"
 #include "pros/imu.h"
 #include "v5_api.h"
 #include "vdml/registry.h"
@@ -157,3 +162,279 @@ imu_status_e_t imu_get_status(uint8_t port) {
 	rtn = vexDeviceImuStatusGet(device->device_info);
 	return_port(port - 1, rtn);
 }
+
+/******************************************************************************/
+/**                              Kernel sampler                              **/
+/******************************************************************************/
+
+#define IMU_SAMPLER_DEFAULT_COMPLEMENTARY_GAIN 0.98
+#define IMU_SAMPLER_DEFAULT_MADGWICK_GAIN 0.1
+// Gaps between samples longer than this (in ms) restart the filter's time step
+#define IMU_SAMPLER_MAX_DT 100
+#define DEG_TO_RAD (M_PI / 180.0)
+
+/**
+ * Per-port sampler state. The system daemon is the only writer. Readers don't
+ * take the port mutex: the fused output is published through a seqlock and the
+ * raw samples through a ring buffer whose slots are only reused
+ * IMU_SAMPLER_BUFFER_SIZE samples later. Samplers are never freed once
+ * allocated, so a lock-free reader can't be left with a dangling pointer.
+ */
+typedef struct imu_sampler {
+	volatile bool enabled;
+	imu_filter_e_t filter;
+	double gain;
+	bool primed;  // a previous sample exists to compute the time step from
+	uint32_t last_timestamp;
+	double q[4];             // Madgwick attitude quaternion {w, x, y, z}
+	double roll, pitch, yaw;  // complementary filter attitude, in radians
+	double gyro_rotation;
+	volatile uint32_t head;  // number of samples written to the ring
+	imu_sample_s_t samples[IMU_SAMPLER_BUFFER_SIZE];
+	seqlock_s_t lock;
+	imu_fused_s_t fused;
+} imu_sampler_s_t;
+
+static imu_sampler_s_t* imu_samplers[NUM_V5_PORTS];
+
+static void _imu_accel_tilt(const imu_accel_s_t* a, double* roll, double* pitch) {
+	*roll = atan2(a->y, a->z);
+	*pitch = atan2(-a->x, sqrt(a->y * a->y + a->z * a->z));
+}
+
+static void _imu_euler_to_quaternion(double roll, double pitch, double yaw, double* q) {
+	double cr = cos(roll / 2), sr = sin(roll / 2);
+	double cp = cos(pitch / 2), sp = sin(pitch / 2);
+	double cy = cos(yaw / 2), sy = sin(yaw / 2);
+	q[0] = cr * cp * cy + sr * sp * sy;
+	q[1] = sr * cp * cy - cr * sp * sy;
+	q[2] = cr * sp * cy + sr * cp * sy;
+	q[3] = cr * cp * sy - sr * sp * cy;
+}
+
+static void _imu_quaternion_to_euler(const double* q, double* roll, double* pitch, double* yaw) {
+	*roll = atan2(2 * (q[0] * q[1] + q[2] * q[3]), 1 - 2 * (q[1] * q[1] + q[2] * q[2]));
+	double sinp = 2 * (q[0] * q[2] - q[3] * q[1]);
+	*pitch = fabs(sinp) >= 1 ? copysign(M_PI / 2, sinp) : asin(sinp);
+	*yaw = atan2(2 * (q[0] * q[3] + q[1] * q[2]), 1 - 2 * (q[2] * q[2] + q[3] * q[3]));
+}
+
+static void _imu_complementary_update(imu_sampler_s_t* sampler, const imu_sample_s_t* sample, double dt) {
+	double acc_roll, acc_pitch;
+	_imu_accel_tilt(&sample->accel, &acc_roll, &acc_pitch);
+	double alpha = sampler->gain;
+	sampler->roll = alpha * (sampler->roll + sample->gyro.x * DEG_TO_RAD * dt) + (1 - alpha) * acc_roll;
+	sampler->pitch = alpha * (sampler->pitch + sample->gyro.y * DEG_TO_RAD * dt) + (1 - alpha) * acc_pitch;
+	// Gravity says nothing about yaw, so it is integrated from the gyro alone
+	sampler->yaw = remainder(sampler->yaw + sample->gyro.z * DEG_TO_RAD * dt, 2 * M_PI);
+	_imu_euler_to_quaternion(sampler->roll, sampler->pitch, sampler->yaw, sampler->q);
+}
+
+// 6DOF variant of Madgwick's gradient descent orientation filter
+static void _imu_madgwick_update(imu_sampler_s_t* sampler, const imu_sample_s_t* sample, double dt) {
+	double* q = sampler->q;
+	double gx = sample->gyro.x * DEG_TO_RAD, gy = sample->gyro.y * DEG_TO_RAD, gz = sample->gyro.z * DEG_TO_RAD;
+	double ax = sample->accel.x, ay = sample->accel.y, az = sample->accel.z;
+
+	double dq0 = 0.5 * (-q[1] * gx - q[2] * gy - q[3] * gz);
+	double dq1 = 0.5 * (q[0] * gx + q[2] * gz - q[3] * gy);
+	double dq2 = 0.5 * (q[0] * gy - q[1] * gz + q[3] * gx);
+	double dq3 = 0.5 * (q[0] * gz + q[1] * gy - q[2] * gx);
+
+	double norm = sqrt(ax * ax + ay * ay + az * az);
+	if (norm > 0) {
+		ax /= norm;
+		ay /= norm;
+		az /= norm;
+		double q0q0 = q[0] * q[0], q1q1 = q[1] * q[1], q2q2 = q[2] * q[2], q3q3 = q[3] * q[3];
+		double s0 = 4 * q[0] * q2q2 + 2 * q[2] * ax + 4 * q[0] * q1q1 - 2 * q[1] * ay;
+		double s1 = 4 * q[1] * q3q3 - 2 * q[3] * ax + 4 * q0q0 * q[1] - 2 * q[0] * ay - 4 * q[1] + 8 * q[1] * q1q1 +
+		            8 * q[1] * q2q2 + 4 * q[1] * az;
+		double s2 = 4 * q0q0 * q[2] + 2 * q[0] * ax + 4 * q[2] * q3q3 - 2 * q[3] * ay - 4 * q[2] + 8 * q[2] * q1q1 +
+		            8 * q[2] * q2q2 + 4 * q[2] * az;
+		double s3 = 4 * q1q1 * q[3] - 2 * q[1] * ax + 4 * q2q2 * q[3] - 2 * q[2] * ay;
+		norm = sqrt(s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3);
+		if (norm > 0) {
+			dq0 -= sampler->gain * s0 / norm;
+			dq1 -= sampler->gain * s1 / norm;
+			dq2 -= sampler->gain * s2 / norm;
+			dq3 -= sampler->gain * s3 / norm;
+		}
+	}
+
+	q[0] += dq0 * dt;
+	q[1] += dq1 * dt;
+	q[2] += dq2 * dt;
+	q[3] += dq3 * dt;
+	norm = sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+	for (int i = 0; i < 4; i++) q[i] /= norm;
+	_imu_quaternion_to_euler(q, &sampler->roll, &sampler->pitch, &sampler->yaw);
+}
+
+static void _imu_sampler_reset(imu_sampler_s_t* sampler, imu_filter_e_t filter, double gain) {
+	sampler->filter = filter;
+	sampler->gain = gain;
+	sampler->primed = false;
+	sampler->roll = sampler->pitch = sampler->yaw = 0;
+	sampler->gyro_rotation = 0;
+	_imu_euler_to_quaternion(0, 0, 0, sampler->q);
+	seqlock_write_begin(&sampler->lock);
+	memset(&sampler->fused, 0, sizeof(sampler->fused));
+	sampler->fused.attitude.w = 1;
+	seqlock_write_end(&sampler->lock);
+}
+
+static void _imu_sampler_process(imu_sampler_s_t* sampler, V5_DeviceT device) {
+	if (vexDeviceImuStatusGet(device) & E_IMU_STATUS_CALIBRATING) {
+		sampler->primed = false;
+		return;
+	}
+	uint32_t timestamp = vexDeviceTimestampGet(device);
+	if (sampler->primed && timestamp == sampler->last_timestamp) {
+		return;  // no new sample yet
+	}
+
+	// Write the sample into the slot past head before publishing it
+	imu_sample_s_t* sample = &sampler->samples[sampler->head % IMU_SAMPLER_BUFFER_SIZE];
+	V5_DeviceImuRaw raw;
+	vexDeviceImuRawGyroGet(device, &raw);
+	sample->gyro = (imu_gyro_s_t){.x = raw.x, .y = raw.y, .z = raw.z};
+	vexDeviceImuRawAccelGet(device, &raw);
+	sample->accel = (imu_accel_s_t){.x = raw.x, .y = raw.y, .z = raw.z};
+	sample->timestamp = timestamp;
+	__sync_synchronize();
+	sampler->head++;
+
+	if (!sampler->primed) {
+		// Start from the attitude gravity gives, rather than converging from level
+		double roll, pitch;
+		_imu_accel_tilt(&sample->accel, &roll, &pitch);
+		sampler->roll = roll;
+		sampler->pitch = pitch;
+		_imu_euler_to_quaternion(roll, pitch, sampler->yaw, sampler->q);
+	} else {
+		uint32_t dt_ms = timestamp - sampler->last_timestamp;
+		double dt = (dt_ms > IMU_SAMPLER_MAX_DT ? IMU_SAMPLER_MAX_DT : dt_ms) / 1000.0;
+		sampler->gyro_rotation += sample->gyro.z * dt;
+		if (sampler->filter == E_IMU_FILTER_MADGWICK) {
+			_imu_madgwick_update(sampler, sample, dt);
+		} else {
+			_imu_complementary_update(sampler, sample, dt);
+		}
+	}
+	sampler->primed = true;
+	sampler->last_timestamp = timestamp;
+
+	seqlock_write_begin(&sampler->lock);
+	sampler->fused.attitude = (quaternion_s_t){.x = sampler->q[1], .y = sampler->q[2], .z = sampler->q[3], .w = sampler->q[0]};
+	sampler->fused.euler = (euler_s_t){
+	    .pitch = sampler->pitch / DEG_TO_RAD, .roll = sampler->roll / DEG_TO_RAD, .yaw = sampler->yaw / DEG_TO_RAD};
+	sampler->fused.gyro_rotation = sampler->gyro_rotation;
+	sampler->fused.samples++;
+	sampler->fused.timestamp = timestamp;
+	seqlock_write_end(&sampler->lock);
+}
+
+/**
+ * Runs the kernel sampler of every Inertial Sensor which has it enabled.
+ *
+ * Called by the system daemon right after vexBackgroundProcessing, while it
+ * holds all of the port mutexes.
+ */
+void imu_background_processing() {
+	for (int port = 0; port < NUM_V5_PORTS; port++) {
+		imu_sampler_s_t* sampler = imu_samplers[port];
+		if (sampler == NULL || !sampler->enabled || registry_get_plugged_type(port) != E_DEVICE_IMU) continue;
+		_imu_sampler_process(sampler, registry_get_device(port)->device_info);
+	}
+}
+
+int32_t imu_sampler_enable(uint8_t port, imu_filter_e_t filter, double gain) {
+	if ((filter != E_IMU_FILTER_COMPLEMENTARY && filter != E_IMU_FILTER_MADGWICK) || gain < 0) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	if (gain == 0) {
+		gain = filter == E_IMU_FILTER_MADGWICK ? IMU_SAMPLER_DEFAULT_MADGWICK_GAIN
+		                                       : IMU_SAMPLER_DEFAULT_COMPLEMENTARY_GAIN;
+	}
+	if (!claim_port_try(port - 1, E_DEVICE_IMU)) {
+		return PROS_ERR;
+	}
+	imu_sampler_s_t* sampler = imu_samplers[port - 1];
+	if (sampler == NULL) {
+		sampler = (imu_sampler_s_t*)kmalloc(sizeof(imu_sampler_s_t));
+		if (sampler == NULL) {
+			errno = ENOMEM;
+			return_port(port - 1, PROS_ERR);
+		}
+		memset(sampler, 0, sizeof(imu_sampler_s_t));
+		imu_samplers[port - 1] = sampler;
+	}
+	_imu_sampler_reset(sampler, filter, gain);
+	sampler->enabled = true;
+	return_port(port - 1, 1);
+}
+
+int32_t imu_sampler_disable(uint8_t port) {
+	if (!claim_port_try(port - 1, E_DEVICE_IMU)) {
+		return PROS_ERR;
+	}
+	if (imu_samplers[port - 1]) {
+		imu_samplers[port - 1]->enabled = false;
+	}
+	return_port(port - 1, 1);
+}
+
+static imu_sampler_s_t* _imu_sampler_get(uint8_t port) {
+	if (!VALIDATE_PORT_NO(port - 1)) {
+		errno = ENXIO;
+		return NULL;
+	}
+	imu_sampler_s_t* sampler = imu_samplers[port - 1];
+	if (sampler == NULL || !sampler->enabled) {
+		errno = EINVAL;
+		return NULL;
+	}
+	return sampler;
+}
+
+int32_t imu_sampler_get_fused(uint8_t port, imu_fused_s_t* const fused) {
+	imu_sampler_s_t* sampler = _imu_sampler_get(port);
+	if (sampler == NULL) {
+		return PROS_ERR;
+	}
+	seqlock_read(&sampler->lock, fused, &sampler->fused, sizeof(imu_fused_s_t));
+	return 1;
+}
+
+int32_t imu_sampler_read(uint8_t port, uint32_t* const cursor, imu_sample_s_t* const sample_arr,
+                         const uint32_t sample_count) {
+	imu_sampler_s_t* sampler = _imu_sampler_get(port);
+	if (sampler == NULL) {
+		return PROS_ERR;
+	}
+	uint32_t next = *cursor;
+	uint32_t copied = 0;
+	while (copied < sample_count) {
+		uint32_t head = sampler->head;
+		__sync_synchronize();
+		if (next == head) break;
+		if (head - next >= IMU_SAMPLER_BUFFER_SIZE) {
+			// Fell behind (or the cursor is invalid), so skip to the oldest sample.
+			// The slot of sample head - IMU_SAMPLER_BUFFER_SIZE is the one the writer
+			// fills next, so it can't be read safely
+			next = head >= IMU_SAMPLER_BUFFER_SIZE ? head - IMU_SAMPLER_BUFFER_SIZE + 1 : 0;
+		}
+		sample_arr[copied] = sampler->samples[next % IMU_SAMPLER_BUFFER_SIZE];
+		__sync_synchronize();
+		// The slot is rewritten once head reaches next + IMU_SAMPLER_BUFFER_SIZE, so
+		// the copy is only good if the writer hasn't got there yet. Otherwise head
+		// is read again, which skips past the overwritten sample
+		if (sampler->head - next >= IMU_SAMPLER_BUFFER_SIZE) continue;
+		copied++;
+		next++;
+	}
+	*cursor = next;
+	return copied;
+}
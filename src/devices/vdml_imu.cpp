@@ -65,4 +65,21 @@ pros::c::imu_status_e_t Imu::get_status() const {
 bool Imu::is_calibrating() const {
 	return get_status() & pros::c::E_IMU_STATUS_CALIBRATING;
 }
+
+std::int32_t Imu::enable_sampler(pros::c::imu_filter_e_t filter, double gain) const {
+	return pros::c::imu_sampler_enable(_port, filter, gain);
+}
+
+std::int32_t Imu::disable_sampler() const {
+	return pros::c::imu_sampler_disable(_port);
+}
+
+std::int32_t Imu::get_fused(pros::c::imu_fused_s_t* const fused) const {
+	return pros::c::imu_sampler_get_fused(_port, fused);
+}
+
+std::int32_t Imu::read_samples(std::uint32_t* const cursor, pros::c::imu_sample_s_t* const sample_arr,
+                               const std::uint32_t sample_count) const {
+	return pros::c::imu_sampler_read(_port, cursor, sample_arr, sample_count);
+}
 }  // namespace pros
@@ -23,8 +23,19 @@
 #define MOTOR_MOVE_RANGE 127
 #define MOTOR_VOLTAGE_RANGE 12000
 
+// The movement command last sent to a motor, used to skip sending the same
+// command again
+typedef enum motor_command_e {
+	E_MOTOR_COMMAND_NONE = 0,  // unknown, or a profiled movement
+	E_MOTOR_COMMAND_VOLTAGE,
+	E_MOTOR_COMMAND_VELOCITY
+} motor_command_e_t;
+
 typedef struct motor_data {
 	V5_DeviceMotorPid pos_pid, vel_pid;
+	motor_command_e_t command;
+	int32_t command_value;
+	motor_command_stats_s_t command_stats;
 } motor_data_s_t;
 
 static V5_DeviceMotorPid get_pos_pid(uint8_t port) {
@@ -45,6 +56,36 @@ static void set_vel_pid(uint8_t port, V5_DeviceMotorPid vel) {
 	data->vel_pid = vel;
 }
 
+/**
+ * Records a movement command given to a motor.
+ *
+ * \return true if the command should be sent to the motor, false if it's the
+ * same as the last one sent
+ */
+static bool _motor_command_update(uint8_t port, motor_command_e_t command, int32_t value) {
+	motor_data_s_t* data = (motor_data_s_t*)registry_get_device(port)->pad;
+	if (command != E_MOTOR_COMMAND_NONE && data->command == command && data->command_value == value) {
+		data->command_stats.suppressed++;
+		return false;
+	}
+	data->command = command;
+	data->command_value = value;
+	data->command_stats.issued++;
+	return true;
+}
+
+void motor_command_invalidate(uint8_t port) {
+	((motor_data_s_t*)registry_get_device(port)->pad)->command = E_MOTOR_COMMAND_NONE;
+}
+
+void motor_command_invalidate_all(void) {
+	for (int i = 0; i < NUM_V5_PORTS; i++) {
+		port_mutex_take(i);
+		if (registry_get_bound_type(i) == E_DEVICE_MOTOR) motor_command_invalidate(i);
+		port_mutex_give(i);
+	}
+}
+
 // Movement functions
 
 int32_t motor_move(uint8_t port, int32_t voltage) {
@@ -63,30 +104,37 @@ int32_t motor_move(uint8_t port, int32_t voltage) {
 
 int32_t motor_move_absolute(uint8_t port, const double position, const int32_t velocity) {
 	claim_port_i(port - 1, E_DEVICE_MOTOR);
+	_motor_command_update(port - 1, E_MOTOR_COMMAND_NONE, 0);
 	vexDeviceMotorAbsoluteTargetSet(device->device_info, position, velocity);
 	return_port(port - 1, 1);
 }
 
 int32_t motor_move_relative(uint8_t port, const double position, const int32_t velocity) {
 	claim_port_i(port - 1, E_DEVICE_MOTOR);
+	_motor_command_update(port - 1, E_MOTOR_COMMAND_NONE, 0);
 	vexDeviceMotorRelativeTargetSet(device->device_info, position, velocity);
 	return_port(port - 1, 1);
 }
 
 int32_t motor_move_velocity(uint8_t port, const int32_t velocity) {
 	claim_port_i(port - 1, E_DEVICE_MOTOR);
-	vexDeviceMotorVelocitySet(device->device_info, velocity);
+	if (_motor_command_update(port - 1, E_MOTOR_COMMAND_VELOCITY, velocity)) {
+		vexDeviceMotorVelocitySet(device->device_info, velocity);
+	}
 	return_port(port - 1, 1);
 }
 
 int32_t motor_move_voltage(uint8_t port, const int32_t voltage) {
 	claim_port_i(port - 1, E_DEVICE_MOTOR);
-	vexDeviceMotorVoltageSet(device->device_info, voltage);
+	if (_motor_command_update(port - 1, E_MOTOR_COMMAND_VOLTAGE, voltage)) {
+		vexDeviceMotorVoltageSet(device->device_info, voltage);
+	}
 	return_port(port - 1, 1);
 }
 
 int32_t motor_modify_profiled_velocity(uint8_t port, const int32_t velocity) {
 	claim_port_i(port - 1, E_DEVICE_MOTOR);
+	_motor_command_update(port - 1, E_MOTOR_COMMAND_NONE, 0);
 	vexDeviceMotorVelocityUpdate(device->device_info, velocity);
 	return_port(port - 1, 1);
 }
@@ -103,6 +151,24 @@ int32_t motor_get_target_velocity(uint8_t port) {
 	return_port(port - 1, rtn);
 }
 
+int32_t motor_refresh_command(uint8_t port) {
+	if (!claim_port_try(port - 1, E_DEVICE_MOTOR)) {
+		return PROS_ERR;
+	}
+	motor_command_invalidate(port - 1);
+	return_port(port - 1, 1);
+}
+
+int32_t motor_get_command_stats(uint8_t port, motor_command_stats_s_t* const stats) {
+	if (stats == NULL) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	claim_port_i(port - 1, E_DEVICE_MOTOR);
+	*stats = ((motor_data_s_t*)device->pad)->command_stats;
+	return_port(port - 1, 1);
+}
+
 // Telemetry functions
 
 double motor_get_actual_velocity(uint8_t port) {
@@ -239,6 +305,7 @@ int32_t motor_set_encoder_units(uint8_t port, const motor_encoder_units_e_t unit
 
 int32_t motor_set_gearing(uint8_t port, const motor_gearset_e_t gearset) {
 	claim_port_i(port - 1, E_DEVICE_MOTOR);
+	motor_command_invalidate(port - 1);
 	vexDeviceMotorGearingSet(device->device_info, (V5MotorGearset)gearset);
 	return_port(port - 1, 1);
 }
@@ -324,6 +391,7 @@ int32_t motor_set_vel_pid_full(uint8_t port, const motor_pid_full_s_t pid) {
 
 int32_t motor_set_reversed(uint8_t port, const bool reverse) {
 	claim_port_i(port - 1, E_DEVICE_MOTOR);
+	motor_command_invalidate(port - 1);
 	vexDeviceMotorReverseFlagSet(device->device_info, reverse);
 	return_port(port - 1, 1);
 }
@@ -163,6 +163,14 @@ std::int32_t Motor::get_target_velocity(void) const {
 	return motor_get_target_velocity(_port);
 }
 
+std::int32_t Motor::refresh_command(void) const {
+	return motor_refresh_command(_port);
+}
+
+std::int32_t Motor::get_command_stats(motor_command_stats_s_t* const stats) const {
+	return motor_get_command_stats(_port, stats);
+}
+
 std::int32_t Motor::get_voltage(void) const {
 	return motor_get_voltage(_port);
 }
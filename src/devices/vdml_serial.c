@@ -13,6 +13,7 @@
 #include <errno.h>
 #include <math.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "kapi.h"
 #include "pros/serial.h"
@@ -20,6 +21,163 @@
 #include "vdml/registry.h"
 #include "vdml/vdml.h"
 
+/**
+ * Kernel receive buffer for a generic serial port. The system daemon is the
+ * only producer and runs with every port mutex held, so the buffer is
+ * protected by the port mutex like the rest of the device.
+ */
+typedef struct serial_rx {
+	uint8_t* buf;  // NULL if the receive buffer is disabled
+	uint32_t size;
+	uint32_t head;  // Index of the next byte to be written by the pump
+	uint32_t tail;  // Index of the next byte to be read
+	uint32_t count;
+	uint32_t overruns;  // Bytes dropped because the buffer was full
+} serial_rx_s_t;
+
+/**
+ * Wait objects for tasks blocked on a generic serial port. The counting
+ * semaphores are created the first time a task waits on the port and are
+ * posted by the system daemon after vexBackgroundProcessing, once for each
+ * waiting task, since several tasks can wait on the same port. Like
+ * serial_rx_s_t, the counts are protected by the port mutex.
+ */
+typedef struct serial_wait {
+	sem_t rx_sem;         // Posted when received bytes are available
+	sem_t tx_sem;         // Posted when there is space in the output FIFO
+	uint32_t rx_waiters;  // Tasks blocked in serial_rx_wait and not yet posted
+	uint32_t tx_waiters;  // Tasks blocked in serial_tx_wait and not yet posted
+} serial_wait_s_t;
+
+static serial_rx_s_t serial_rx[NUM_V5_PORTS];
+static serial_wait_s_t serial_wait[NUM_V5_PORTS];
+static static_sem_s_t serial_rx_sem_bufs[NUM_V5_PORTS];
+static static_sem_s_t serial_tx_sem_bufs[NUM_V5_PORTS];
+
+static int32_t _serial_rx_pop(serial_rx_s_t* rx, uint8_t* buffer, uint32_t length) {
+	if (length > rx->count) length = rx->count;
+	uint32_t first = rx->size - rx->tail;
+	if (first > length) first = length;
+	memcpy(buffer, rx->buf + rx->tail, first);
+	memcpy(buffer + first, rx->buf, length - first);
+	rx->tail = (rx->tail + length) % rx->size;
+	rx->count -= length;
+	return length;
+}
+
+static void _serial_wait_init(uint8_t port) {
+	serial_wait_s_t* wait = &serial_wait[port];
+	if (wait->rx_sem == NULL) {
+		wait->rx_sem = sem_create_static(UINT32_MAX, 0, &serial_rx_sem_bufs[port]);
+		wait->tx_sem = sem_create_static(UINT32_MAX, 0, &serial_tx_sem_bufs[port]);
+	}
+}
+
+static void _serial_wake(sem_t sem, uint32_t* waiters) {
+	for (; *waiters > 0; (*waiters)--) sem_post(sem);
+}
+
+/**
+ * Blocks on one of a port's wait semaphores, which must be called with the
+ * port mutex held and gives it up.
+ *
+ * A waiter which times out takes itself back off the count, unless the daemon
+ * has already posted for it, in which case it takes the post instead. Either
+ * way the count stays equal to the number of tasks still owed a post; at worst
+ * a later waiter is woken early by a post meant for one which timed out, which
+ * is allowed since waits only say that the port may be ready.
+ */
+static int32_t _serial_wait(uint8_t port, sem_t sem, uint32_t* waiters, uint32_t timeout) {
+	(*waiters)++;
+	port_mutex_give(port);
+	if (sem_wait(sem, timeout)) return 1;
+	port_mutex_take(port);
+	if (*waiters > 0) {
+		(*waiters)--;
+	} else {
+		sem_wait(sem, 0);
+	}
+	port_mutex_give(port);
+	return 0;
+}
+
+/**
+ * Moves received bytes from the VEXos input FIFOs into the kernel receive
+ * buffers, and wakes tasks waiting to read from or write to a generic serial
+ * port once they can make progress.
+ *
+ * Called by the system daemon right after vexBackgroundProcessing, while it
+ * holds all of the port mutexes.
+ */
+void serial_background_processing() {
+	for (int port = 0; port < NUM_V5_PORTS; port++) {
+		serial_rx_s_t* rx = &serial_rx[port];
+		serial_wait_s_t* wait = &serial_wait[port];
+		if (rx->buf == NULL && !wait->rx_waiters && !wait->tx_waiters) continue;
+		if (registry_get_plugged_type(port) != E_DEVICE_GENERIC) {
+			// Wake any waiters so that they see the device is gone instead of
+			// blocking until it comes back
+			_serial_wake(wait->rx_sem, &wait->rx_waiters);
+			_serial_wake(wait->tx_sem, &wait->tx_waiters);
+			continue;
+		}
+		V5_DeviceT device = registry_get_device(port)->device_info;
+
+		if (rx->buf) {
+			int32_t avail = vexDeviceGenericSerialReceiveAvail(device);
+			while (avail > 0 && rx->count < rx->size) {
+				// Read straight into the free space up to the end of the ring
+				uint32_t chunk = rx->size - rx->count;
+				if (chunk > rx->size - rx->head) chunk = rx->size - rx->head;
+				if (chunk > (uint32_t)avail) chunk = avail;
+				int32_t n = vexDeviceGenericSerialReceive(device, rx->buf + rx->head, chunk);
+				if (n <= 0) break;
+				rx->head = (rx->head + n) % rx->size;
+				rx->count += n;
+				avail -= n;
+			}
+			if (avail > 0 && rx->count == rx->size) {
+				// Drain the FIFO so that the newest bytes are counted instead of
+				// overflowing silently inside VEXos
+				uint8_t scratch[64];
+				int32_t n;
+				while ((n = vexDeviceGenericSerialReceive(device, scratch, sizeof(scratch))) > 0) {
+					rx->overruns += n;
+				}
+			}
+		}
+		if (wait->rx_waiters && (rx->buf ? rx->count > 0 : vexDeviceGenericSerialReceiveAvail(device) > 0)) {
+			_serial_wake(wait->rx_sem, &wait->rx_waiters);
+		}
+		if (wait->tx_waiters && vexDeviceGenericSerialWriteFree(device) > 0) {
+			_serial_wake(wait->tx_sem, &wait->tx_waiters);
+		}
+	}
+}
+
+int32_t serial_rx_wait(uint8_t port, uint32_t timeout) {
+	claim_port_i(port - 1, E_DEVICE_GENERIC);
+	serial_rx_s_t* rx = &serial_rx[port - 1];
+	serial_wait_s_t* wait = &serial_wait[port - 1];
+	if (rx->buf ? rx->count > 0 : vexDeviceGenericSerialReceiveAvail(device->device_info) > 0) {
+		return_port(port - 1, 1);
+	}
+	_serial_wait_init(port - 1);
+	// The daemon can't run until the port mutex is given, so no arrival can be
+	// missed
+	return _serial_wait(port - 1, wait->rx_sem, &wait->rx_waiters, timeout);
+}
+
+int32_t serial_tx_wait(uint8_t port, uint32_t timeout) {
+	claim_port_i(port - 1, E_DEVICE_GENERIC);
+	serial_wait_s_t* wait = &serial_wait[port - 1];
+	if (vexDeviceGenericSerialWriteFree(device->device_info) > 0) {
+		return_port(port - 1, 1);
+	}
+	_serial_wait_init(port - 1);
+	return _serial_wait(port - 1, wait->tx_sem, &wait->tx_waiters, timeout);
+}
+
 // Control function
 
 int32_t serial_enable(uint8_t port) {
@@ -51,14 +209,45 @@ int32_t serial_set_baudrate(uint8_t port, int32_t baudrate) {
 int32_t serial_flush(uint8_t port) {
 	claim_port_i(port - 1, E_DEVICE_GENERIC);
 	vexDeviceGenericSerialFlush(device->device_info);
+	serial_rx[port - 1].head = serial_rx[port - 1].tail = serial_rx[port - 1].count = 0;
+	return_port(port - 1, 1);
+}
+
+int32_t serial_set_rx_buffer(uint8_t port, uint32_t size) {
+	if (!claim_port_try(port - 1, E_DEVICE_GENERIC)) {
+		return PROS_ERR;
+	}
+	serial_rx_s_t* rx = &serial_rx[port - 1];
+	uint8_t* buf = NULL;
+	if (size) {
+		buf = (uint8_t*)kmalloc(size);
+		if (buf == NULL) {
+			errno = ENOMEM;
+			return_port(port - 1, PROS_ERR);
+		}
+	}
+	if (rx->buf) kfree(rx->buf);
+	rx->buf = buf;
+	rx->size = size;
+	rx->head = rx->tail = rx->count = 0;
+	rx->overruns = 0;
 	return_port(port - 1, 1);
 }
 
+int32_t serial_get_rx_overruns(uint8_t port) {
+	if (!claim_port_try(port - 1, E_DEVICE_GENERIC)) {
+		return PROS_ERR;
+	}
+	int32_t rtn = serial_rx[port - 1].overruns;
+	return_port(port - 1, rtn);
+}
+
 // Telemetry functions
 
 int32_t serial_get_read_avail(uint8_t port) {
 	claim_port_i(port - 1, E_DEVICE_GENERIC);
-	int32_t rtn = vexDeviceGenericSerialReceiveAvail(device->device_info);
+	serial_rx_s_t* rx = &serial_rx[port - 1];
+	int32_t rtn = rx->buf ? (int32_t)rx->count : vexDeviceGenericSerialReceiveAvail(device->device_info);
 	return_port(port - 1, rtn);
 }
 
@@ -72,19 +261,38 @@ int32_t serial_get_write_free(uint8_t port) {
 
 int32_t serial_peek_byte(uint8_t port) {
 	claim_port_i(port - 1, E_DEVICE_GENERIC);
-	int32_t rtn = vexDeviceGenericSerialPeekChar(device->device_info);
+	serial_rx_s_t* rx = &serial_rx[port - 1];
+	int32_t rtn;
+	if (rx->buf) {
+		rtn = rx->count ? rx->buf[rx->tail] : -1;
+	} else {
+		rtn = vexDeviceGenericSerialPeekChar(device->device_info);
+	}
 	return_port(port - 1, rtn);
 }
 
 int32_t serial_read_byte(uint8_t port) {
 	claim_port_i(port - 1, E_DEVICE_GENERIC);
-	int32_t rtn = vexDeviceGenericSerialReadChar(device->device_info);
+	serial_rx_s_t* rx = &serial_rx[port - 1];
+	int32_t rtn;
+	if (rx->buf) {
+		uint8_t byte;
+		rtn = _serial_rx_pop(rx, &byte, 1) ? byte : -1;
+	} else {
+		rtn = vexDeviceGenericSerialReadChar(device->device_info);
+	}
 	return_port(port - 1, rtn);
 }
 
 int32_t serial_read(uint8_t port, uint8_t* buffer, int32_t length) {
 	claim_port_i(port - 1, E_DEVICE_GENERIC);
-	int32_t rtn = vexDeviceGenericSerialReceive(device->device_info, buffer, length);
+	serial_rx_s_t* rx = &serial_rx[port - 1];
+	int32_t rtn;
+	if (rx->buf) {
+		rtn = length > 0 ? _serial_rx_pop(rx, buffer, length) : 0;
+	} else {
+		rtn = vexDeviceGenericSerialReceive(device->device_info, buffer, length);
+	}
 	return_port(port - 1, rtn);
 }
 
@@ -65,6 +65,14 @@ std::int32_t Serial::write(std::uint8_t* buffer, std::int32_t length) const {
 	return serial_write(_port, buffer, length);
 }
 
+std::int32_t Serial::set_rx_buffer(std::uint32_t size) const {
+	return serial_set_rx_buffer(_port, size);
+}
+
+std::int32_t Serial::get_rx_overruns() const {
+	return serial_get_rx_overruns(_port);
+}
+
 namespace literals {
 const pros::Serial operator"" _ser(const unsigned long long int m) {
 	return pros::Serial(m);
@@ -10,16 +10,45 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 
+#include <string.h>
+
 #include "kapi.h"
 #include "v5_api.h"
 #include "v5_apitypes.h"
 #include "vdml/registry.h"
 #include "vdml/vdml.h"
+#include "vdml/vision_tracker.h"
+
+// The most objects kept from a single frame
+#define VISION_FRAME_MAX_OBJECTS 32
+// Signatures 1-7 each get an index bucket, and color codes share bucket 0
+#define VISION_FRAME_BUCKET(sig) ((sig) <= 7 ? (sig) : 0)
 
 typedef struct vision_data {
 	vision_zero_e_t zero_point;
 } vision_data_s_t;
 
+/**
+ * Snapshot of the objects reported in one vision sensor frame, with their
+ * coordinates already transformed for the port's zero point.
+ *
+ * by_sig[n] holds the indices into objects of the objects in bucket n, in the
+ * size order reported by the sensor.
+ */
+typedef struct vision_frame {
+	uint32_t timestamp;  // Device timestamp of the frame
+	bool valid;
+	uint8_t count;
+	uint8_t sig_count[8];
+	uint8_t by_sig[8][VISION_FRAME_MAX_OBJECTS];
+	vision_object_s_t objects[VISION_FRAME_MAX_OBJECTS];
+} vision_frame_s_t;
+
+// Allocated the first time a port is queried for objects
+static vision_frame_s_t* vision_frames[NUM_V5_PORTS];
+// Allocated by vision_tracker_enable, NULL while the tracker is disabled
+static vision_tracker_s_t* vision_trackers[NUM_V5_PORTS];
+
 static vision_zero_e_t get_zero_point(uint8_t port) {
 	return ((vision_data_s_t*)registry_get_device(port)->pad)->zero_point;
 }
@@ -42,78 +71,110 @@ static void _vision_transform_coords(uint8_t port, vision_object_s_t* object_ptr
 	object_ptr->y_middle_coord = object_ptr->top_coord - (object_ptr->height / 2);
 }
 
-int32_t vision_get_object_count(uint8_t port) {
-	claim_port_i(port - 1, E_DEVICE_VISION);
-	int32_t rtn = vexDeviceVisionObjectCountGet(device->device_info);
-	return_port(port - 1, rtn);
+/**
+ * Gets the current object snapshot for a vision sensor, refreshing it if the
+ * sensor has reported a new frame since it was last read.
+ *
+ * All of the objects in a frame are read from VEXos and transformed once, and
+ * are indexed by signature so that signature queries don't need to rescan the
+ * frame. The port mutex must be held.
+ *
+ * \return The snapshot, or NULL if it could not be read, setting errno
+ */
+static vision_frame_s_t* _vision_get_frame(uint8_t port, v5_smart_device_s_t* device) {
+	vision_frame_s_t* frame = vision_frames[port];
+	if (frame == NULL) {
+		frame = (vision_frame_s_t*)kmalloc(sizeof(vision_frame_s_t));
+		if (frame == NULL) {
+			errno = ENOMEM;
+			return NULL;
+		}
+		frame->valid = false;
+		vision_frames[port] = frame;
+	}
+
+	uint32_t timestamp = vexDeviceTimestampGet(device->device_info);
+	if (frame->valid && frame->timestamp == timestamp) {
+		return frame;
+	}
+
+	int32_t count = vexDeviceVisionObjectCountGet(device->device_info);
+	if (count > VISION_FRAME_MAX_OBJECTS) count = VISION_FRAME_MAX_OBJECTS;
+	if (count < 0) count = 0;
+	memset(frame->sig_count, 0, sizeof(frame->sig_count));
+	for (int32_t i = 0; i < count; i++) {
+		vision_object_s_t* object = &frame->objects[i];
+		if (!vexDeviceVisionObjectGet(device->device_info, i, (V5_DeviceVisionObject*)object)) {
+			frame->valid = false;
+			errno = EAGAIN;
+			return NULL;
+		}
+		_vision_transform_coords(port, object);
+		uint8_t bucket = VISION_FRAME_BUCKET(object->signature);
+		frame->by_sig[bucket][frame->sig_count[bucket]++] = i;
+	}
+	frame->count = count;
+	frame->timestamp = timestamp;
+	frame->valid = true;
+	return frame;
 }
 
-vision_object_s_t vision_get_by_size(uint8_t port, const uint32_t size_id) {
-	vision_object_s_t rtn;
-	v5_smart_device_s_t* device;
-	if (!claim_port_try(port - 1, E_DEVICE_VISION)) {
-		rtn.signature = VISION_OBJECT_ERR_SIG;
-		return rtn;
+/**
+ * Copies up to object_count objects with the given signature or color code,
+ * skipping the first size_id of them, from a frame snapshot into object_arr.
+ *
+ * \return The number of objects copied
+ */
+static uint32_t _vision_frame_read_by_sig(vision_frame_s_t* frame, const uint32_t size_id, const uint32_t sig_id,
+                                          const uint32_t object_count, vision_object_s_t* const object_arr) {
+	uint8_t bucket = VISION_FRAME_BUCKET(sig_id);
+	uint32_t copied = 0;
+	if (bucket) {
+		// Every object in a signature's bucket matches, so this is a direct slice
+		for (uint32_t i = size_id; i < frame->sig_count[bucket] && copied < object_count; i++) {
+			object_arr[copied++] = frame->objects[frame->by_sig[bucket][i]];
+		}
+		return copied;
 	}
-	device = registry_get_device(port - 1);
-	if ((uint32_t)vexDeviceVisionObjectCountGet(device->device_info) <= size_id) {
-		errno = EDOM;
-		rtn.signature = VISION_OBJECT_ERR_SIG;
-		goto leave;
+	// Color codes share a bucket, which only has to be filtered by code
+	uint32_t seen = 0;
+	for (uint32_t i = 0; i < frame->sig_count[0] && copied < object_count; i++) {
+		vision_object_s_t* object = &frame->objects[frame->by_sig[0][i]];
+		if (object->signature == sig_id && seen++ >= size_id) {
+			object_arr[copied++] = *object;
+		}
 	}
-	if (vexDeviceVisionObjectGet(device->device_info, size_id, (V5_DeviceVisionObject*)&rtn) == 0) {
-		errno = EAGAIN;
-		rtn.signature = VISION_OBJECT_ERR_SIG;
-		goto leave;
+	return copied;
+}
+
+int32_t vision_get_object_count(uint8_t port) {
+	claim_port_i(port - 1, E_DEVICE_VISION);
+	vision_frame_s_t* frame = _vision_get_frame(port - 1, device);
+	if (frame == NULL) {
+		return_port(port - 1, PROS_ERR);
 	}
-	_vision_transform_coords(port - 1, &rtn);
+	return_port(port - 1, frame->count);
+}
 
-leave:
-	port_mutex_give(port - 1);
+vision_object_s_t vision_get_by_size(uint8_t port, const uint32_t size_id) {
+	vision_object_s_t rtn;
+	rtn.signature = VISION_OBJECT_ERR_SIG;
+	vision_read_by_size(port, size_id, 1, &rtn);
 	return rtn;
 }
 
 vision_object_s_t _vision_get_by_sig(uint8_t port, const uint32_t size_id, const uint32_t sig_id) {
 	vision_object_s_t rtn;
 	rtn.signature = VISION_OBJECT_ERR_SIG;
-	v5_smart_device_s_t* device;
-	uint8_t count = 0;
-	int32_t object_count = 0;
-
 	if (!claim_port_try(port - 1, E_DEVICE_VISION)) {
-		goto err_return_no_mutex;
-	}
-
-	device = registry_get_device(port - 1);
-	object_count = vexDeviceVisionObjectCountGet(device->device_info);
-	if ((uint32_t)object_count <= size_id) {
-		errno = EDOM;
-		goto err_return;
+		return rtn;
 	}
-
-	for (uint8_t i = 0; i <= object_count; i++) {
-		vision_object_s_t check;
-		if (vexDeviceVisionObjectGet(device->device_info, i, (V5_DeviceVisionObject*)&check) == PROS_ERR) {
-			errno = EAGAIN;
-			rtn = check;
-			goto err_return;
-		}
-		if (check.signature == sig_id) {
-			if (count == size_id) {
-				rtn = check;
-				_vision_transform_coords(port - 1, &rtn);
-				port_mutex_give(port - 1);
-				return rtn;
-			}
-			count++;
-		}
+	vision_frame_s_t* frame = _vision_get_frame(port - 1, registry_get_device(port - 1));
+	if (frame != NULL && !_vision_frame_read_by_sig(frame, size_id, sig_id, 1, &rtn)) {
+		errno = EDOM;  // fewer than size_id + 1 objects matched sig_id
+		rtn.signature = VISION_OBJECT_ERR_SIG;
 	}
-	errno = EDOM;  // we read through all the objects and none matched sig_id and size_id
-
-err_return:
 	port_mutex_give(port - 1);
-err_return_no_mutex:
-	rtn.signature = VISION_OBJECT_ERR_SIG;
 	return rtn;
 }
 
@@ -134,75 +195,51 @@ vision_object_s_t vision_get_by_code(uint8_t port, const uint32_t size_id, const
 int32_t vision_read_by_size(uint8_t port, const uint32_t size_id, const uint32_t object_count,
                             vision_object_s_t* const object_arr) {
 	claim_port_i(port - 1, E_DEVICE_VISION);
-	for (uint8_t i = 0; i < object_count; i++) {
+	for (uint32_t i = 0; i < object_count; i++) {
 		object_arr[i].signature = VISION_OBJECT_ERR_SIG;
 	}
-	uint32_t c = vexDeviceVisionObjectCountGet(device->device_info);
-	if (c <= size_id) {
-		port_mutex_give(port - 1);
+	vision_frame_s_t* frame = _vision_get_frame(port - 1, device);
+	if (frame == NULL) {
+		return_port(port - 1, PROS_ERR);
+	}
+	if (frame->count <= size_id) {
 		errno = EDOM;
-		return PROS_ERR;
-	} else if (c > object_count + size_id) {
-		c = object_count + size_id;
+		return_port(port - 1, PROS_ERR);
 	}
-
-	for (uint32_t i = size_id; i < c; i++) {
-		if (!vexDeviceVisionObjectGet(device->device_info, i, (V5_DeviceVisionObject*)(object_arr + i))) {
-			errno = EAGAIN;
-			object_arr[i].signature = VISION_OBJECT_ERR_SIG;
-			break;
-		}
-		_vision_transform_coords(port - 1, &object_arr[i]);
+	uint32_t c = frame->count - size_id;
+	if (c > object_count) {
+		c = object_count;
 	}
+	memcpy(object_arr, frame->objects + size_id, c * sizeof(vision_object_s_t));
 	return_port(port - 1, c);
 }
 
 int32_t _vision_read_by_sig(uint8_t port, const uint32_t size_id, const uint32_t sig_id, const uint32_t object_count,
                             vision_object_s_t* const object_arr) {
 	claim_port_i(port - 1, E_DEVICE_VISION);
-	for (uint8_t i = 0; i < object_count; i++) {
+	for (uint32_t i = 0; i < object_count; i++) {
 		object_arr[i].signature = VISION_OBJECT_ERR_SIG;
 	}
-	uint32_t c = vexDeviceVisionObjectCountGet(device->device_info);
-	if (c <= size_id) {
-		errno = EDOM;
-		port_mutex_give(port - 1);
-		return PROS_ERR;
+	vision_frame_s_t* frame = _vision_get_frame(port - 1, device);
+	if (frame == NULL) {
+		return_port(port - 1, PROS_ERR);
 	}
-	if (c > object_count) {
-		c = object_count;
+	uint32_t c = _vision_frame_read_by_sig(frame, size_id, sig_id, object_count, object_arr);
+	if (c == 0 && object_count > 0) {
+		errno = EDOM;  // fewer than size_id + 1 objects matched sig_id
+		return_port(port - 1, PROS_ERR);
 	}
-
-	uint32_t j = 0;                    // track how many objects we've placed into object_arr
-	uint32_t seen = 0;                 // track how many objects we've seen matching sig_id
-	for (uint8_t i = 0; i < c; i++) {  // loop through all objects on sensor
-		// place i-th object on vision sensor on j-th position in object_arr
-		if (!vexDeviceVisionObjectGet(device->device_info, i, (V5_DeviceVisionObject*)(object_arr + j))) {
-			errno = EAGAIN;
-			object_arr[i].signature = VISION_OBJECT_ERR_SIG;
-			goto rtn;
-		}
-		// check if this (j-th) object matches sig_id
-		if (object_arr[j].signature == sig_id) {
-			seen++;
-			if (seen >= size_id) {  // have we seen enough objects to start adding to object_arr?
-				// if so, transform the coords and "commit" it by incrementing j
-				_vision_transform_coords(port - 1, &object_arr[j]);
-				j++;
-				if (j == object_count) goto rtn;
-			}
-		}
+	if (c < object_count) {
+		errno = EDOM;  // couldn't find enough objects matching the filter parameters
 	}
-	errno = EDOM;  // read through all objects and couldn't find enough objects matching filter parameters
-rtn:
-	return_port(port - 1, j);
+	return_port(port - 1, c);
 }
 
 int32_t vision_read_by_sig(uint8_t port, const uint32_t size_id, const uint32_t sig_id, const uint32_t object_count,
                            vision_object_s_t* const object_arr) {
 	if (sig_id > 7 || sig_id == 0) {
 		errno = EINVAL;
-		for (uint8_t i = 0; i < object_count; i++) {
+		for (uint32_t i = 0; i < object_count; i++) {
 			object_arr[i].signature = VISION_OBJECT_ERR_SIG;
 		}
 		return PROS_ERR;
@@ -215,6 +252,70 @@ int32_t vision_read_by_code(uint8_t port, const uint32_t size_id, const vision_c
 	return _vision_read_by_sig(port, size_id, color_code, object_count, object_arr);
 }
 
+/**
+ * Feeds each new frame of the vision sensors with an enabled tracker to their
+ * trackers.
+ *
+ * Called by the system daemon while it holds all of the port mutexes.
+ */
+void vision_background_processing() {
+	for (int port = 0; port < NUM_V5_PORTS; port++) {
+		vision_tracker_s_t* tracker = vision_trackers[port];
+		if (tracker == NULL || registry_get_plugged_type(port) != E_DEVICE_VISION) continue;
+		vision_frame_s_t* frame = _vision_get_frame(port, registry_get_device(port));
+		if (frame == NULL || frame->timestamp == tracker->last_frame) continue;
+		vision_tracker_update(tracker, frame->objects, frame->count, frame->timestamp, millis());
+	}
+}
+
+int32_t vision_tracker_enable(uint8_t port) {
+	if (!claim_port_try(port - 1, E_DEVICE_VISION)) {
+		return PROS_ERR;
+	}
+	vision_tracker_s_t* tracker = vision_trackers[port - 1];
+	if (tracker == NULL) {
+		tracker = (vision_tracker_s_t*)kmalloc(sizeof(vision_tracker_s_t));
+		if (tracker == NULL) {
+			errno = ENOMEM;
+			return_port(port - 1, PROS_ERR);
+		}
+	}
+	vision_tracker_init(tracker);
+	vision_trackers[port - 1] = tracker;
+	return_port(port - 1, 1);
+}
+
+int32_t vision_tracker_disable(uint8_t port) {
+	if (!claim_port_try(port - 1, E_DEVICE_VISION)) {
+		return PROS_ERR;
+	}
+	kfree(vision_trackers[port - 1]);
+	vision_trackers[port - 1] = NULL;
+	return_port(port - 1, 1);
+}
+
+int32_t vision_get_tracks(uint8_t port, const uint32_t track_count, vision_track_s_t* const track_arr) {
+	if (!claim_port_try(port - 1, E_DEVICE_VISION)) {
+		return PROS_ERR;
+	}
+	vision_tracker_s_t* tracker = vision_trackers[port - 1];
+	if (tracker == NULL) {
+		errno = EINVAL;
+		return_port(port - 1, PROS_ERR);
+	}
+	uint32_t c = tracker->count < track_count ? tracker->count : track_count;
+	for (uint32_t i = 0; i < c; i++) {
+		track_arr[i] = tracker->entries[i].track;
+	}
+	return_port(port - 1, c);
+}
+
+void vision_track_predict(const vision_track_s_t* const track, const uint32_t time, float* const x, float* const y) {
+	float dt = (int32_t)(time - track->timestamp) / 1000.0f;
+	*x = track->x + track->vx * dt;
+	*y = track->y + track->vy * dt;
+}
+
 vision_signature_s_t vision_get_signature(uint8_t port, const uint8_t signature_id) {
 	vision_signature_s_t sig;
 	sig.id = VISION_OBJECT_ERR_SIG;
@@ -356,6 +457,10 @@ int32_t vision_set_zero_point(uint8_t port, vision_zero_e_t zero_point) {
 		return PROS_ERR;
 	}
 	set_zero_point(port - 1, zero_point);
+	// The snapshot's coordinates were transformed for the old zero point
+	if (vision_frames[port - 1]) {
+		vision_frames[port - 1]->valid = false;
+	}
 	return_port(port - 1, 1);
 }
 
@@ -115,4 +115,16 @@ std::int32_t Vision::set_zero_point(vision_zero_e_t zero_point) const {
 std::int32_t Vision::set_wifi_mode(const std::uint8_t enable) const {
 	return vision_set_wifi_mode(_port, enable);
 }
+
+std::int32_t Vision::enable_tracker(void) const {
+	return vision_tracker_enable(_port);
+}
+
+std::int32_t Vision::disable_tracker(void) const {
+	return vision_tracker_disable(_port);
+}
+
+std::int32_t Vision::get_tracks(const std::uint32_t track_count, vision_track_s_t* const track_arr) const {
+	return vision_get_tracks(_port, track_count, track_arr);
+}
 }  // namespace pros
@@ -0,0 +1,160 @@
+/**
+ * \file devices/vdml_vision_tracker.c
+ *
+ * Contains the multi-object tracker used by the vision sensor.
+ *
+ * Each track runs an independent constant-velocity Kalman filter on the x and
+ * y coordinates of the middle of its object. Objects are assigned to tracks by
+ * greedy global nearest neighbor: the closest gated (track, object) pair of the
+ * same signature is matched first, then the next closest of the remaining ones,
+ * and so on. With the handful of objects the sensor reports per frame this
+ * gives the same result as an optimal assignment in nearly every case, for a
+ * fraction of the cost.
+ *
+ * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "vdml/vision_tracker.h"
+
+#define TRACKER_MAX_OBJECTS 32
+#define TRACKER_NO_MATCH 0xff
+
+static void _axis_init(vision_tracker_axis_s_t* axis, float pos) {
+	axis->pos = pos;
+	axis->vel = 0;
+	axis->p_pos = VISION_TRACKER_MEASUREMENT_NOISE * VISION_TRACKER_MEASUREMENT_NOISE;
+	axis->p_cross = 0;
+	// The velocity of a new object is unknown, so start with a large variance
+	axis->p_vel = 300.0f * 300.0f;
+}
+
+static void _axis_predict(vision_tracker_axis_s_t* axis, float dt) {
+	const float q = VISION_TRACKER_ACCEL_NOISE * VISION_TRACKER_ACCEL_NOISE;
+	const float dt2 = dt * dt;
+	axis->pos += axis->vel * dt;
+	axis->p_pos += dt * 2 * axis->p_cross + dt2 * axis->p_vel + q * dt2 * dt2 / 4;
+	axis->p_cross += dt * axis->p_vel + q * dt2 * dt / 2;
+	axis->p_vel += q * dt2;
+}
+
+static void _axis_correct(vision_tracker_axis_s_t* axis, float measured) {
+	const float r = VISION_TRACKER_MEASUREMENT_NOISE * VISION_TRACKER_MEASUREMENT_NOISE;
+	float s = axis->p_pos + r;
+	float k_pos = axis->p_pos / s;
+	float k_vel = axis->p_cross / s;
+	float innovation = measured - axis->pos;
+	axis->pos += k_pos * innovation;
+	axis->vel += k_vel * innovation;
+	axis->p_vel -= k_vel * axis->p_cross;
+	axis->p_pos *= 1 - k_pos;
+	axis->p_cross *= 1 - k_pos;
+}
+
+static void _entry_publish(vision_tracker_entry_s_t* entry, uint32_t now) {
+	entry->track.x = entry->x.pos;
+	entry->track.y = entry->y.pos;
+	entry->track.vx = entry->x.vel;
+	entry->track.vy = entry->y.vel;
+	entry->track.timestamp = now;
+}
+
+void vision_tracker_init(vision_tracker_s_t* tracker) {
+	memset(tracker, 0, sizeof(*tracker));
+	tracker->next_id = 1;
+}
+
+void vision_tracker_update(vision_tracker_s_t* tracker, const vision_object_s_t* objects, uint32_t object_count,
+                           uint32_t frame_time, uint32_t now) {
+	if (object_count > TRACKER_MAX_OBJECTS) object_count = TRACKER_MAX_OBJECTS;
+
+	uint32_t dt_ms = tracker->count ? frame_time - tracker->last_frame : 0;
+	if (dt_ms > VISION_TRACKER_MAX_DT) dt_ms = VISION_TRACKER_MAX_DT;
+	float dt = dt_ms / 1000.0f;
+	tracker->last_frame = frame_time;
+
+	for (uint8_t t = 0; t < tracker->count; t++) {
+		_axis_predict(&tracker->entries[t].x, dt);
+		_axis_predict(&tracker->entries[t].y, dt);
+	}
+
+	// Squared distances of every gated pair, negative if the pair can't match
+	float dist[VISION_TRACKER_MAX_TRACKS][TRACKER_MAX_OBJECTS];
+	const float gate = VISION_TRACKER_GATE * VISION_TRACKER_GATE;
+	for (uint8_t t = 0; t < tracker->count; t++) {
+		vision_tracker_entry_s_t* entry = &tracker->entries[t];
+		for (uint32_t o = 0; o < object_count; o++) {
+			float dx = objects[o].x_middle_coord - entry->x.pos;
+			float dy = objects[o].y_middle_coord - entry->y.pos;
+			float d = dx * dx + dy * dy;
+			dist[t][o] = (objects[o].signature == entry->track.signature && d <= gate) ? d : -1;
+		}
+	}
+
+	uint8_t track_match[VISION_TRACKER_MAX_TRACKS];
+	uint8_t object_match[TRACKER_MAX_OBJECTS];
+	memset(track_match, TRACKER_NO_MATCH, sizeof(track_match));
+	memset(object_match, TRACKER_NO_MATCH, sizeof(object_match));
+	while (true) {
+		float best = -1;
+		uint8_t best_t = 0, best_o = 0;
+		for (uint8_t t = 0; t < tracker->count; t++) {
+			if (track_match[t] != TRACKER_NO_MATCH) continue;
+			for (uint32_t o = 0; o < object_count; o++) {
+				if (object_match[o] != TRACKER_NO_MATCH || dist[t][o] < 0) continue;
+				if (best < 0 || dist[t][o] < best) {
+					best = dist[t][o];
+					best_t = t;
+					best_o = o;
+				}
+			}
+		}
+		if (best < 0) break;
+		track_match[best_t] = best_o;
+		object_match[best_o] = best_t;
+	}
+
+	// Correct matched tracks and drop the ones which have been lost for too long,
+	// keeping the survivors in order of age
+	uint8_t kept = 0;
+	for (uint8_t t = 0; t < tracker->count; t++) {
+		vision_tracker_entry_s_t* entry = &tracker->entries[t];
+		if (track_match[t] != TRACKER_NO_MATCH) {
+			const vision_object_s_t* object = &objects[track_match[t]];
+			_axis_correct(&entry->x, object->x_middle_coord);
+			_axis_correct(&entry->y, object->y_middle_coord);
+			entry->track.width = object->width;
+			entry->track.height = object->height;
+			entry->track.missed = 0;
+			if (entry->track.hits < UINT16_MAX) entry->track.hits++;
+		} else if (++entry->track.missed > VISION_TRACKER_MAX_MISSED) {
+			continue;
+		}
+		_entry_publish(entry, now);
+		if (kept != t) tracker->entries[kept] = *entry;
+		kept++;
+	}
+	tracker->count = kept;
+
+	// Start tracks for the objects which didn't match any, largest first since
+	// the sensor reports objects in order of size
+	for (uint32_t o = 0; o < object_count && tracker->count < VISION_TRACKER_MAX_TRACKS; o++) {
+		if (object_match[o] != TRACKER_NO_MATCH || objects[o].signature == VISION_OBJECT_ERR_SIG) continue;
+		vision_tracker_entry_s_t* entry = &tracker->entries[tracker->count++];
+		memset(entry, 0, sizeof(*entry));
+		entry->track.id = tracker->next_id++;
+		entry->track.signature = objects[o].signature;
+		entry->track.width = objects[o].width;
+		entry->track.height = objects[o].height;
+		entry->track.hits = 1;
+		_axis_init(&entry->x, objects[o].x_middle_coord);
+		_axis_init(&entry->y, objects[o].y_middle_coord);
+		_entry_publish(entry, now);
+	}
+}
@@ -0,0 +1,553 @@
+/*
+ * FreeRTOS Kernel V10.0.1
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * An implementation of kmalloc() and kfree() with a two-level segregated fit
+ * (TLSF) allocator, used instead of heap_4.c when configUSE_TLSF_HEAP is 1.
+ *
+ * Free blocks are kept in one list per size class.  The first level splits
+ * sizes by power of two, and the second level splits each power of two into
+ * heapSL_COUNT equal ranges.  Two levels of bitmaps record which lists are not
+ * empty, so finding a list with a large enough block takes a couple of bit
+ * scans rather than a walk of every free block, and allocating and freeing take
+ * the same time however fragmented the heap is.  Freed blocks are merged with
+ * the blocks physically either side of them, like heap_4.c does.
+ *
+ * Requests are rounded up to the next size class boundary before searching, so
+ * any block in the list found is large enough (good fit rather than best fit).
+ * That leaves the heap more fragmented than heap_4.c's address ordered first fit
+ * under the same load; src/tests/heap_bench.c measures both.
+ */
+#include <stdlib.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
+	#error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
+#endif
+
+#if( configUSE_TLSF_HEAP == 1 )
+
+/* Each power of two is split into 2^heapSL_COUNT_LOG2 size classes. */
+#define heapSL_COUNT_LOG2		( 4 )
+#define heapSL_COUNT			( 1U << heapSL_COUNT_LOG2 )
+
+/* Sizes are multiples of portBYTE_ALIGNMENT, so blocks smaller than
+heapSMALL_BLOCK_SIZE all go in the first level's lists, one per size. */
+#define heapALIGNMENT_LOG2		( 3 )
+#define heapFL_SHIFT			( heapSL_COUNT_LOG2 + heapALIGNMENT_LOG2 )
+#define heapSMALL_BLOCK_SIZE	( ( size_t ) 1 << heapFL_SHIFT )
+
+/* Blocks can be up to 2^heapFL_INDEX_MAX bytes. */
+#define heapFL_INDEX_MAX		( 21 )
+#define heapFL_COUNT			( heapFL_INDEX_MAX - heapFL_SHIFT + 1 )
+
+#if( portBYTE_ALIGNMENT != ( 1 << heapALIGNMENT_LOG2 ) )
+	#error heapALIGNMENT_LOG2 must match portBYTE_ALIGNMENT
+#endif
+
+#if( configTOTAL_HEAP_SIZE > ( 1UL << heapFL_INDEX_MAX ) )
+	#error configTOTAL_HEAP_SIZE is too large for heapFL_INDEX_MAX
+#endif
+
+/* Set in xBlockSize while a block is free. */
+#define heapBLOCK_FREE_BIT		( ( size_t ) 1 )
+
+/* Allocate the memory for the heap. */
+#if( configAPPLICATION_ALLOCATED_HEAP == 1 )
+	/* The application writer has already defined the array used for the RTOS
+	heap - probably so it can be placed in a special segment or address. */
+	extern uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+#else
+	static uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+#endif /* configAPPLICATION_ALLOCATED_HEAP */
+
+/* Every block starts with this header.  The free list links are only there
+while the block is free - otherwise they are the first bytes given to the
+application. */
+typedef struct A_TLSF_BLOCK
+{
+	struct A_TLSF_BLOCK *pxPrevPhysBlock;	/*<< The block physically before this one, or NULL. */
+	size_t xBlockSize;						/*<< The size of the block, not counting its header, and heapBLOCK_FREE_BIT. */
+	struct A_TLSF_BLOCK *pxNextFreeBlock;	/*<< The next block in this block's free list. */
+	struct A_TLSF_BLOCK *pxPrevFreeBlock;	/*<< The previous block in this block's free list. */
+} TLSFBlock_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Sets up the single free block and the end marker the first time kmalloc()
+ * is called.
+ */
+static void prvHeapInit( void );
+
+/*
+ * Finds the size class a block of xSize bytes belongs in.
+ */
+static void prvMappingInsert( size_t xSize, uint32_t *pulFL, uint32_t *pulSL );
+
+/*
+ * Finds a free block of at least xSize bytes and takes it out of its free list,
+ * or returns NULL if there is none.
+ */
+static TLSFBlock_t *prvTakeSuitableBlock( size_t xSize );
+
+static void prvInsertFreeBlock( TLSFBlock_t *pxBlock );
+static void prvRemoveFreeBlock( TLSFBlock_t *pxBlock );
+
+/*-----------------------------------------------------------*/
+
+/* The header of a block, rounded up to keep the memory after it aligned. */
+#define heapHEADER_SIZE			( ( offsetof( TLSFBlock_t, pxNextFreeBlock ) + portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ) )
+
+/* A free block must have room for its free list links. */
+#define heapMINIMUM_BLOCK_SIZE	( ( ( 2 * sizeof( TLSFBlock_t * ) ) + portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ) )
+
+#define heapBLOCK_SIZE( pxBlock )		( ( pxBlock )->xBlockSize & ~heapBLOCK_FREE_BIT )
+#define heapBLOCK_IS_FREE( pxBlock )	( ( ( pxBlock )->xBlockSize & heapBLOCK_FREE_BIT ) != 0 )
+#define heapNEXT_PHYS_BLOCK( pxBlock )	( ( TLSFBlock_t * ) ( ( ( uint8_t * ) ( pxBlock ) ) + heapHEADER_SIZE + heapBLOCK_SIZE( pxBlock ) ) )
+
+/* Which first level lists, and which second level lists of each first level,
+hold free blocks. */
+static uint32_t ulFLBitmap = 0;
+static uint32_t ulSLBitmap[ heapFL_COUNT ];
+static TLSFBlock_t *pxFreeLists[ heapFL_COUNT ][ heapSL_COUNT ];
+
+/* Marks the end of the heap.  It is never free, so blocks are never merged
+with it. */
+static TLSFBlock_t *pxEnd = NULL;
+
+/* Keeps track of the number of free bytes remaining, but says nothing about
+fragmentation. */
+static size_t xFreeBytesRemaining = 0U;
+static size_t xMinimumEverFreeBytesRemaining = 0U;
+static size_t xNumberOfSuccessfulAllocations = 0;
+static size_t xNumberOfSuccessfulFrees = 0;
+
+/*-----------------------------------------------------------*/
+
+void *kmalloc( size_t xWantedSize )
+{
+TLSFBlock_t *pxBlock, *pxNewBlock;
+void *pvReturn = NULL;
+
+	rtos_suspend_all();
+	{
+		/* If this is the first call to malloc then the heap will require
+		initialisation to setup the free block. */
+		if( pxEnd == NULL )
+		{
+			prvHeapInit();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		if( ( xWantedSize > 0 ) && ( xWantedSize <= xFreeBytesRemaining ) )
+		{
+			/* Ensure that blocks are always aligned to the required number of
+			bytes, and can hold the free list links once they are freed. */
+			xWantedSize = ( xWantedSize + portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+			if( xWantedSize < heapMINIMUM_BLOCK_SIZE )
+			{
+				xWantedSize = heapMINIMUM_BLOCK_SIZE;
+			}
+
+			pxBlock = prvTakeSuitableBlock( xWantedSize );
+			if( pxBlock != NULL )
+			{
+				/* If the block is larger than required and what is left over
+				can be a block of its own, it is split into two. */
+				if( ( heapBLOCK_SIZE( pxBlock ) - xWantedSize ) >= ( heapHEADER_SIZE + heapMINIMUM_BLOCK_SIZE ) )
+				{
+					pxNewBlock = ( TLSFBlock_t * ) ( ( ( uint8_t * ) pxBlock ) + heapHEADER_SIZE + xWantedSize );
+					pxNewBlock->pxPrevPhysBlock = pxBlock;
+					pxNewBlock->xBlockSize = ( heapBLOCK_SIZE( pxBlock ) - xWantedSize - heapHEADER_SIZE ) | heapBLOCK_FREE_BIT;
+					heapNEXT_PHYS_BLOCK( pxNewBlock )->pxPrevPhysBlock = pxNewBlock;
+					pxBlock->xBlockSize = xWantedSize;
+					prvInsertFreeBlock( pxNewBlock );
+				}
+				else
+				{
+					/* The block is handed out whole. */
+					pxBlock->xBlockSize &= ~heapBLOCK_FREE_BIT;
+				}
+
+				xFreeBytesRemaining -= heapHEADER_SIZE + pxBlock->xBlockSize;
+
+				if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
+				{
+					xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				pvReturn = ( void * ) ( ( ( uint8_t * ) pxBlock ) + heapHEADER_SIZE );
+				xNumberOfSuccessfulAllocations++;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		traceMALLOC( pvReturn, xWantedSize );
+	}
+	( void ) rtos_resume_all();
+
+	#if( configUSE_MALLOC_FAILED_HOOK == 1 )
+	{
+		if( pvReturn == NULL )
+		{
+			extern void vApplicationMallocFailedHook( void );
+			vApplicationMallocFailedHook();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif
+
+	configASSERT( ( ( ( size_t ) pvReturn ) & ( size_t ) portBYTE_ALIGNMENT_MASK ) == 0 );
+	return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void kfree( void *pv )
+{
+TLSFBlock_t *pxBlock, *pxNeighbour;
+
+	if( pv != NULL )
+	{
+		/* The memory being freed will have a TLSFBlock_t header immediately
+		before it. */
+		pxBlock = ( TLSFBlock_t * ) ( ( ( uint8_t * ) pv ) - heapHEADER_SIZE );
+
+		/* Check the block is actually allocated. */
+		configASSERT( !heapBLOCK_IS_FREE( pxBlock ) );
+
+		if( !heapBLOCK_IS_FREE( pxBlock ) )
+		{
+			rtos_suspend_all();
+			{
+				xFreeBytesRemaining += heapHEADER_SIZE + pxBlock->xBlockSize;
+				traceFREE( pv, pxBlock->xBlockSize );
+
+				/* Merge with the block after this one if it is free. */
+				pxNeighbour = heapNEXT_PHYS_BLOCK( pxBlock );
+				if( heapBLOCK_IS_FREE( pxNeighbour ) )
+				{
+					prvRemoveFreeBlock( pxNeighbour );
+					pxBlock->xBlockSize += heapHEADER_SIZE + heapBLOCK_SIZE( pxNeighbour );
+					heapNEXT_PHYS_BLOCK( pxBlock )->pxPrevPhysBlock = pxBlock;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				/* Merge with the block before this one if it is free. */
+				pxNeighbour = pxBlock->pxPrevPhysBlock;
+				if( ( pxNeighbour != NULL ) && heapBLOCK_IS_FREE( pxNeighbour ) )
+				{
+					prvRemoveFreeBlock( pxNeighbour );
+					pxNeighbour->xBlockSize += heapHEADER_SIZE + pxBlock->xBlockSize;
+					pxBlock = pxNeighbour;
+					heapNEXT_PHYS_BLOCK( pxBlock )->pxPrevPhysBlock = pxBlock;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				pxBlock->xBlockSize |= heapBLOCK_FREE_BIT;
+				prvInsertFreeBlock( pxBlock );
+				xNumberOfSuccessfulFrees++;
+			}
+			( void ) rtos_resume_all();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetFreeHeapSize( void )
+{
+	return xFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetMinimumEverFreeHeapSize( void )
+{
+	return xMinimumEverFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetLargestFreeBlockSize( void )
+{
+TLSFBlock_t *pxBlock;
+uint32_t ulFL, ulSL;
+size_t xLargest = 0;
+
+	rtos_suspend_all();
+	{
+		/* The largest block is in the highest non-empty list, but that list
+		holds a range of sizes. */
+		if( ulFLBitmap != 0 )
+		{
+			ulFL = 31 - __builtin_clz( ulFLBitmap );
+			ulSL = 31 - __builtin_clz( ulSLBitmap[ ulFL ] );
+			for( pxBlock = pxFreeLists[ ulFL ][ ulSL ]; pxBlock != NULL; pxBlock = pxBlock->pxNextFreeBlock )
+			{
+				if( heapBLOCK_SIZE( pxBlock ) > xLargest )
+				{
+					xLargest = heapBLOCK_SIZE( pxBlock );
+				}
+			}
+		}
+	}
+	( void ) rtos_resume_all();
+
+	return xLargest;
+}
+/*-----------------------------------------------------------*/
+
+void vPortGetHeapStats( HeapStats_t *pxHeapStats )
+{
+TLSFBlock_t *pxBlock;
+uint32_t ulFL, ulSL;
+size_t xBlocks = 0, xMaxSize = 0, xMinSize = portMAX_DELAY; /* portMAX_DELAY used as a portable way of getting the maximum value. */
+
+	rtos_suspend_all();
+	{
+		/* Unlike kmalloc() this has to look at every free list, so it takes time
+		in proportion to the number of free blocks. */
+		for( ulFL = 0; ulFL < heapFL_COUNT; ulFL++ )
+		{
+			for( ulSL = 0; ulSL < heapSL_COUNT; ulSL++ )
+			{
+				for( pxBlock = pxFreeLists[ ulFL ][ ulSL ]; pxBlock != NULL; pxBlock = pxBlock->pxNextFreeBlock )
+				{
+					xBlocks++;
+
+					if( heapBLOCK_SIZE( pxBlock ) > xMaxSize )
+					{
+						xMaxSize = heapBLOCK_SIZE( pxBlock );
+					}
+
+					if( heapBLOCK_SIZE( pxBlock ) < xMinSize )
+					{
+						xMinSize = heapBLOCK_SIZE( pxBlock );
+					}
+				}
+			}
+		}
+
+		pxHeapStats->xAvailableHeapSpaceInBytes = xFreeBytesRemaining;
+		pxHeapStats->xMinimumEverFreeBytesRemaining = xMinimumEverFreeBytesRemaining;
+		pxHeapStats->xNumberOfSuccessfulAllocations = xNumberOfSuccessfulAllocations;
+		pxHeapStats->xNumberOfSuccessfulFrees = xNumberOfSuccessfulFrees;
+	}
+	( void ) rtos_resume_all();
+
+	pxHeapStats->xNumberOfFreeBlocks = xBlocks;
+	pxHeapStats->xSizeOfLargestFreeBlockInBytes = xMaxSize;
+	pxHeapStats->xSizeOfSmallestFreeBlockInBytes = xBlocks ? xMinSize : 0;
+}
+/*-----------------------------------------------------------*/
+
+void vPortInitialiseBlocks( void )
+{
+	/* This just exists to keep the linker quiet. */
+}
+/*-----------------------------------------------------------*/
+
+static void prvHeapInit( void )
+{
+TLSFBlock_t *pxFirstFreeBlock;
+size_t uxAddress, uxEndAddress;
+
+	/* Ensure the heap starts and ends on a correctly aligned boundary. */
+	uxAddress = ( ( size_t ) ucHeap + portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+	uxEndAddress = ( ( size_t ) ucHeap + configTOTAL_HEAP_SIZE ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+	/* pxEnd is a block with no space of its own at the very end of the heap. */
+	pxEnd = ( TLSFBlock_t * ) ( uxEndAddress - heapHEADER_SIZE );
+
+	/* To start with there is a single free block that is sized to take up the
+	entire heap space, minus the space taken by the headers. */
+	pxFirstFreeBlock = ( TLSFBlock_t * ) uxAddress;
+	pxFirstFreeBlock->pxPrevPhysBlock = NULL;
+	pxFirstFreeBlock->xBlockSize = ( ( size_t ) pxEnd - uxAddress - heapHEADER_SIZE ) | heapBLOCK_FREE_BIT;
+
+	pxEnd->pxPrevPhysBlock = pxFirstFreeBlock;
+	pxEnd->xBlockSize = 0;
+
+	prvInsertFreeBlock( pxFirstFreeBlock );
+
+	xMinimumEverFreeBytesRemaining = heapHEADER_SIZE + heapBLOCK_SIZE( pxFirstFreeBlock );
+	xFreeBytesRemaining = xMinimumEverFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+static void prvMappingInsert( size_t xSize, uint32_t *pulFL, uint32_t *pulSL )
+{
+uint32_t ulFL;
+
+	if( xSize < heapSMALL_BLOCK_SIZE )
+	{
+		*pulFL = 0;
+		*pulSL = ( uint32_t ) ( xSize >> heapALIGNMENT_LOG2 );
+	}
+	else
+	{
+		/* The top set bit picks the power of two, and the heapSL_COUNT_LOG2
+		bits below it pick the range within it. */
+		ulFL = 31 - __builtin_clz( ( uint32_t ) xSize );
+		*pulSL = ( uint32_t ) ( xSize >> ( ulFL - heapSL_COUNT_LOG2 ) ) ^ heapSL_COUNT;
+		*pulFL = ulFL - ( heapFL_SHIFT - 1 );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static TLSFBlock_t *prvTakeSuitableBlock( size_t xSize )
+{
+TLSFBlock_t *pxBlock;
+uint32_t ulFL, ulSL, ulMap;
+
+	/* Round the size up to the start of the next size class, so that every
+	block in the class found is large enough. */
+	if( xSize >= heapSMALL_BLOCK_SIZE )
+	{
+		xSize += ( ( size_t ) 1 << ( ( 31 - __builtin_clz( ( uint32_t ) xSize ) ) - heapSL_COUNT_LOG2 ) ) - 1;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	prvMappingInsert( xSize, &ulFL, &ulSL );
+	if( ulFL >= heapFL_COUNT )
+	{
+		return NULL;
+	}
+
+	/* Look for a non-empty list in the same power of two first, then for the
+	smallest non-empty list of any larger power of two. */
+	ulMap = ulSLBitmap[ ulFL ] & ( ~0UL << ulSL );
+	if( ulMap == 0 )
+	{
+		ulMap = ( ulFL + 1 < 32 ) ? ( ulFLBitmap & ( ~0UL << ( ulFL + 1 ) ) ) : 0;
+		if( ulMap == 0 )
+		{
+			return NULL;
+		}
+		ulFL = __builtin_ctz( ulMap );
+		ulMap = ulSLBitmap[ ulFL ];
+	}
+	ulSL = __builtin_ctz( ulMap );
+
+	pxBlock = pxFreeLists[ ulFL ][ ulSL ];
+	prvRemoveFreeBlock( pxBlock );
+	return pxBlock;
+}
+/*-----------------------------------------------------------*/
+
+static void prvInsertFreeBlock( TLSFBlock_t *pxBlock )
+{
+uint32_t ulFL, ulSL;
+
+	prvMappingInsert( heapBLOCK_SIZE( pxBlock ), &ulFL, &ulSL );
+	pxBlock->pxPrevFreeBlock = NULL;
+	pxBlock->pxNextFreeBlock = pxFreeLists[ ulFL ][ ulSL ];
+	if( pxBlock->pxNextFreeBlock != NULL )
+	{
+		pxBlock->pxNextFreeBlock->pxPrevFreeBlock = pxBlock;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+	pxFreeLists[ ulFL ][ ulSL ] = pxBlock;
+	ulFLBitmap |= 1UL << ulFL;
+	ulSLBitmap[ ulFL ] |= 1UL << ulSL;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRemoveFreeBlock( TLSFBlock_t *pxBlock )
+{
+uint32_t ulFL, ulSL;
+
+	prvMappingInsert( heapBLOCK_SIZE( pxBlock ), &ulFL, &ulSL );
+	if( pxBlock->pxPrevFreeBlock != NULL )
+	{
+		pxBlock->pxPrevFreeBlock->pxNextFreeBlock = pxBlock->pxNextFreeBlock;
+	}
+	else
+	{
+		pxFreeLists[ ulFL ][ ulSL ] = pxBlock->pxNextFreeBlock;
+		if( pxBlock->pxNextFreeBlock == NULL )
+		{
+			/* The list is now empty. */
+			ulSLBitmap[ ulFL ] &= ~( 1UL << ulSL );
+			if( ulSLBitmap[ ulFL ] == 0 )
+			{
+				ulFLBitmap &= ~( 1UL << ulFL );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	if( pxBlock->pxNextFreeBlock != NULL )
+	{
+		pxBlock->pxNextFreeBlock->pxPrevFreeBlock = pxBlock->pxPrevFreeBlock;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+}
+
+#endif /* configUSE_TLSF_HEAP */
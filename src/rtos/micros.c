@@ -0,0 +1,51 @@
+/**
+ * \file rtos/micros.c
+ *
+ * Microsecond time base and delays.
+ *
+ * The RTOS tick is a millisecond, so anything finer than that comes from the
+ * brain's high resolution timer instead. Microsecond delays sleep through as
+ * many ticks as they can and busy-wait on that timer for the rest.
+ *
+ * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "kapi.h"
+#include "v5_api.h"
+
+#define MICROS_PER_TICK (portTICK_PERIOD_MS * 1000)
+
+// How long before the target time a delay stops sleeping, in case the task is
+// woken up a little after the tick it asked for
+#define MICROS_SPIN_MARGIN 100
+
+uint64_t micros(void) {
+	return vexSystemHighResTimeGet();
+}
+
+static void _delay_until_micros(const uint64_t target) {
+	uint64_t now = micros();
+	// The first sleep ends somewhere in the tick it was asked for, since it starts
+	// partway through one. Any later sleep starts right after a tick and lasts
+	// whole ticks, so at most MICROS_PER_TICK + MICROS_SPIN_MARGIN is left over.
+	while (now + MICROS_PER_TICK + MICROS_SPIN_MARGIN <= target) {
+		task_delay((uint32_t)((target - now - MICROS_SPIN_MARGIN) / MICROS_PER_TICK) * portTICK_PERIOD_MS);
+		now = micros();
+	}
+	while (micros() < target)
+		;
+}
+
+void task_delay_micros(const uint32_t microseconds) {
+	_delay_until_micros(micros() + microseconds);
+}
+
+void task_delay_until_micros(uint64_t* const prev_time, const uint32_t delta) {
+	*prev_time += delta;
+	_delay_until_micros(*prev_time);
+}
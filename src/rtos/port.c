@@ -205,6 +205,12 @@ volatile uint32_t ulPortYieldRequired = pdFALSE;
 if the nesting depth is 0. */
 volatile uint32_t ulPortInterruptNesting = 0UL;
 
+/* While ulPortSaveInterruptedContext is non-zero, the outermost interrupt saves
+r4-r11, sp, lr, pc and cpsr of the code it interrupted into
+ulPortInterruptedContext, for the sampling profiler (system/profiler.c). */
+volatile uint32_t ulPortSaveInterruptedContext = pdFALSE;
+volatile uint32_t ulPortInterruptedContext[ 12 ];
+
 /* Used in the asm file. */
 __attribute__(( used )) const uint32_t ulICCIAR = portICCIAR_INTERRUPT_ACKNOWLEDGE_REGISTER_ADDRESS;
 __attribute__(( used )) const uint32_t ulICCEOIR = portICCEOIR_END_OF_INTERRUPT_REGISTER_ADDRESS;
@@ -92,6 +92,14 @@ using namespace pros::c;
     task_delay_until(prev_time, delta);
   }
 
+  void Task::delay_micros(const std::uint32_t microseconds) {
+    task_delay_micros(microseconds);
+  }
+
+  void Task::delay_until_micros(std::uint64_t* const prev_time, const std::uint32_t delta) {
+    task_delay_until_micros(prev_time, delta);
+  }
+
   std::uint32_t Task::get_count(void) {
     return task_get_count();
   }
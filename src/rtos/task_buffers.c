@@ -0,0 +1,48 @@
+/**
+ * \file rtos/task_buffers.c
+ *
+ * Tasks in memory provided by the caller
+ *
+ * The public face of task_create_static. The kernel only reuses the buffers of
+ * its own static tasks by creating a new task in them, which first finishes
+ * deleting the old one if the idle task hasn't yet. Buffers given to
+ * task_create_buffered can go out of scope instead, so task_release_buffers
+ * finishes the deletion on its own.
+ *
+ * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <errno.h>
+
+#include "kapi.h"
+#include "rtos/tcb.h"
+
+// NOTE: can't just include task.h because of redefinition that goes on in kapi
+//       include chain, so we just prototype what we need here
+void task_finish_termination(TCB_t* pxTCB);
+
+_Static_assert(sizeof(static_task_s_t) <= sizeof(task_buffer_s_t), "TASK_BUFFER_SIZE is too small for a TCB");
+_Static_assert(_Alignof(static_task_s_t) <= _Alignof(task_buffer_s_t), "task_buffer_s_t is not aligned for a TCB");
+
+task_t task_create_buffered(task_fn_t function, void* const parameters, uint32_t prio, const uint16_t stack_depth,
+                            const char* const name, uint32_t* const stack_buffer, task_buffer_s_t* const task_buffer) {
+	if (!stack_depth || !stack_buffer || !task_buffer) {
+		errno = EINVAL;
+		return NULL;
+	}
+	return task_create_static(function, parameters, prio, stack_depth, name, stack_buffer,
+	                          (static_task_s_t*)task_buffer);
+}
+
+void task_release_buffers(task_t task) {
+	if (!task) return;
+	if (task_get_state(task) != E_TASK_STATE_DELETED) {
+		task_delete(task);
+	}
+	task_finish_termination(task);
+}
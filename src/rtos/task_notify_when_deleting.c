@@ -22,6 +22,14 @@ struct notify_delete_action {
   notify_action_e_t notify_action;
 };
 
+// Actions come from this pool, and from the kernel heap once it's used up
+#define ACTION_POOL_COUNT 16
+
+static static_pool_s_t action_pool_buf;
+static uint8_t action_pool_storage[POOL_STORAGE_SIZE(sizeof(struct notify_delete_action), ACTION_POOL_COUNT)]
+    __attribute__((aligned(8)));
+static pool_t action_pool;
+
 struct _find_task_args {
   task_t task;
   struct notify_delete_action* found_action;
@@ -48,6 +56,21 @@ static struct notify_delete_action* _find_task(linked_list_s_t* ll, task_t task)
 
 void task_notify_when_deleting_init() {
   task_notify_when_deleting_mutex = mutex_create_static(&task_notify_when_deleting_mutex_buf);
+  action_pool = pool_create_static(sizeof(struct notify_delete_action), ACTION_POOL_COUNT, action_pool_storage,
+                                   &action_pool_buf);
+}
+
+static struct notify_delete_action* _action_alloc(void) {
+  struct notify_delete_action* action = pool_alloc(action_pool);
+  return action ? action : (struct notify_delete_action*)kmalloc(sizeof(struct notify_delete_action));
+}
+
+static void _action_free(struct notify_delete_action* action) {
+  if (pool_contains(action_pool, action)) {
+    pool_free(action_pool, action);
+  } else {
+    kfree(action);
+  }
 }
 
 void task_notify_when_deleting(task_t target_task, task_t task_to_notify,
@@ -100,7 +123,7 @@ void task_notify_when_deleting(task_t target_task, task_t task_to_notify,
 
     // action wasn't found, so add it to the linked list
     if (action == NULL) {
-      action = (struct notify_delete_action*)kmalloc(sizeof(struct notify_delete_action));
+      action = _action_alloc();
       if (action != NULL) {
         linked_list_prepend_data(target_ll, action);
       }
@@ -148,7 +171,7 @@ static void delete_hook_cb(ll_node_s_t* node, void* ignore) {
   struct notify_delete_action* action = node->payload.data;
   if (action != NULL) {
     task_notify_ext(action->task_to_notify, action->value, action->notify_action, NULL);
-    kfree(action);
+    _action_free(action);
     node->payload.data = NULL;
   }
 }
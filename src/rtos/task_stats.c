@@ -0,0 +1,76 @@
+/**
+ * \file rtos/task_stats.c
+ *
+ * Per-task run time statistics.
+ *
+ * The scheduler already adds up how long each task runs for (FreeRTOS's run
+ * time stats) and how often it is switched in. This reads those counters and
+ * the stack high water marks for every task in one go, with the scheduler
+ * suspended so that no task can be deleted and freed partway through.
+ *
+ * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include "kapi.h"
+#include "v5_api.h"
+
+// NOTE: can't just include task.h because of redefinition that goes on in kapi
+//       include chain, so we just prototype what we need here
+void vTaskForEachTask(void (*pxCallback)(task_t, void*), void* pvArg);
+uint32_t uxTaskGetStackHighWaterMark(task_t xTask);
+
+#include "rtos/tcb.h"
+
+struct _get_stats_args {
+	task_runtime_stats_s_t* stats;
+	uint32_t count;
+	uint32_t found;
+};
+
+// Called with the scheduler suspended
+static void _get_stats_cb(task_t task, void* extra) {
+	struct _get_stats_args* args = extra;
+	if (args->found < args->count) {
+		TCB_t* tcb = (TCB_t*)task;
+		task_runtime_stats_s_t* stats = &args->stats[args->found];
+		stats->task = task;
+		strncpy(stats->name, tcb->pcTaskName, sizeof(stats->name));
+		stats->name[sizeof(stats->name) - 1] = '\0';
+		stats->state = task_get_state(task);
+		stats->priority = tcb->uxPriority;
+		stats->run_time = tcb->ulRunTimeCounter;
+		stats->context_switches = tcb->ulSwitchInCount;
+		stats->stack_free_min = uxTaskGetStackHighWaterMark(task);
+	}
+	args->found++;
+}
+
+int32_t task_get_runtime_stats(task_runtime_stats_s_t* const stats, const uint32_t count,
+                               uint32_t* const total_run_time) {
+	if (!stats) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	struct _get_stats_args args = {.stats = stats, .count = count, .found = 0};
+
+	// Suspending the scheduler here as well makes total_run_time agree with the
+	// tasks' counters, since no task can run in between
+	rtos_suspend_all();
+	vTaskForEachTask(_get_stats_cb, &args);
+	if (total_run_time) *total_run_time = portGET_RUN_TIME_COUNTER_VALUE();
+	rtos_resume_all();
+
+	if (args.found > count) {
+		errno = ENOMEM;
+		return PROS_ERR;
+	}
+	return args.found;
+}
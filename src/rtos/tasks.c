@@ -280,6 +280,7 @@ static List_t xPendingReadyList;						/*< Tasks that have been readied while the
 
 	static List_t xTasksWaitingTermination;				/*< Tasks that have been deleted - but their memory not yet freed. */
 	static volatile uint32_t uxDeletedTasksWaitingCleanUp = ( uint32_t ) 0U;
+	static TCB_t * volatile pxTCBBeingCleanedUp = NULL;	/*< Task the idle task has taken off xTasksWaitingTermination but is still deleting. */
 
 #endif
 
@@ -772,6 +773,7 @@ uint32_t x;
 	#if ( configGENERATE_RUN_TIME_STATS == 1 )
 	{
 		pxNewTCB->ulRunTimeCounter = 0UL;
+		pxNewTCB->ulSwitchInCount = 0UL;
 	}
 	#endif /* configGENERATE_RUN_TIME_STATS */
 
@@ -912,8 +914,16 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 	{
 	TCB_t *pxTCB;
 
+		/* Wait for the task to leave newlib's allocator, and keep it out until
+		it's gone. */
+		bool malloc_delete_lock(task_t);
+		void malloc_delete_unlock(bool);
+		bool malloc_locked = malloc_delete_lock(task);
+
 		void task_notify_when_deleting_hook(task_t);
 		task_notify_when_deleting_hook(task);
+		void registry_task_delete_hook(task_t);
+		registry_task_delete_hook(task);
 
 		taskENTER_CRITICAL();
 		{
@@ -982,6 +992,8 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 		}
 		taskEXIT_CRITICAL();
 
+		malloc_delete_unlock( malloc_locked );
+
 		/* Force a reschedule if it is the currently running task that has just
 		been deleted. */
 		if( xSchedulerRunning != pdFALSE )
@@ -998,10 +1010,13 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 		}
 	}
 
-  // Check if a task is awaiting termination and finish termination if it is
+  // Check if a task is awaiting termination and finish termination if it is.
+  // If the idle task is already deleting it, wait for the idle task to finish,
+  // since prvDeleteTCB runs with preemption enabled and still uses the TCB
 	void task_finish_termination(TCB_t* pxTCB)
 	{
 			uint8_t doCleanup = 0;
+			uint8_t doWait = 0;
 
 			taskENTER_CRITICAL();
 			{
@@ -1017,6 +1032,7 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 					doCleanup = 1;
 				}
 			}
+			doWait = (pxTCBBeingCleanedUp == pxTCB);
 			}
 			taskEXIT_CRITICAL();
 
@@ -1024,6 +1040,14 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 			{
 				prvDeleteTCB(pxTCB);
 			}
+			else if (doWait == 1)
+			{
+				/* Blocking lets the idle task run whatever the caller's priority. */
+				while (pxTCBBeingCleanedUp == pxTCB)
+				{
+					task_delay(1);
+				}
+			}
 	}
 #endif /* INCLUDE_vTaskDelete */
 /*-----------------------------------------------------------*/
@@ -2313,6 +2337,58 @@ TCB_t *pxTCB;
 #endif /* configUSE_TRACE_FACILITY */
 /*----------------------------------------------------------*/
 
+#if ( configUSE_TRACE_FACILITY == 1 )
+
+	static void prvForEachTaskWithinSingleList( List_t *pxList, void ( *pxCallback )( task_t, void * ), void *pvArg )
+	{
+	configLIST_VOLATILE TCB_t *pxNextTCB, *pxFirstTCB;
+
+		if( listCURRENT_LIST_LENGTH( pxList ) > ( uint32_t ) 0 )
+		{
+			listGET_OWNER_OF_NEXT_ENTRY( pxFirstTCB, pxList );
+			do
+			{
+				listGET_OWNER_OF_NEXT_ENTRY( pxNextTCB, pxList );
+				pxCallback( ( task_t ) pxNextTCB, pvArg );
+			} while( pxNextTCB != pxFirstTCB );
+		}
+	}
+
+	void vTaskForEachTask( void ( *pxCallback )( task_t, void * ), void *pvArg )
+	{
+	uint32_t uxQueue = configMAX_PRIORITIES;
+
+		rtos_suspend_all();
+		{
+			/* The same lists as uxTaskGetSystemState(), without the cost of
+			filling in a TaskStatus_t (and scanning the stack) for each task. */
+			do
+			{
+				uxQueue--;
+				prvForEachTaskWithinSingleList( &( pxReadyTasksLists[ uxQueue ] ), pxCallback, pvArg );
+			} while( uxQueue > ( uint32_t ) tskIDLE_PRIORITY );
+
+			prvForEachTaskWithinSingleList( ( List_t * ) pxDelayedTaskList, pxCallback, pvArg );
+			prvForEachTaskWithinSingleList( ( List_t * ) pxOverflowDelayedTaskList, pxCallback, pvArg );
+
+			#if( INCLUDE_vTaskDelete == 1 )
+			{
+				prvForEachTaskWithinSingleList( &xTasksWaitingTermination, pxCallback, pvArg );
+			}
+			#endif
+
+			#if ( INCLUDE_vTaskSuspend == 1 )
+			{
+				prvForEachTaskWithinSingleList( &xSuspendedTaskList, pxCallback, pvArg );
+			}
+			#endif
+		}
+		( void ) rtos_resume_all();
+	}
+
+#endif /* configUSE_TRACE_FACILITY */
+/*----------------------------------------------------------*/
+
 #if ( INCLUDE_xTaskGetIdleTaskHandle == 1 )
 
 	task_t xTaskGetIdleTaskHandle( void )
@@ -2693,6 +2769,10 @@ void vTaskSwitchContext( void )
 	}
 	else
 	{
+		#if ( configGENERATE_RUN_TIME_STATS == 1 )
+			TCB_t * const pxPreviousTCB = pxCurrentTCB;
+		#endif
+
 		xYieldPending = pdFALSE;
 		traceTASK_SWITCHED_OUT();
 
@@ -2731,6 +2811,17 @@ void vTaskSwitchContext( void )
 		taskSELECT_HIGHEST_PRIORITY_TASK();
 		traceTASK_SWITCHED_IN();
 
+		#if ( configGENERATE_RUN_TIME_STATS == 1 )
+		{
+			/* Only count the switches which actually hand the CPU to another
+			task, not yields which select the same task again. */
+			if( pxCurrentTCB != pxPreviousTCB )
+			{
+				pxCurrentTCB->ulSwitchInCount++;
+			}
+		}
+		#endif /* configGENERATE_RUN_TIME_STATS */
+
 		#if ( configUSE_NEWLIB_REENTRANT == 1 )
 		{
 			/* Switch Newlib's _impure_ptr variable to point to the _reent
@@ -3303,10 +3394,12 @@ static void prvCheckTasksWaitingTermination( void )
 				( void ) uxListRemove( &( pxTCB->xStateListItem ) );
 				--uxCurrentNumberOfTasks;
 				--uxDeletedTasksWaitingCleanUp;
+				pxTCBBeingCleanedUp = pxTCB;
 			}
 			taskEXIT_CRITICAL();
 
 			prvDeleteTCB( pxTCB );
+			pxTCBBeingCleanedUp = NULL;
 		}
 	}
 	#endif /* INCLUDE_vTaskDelete */
@@ -0,0 +1,242 @@
+/**
+ * \file system/control_loop.c
+ *
+ * Kernel control loop scheduler.
+ *
+ * The control loop task is released by the system daemon at the end of each
+ * background processing frame and runs every loop which is due. It then runs
+ * once more a millisecond later on its own, so that loops can run at up to
+ * 1 kHz even though the daemon only runs every 2 milliseconds.
+ *
+ * Loops are kept in a fixed table and are never freed, so their statistics can
+ * be read through a seqlock without stopping the task. The table's mutex is
+ * held by the task while it runs loops, which is what lets
+ * control_loop_remove() guarantee that a loop has finished running. It is
+ * recursive so that a loop can remove itself.
+ *
+ * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include "common/seqlock.h"
+#include "kapi.h"
+#include "pros/control_loop.h"
+#include "v5_api.h"
+
+// The period of the system daemon's background processing, in milliseconds
+#define CONTROL_LOOP_FRAME_PERIOD 2
+
+typedef struct control_loop_s {
+	bool active;
+	bool reset_pending;
+	control_loop_fn_t function;
+	void* parameter;
+	uint32_t period;
+	uint32_t next_run;
+	// High resolution time of the previous run, 0 if there hasn't been one since
+	// the statistics were last cleared
+	uint64_t last_start;
+	seqlock_s_t lock;
+	control_loop_stats_s_t stats;
+} control_loop_s_t;
+
+static control_loop_s_t loops[CONTROL_LOOP_MAX];
+static uint32_t loop_count;
+static mutex_t loops_mutex;
+// The time of the last frame the task was released for
+static uint32_t last_frame;
+
+static task_stack_t control_loop_task_stack[TASK_STACK_DEPTH_DEFAULT];
+static static_task_s_t control_loop_task_buffer;
+static task_t control_loop_task;
+
+static inline uint32_t _histogram_bucket(uint32_t value) {
+	uint32_t bucket = value ? 32 - __builtin_clz(value) : 0;
+	return bucket < CONTROL_LOOP_HISTOGRAM_BUCKETS ? bucket : CONTROL_LOOP_HISTOGRAM_BUCKETS - 1;
+}
+
+/**
+ * Finds an upper bound on the 99th percentile of a histogram from the upper
+ * edge of the bucket it falls in. The last bucket is unbounded, so the largest
+ * sample is used instead.
+ */
+static uint32_t _histogram_p99(const uint32_t* histogram, uint32_t max) {
+	uint32_t total = 0;
+	for (size_t i = 0; i < CONTROL_LOOP_HISTOGRAM_BUCKETS; i++) total += histogram[i];
+	if (total == 0) return 0;
+	uint32_t target = total - total / 100;
+	uint32_t count = 0;
+	for (size_t i = 0; i < CONTROL_LOOP_HISTOGRAM_BUCKETS - 1; i++) {
+		count += histogram[i];
+		if (count >= target) {
+			uint32_t edge = i ? (1u << i) - 1 : 0;
+			return edge < max ? edge : max;
+		}
+	}
+	return max;
+}
+
+static void _control_loop_record(control_loop_s_t* loop, uint64_t start, uint64_t end) {
+	control_loop_stats_s_t* stats = &loop->stats;
+	uint32_t exec = (uint32_t)(end - start);
+
+	seqlock_write_begin(&loop->lock);
+	if (loop->reset_pending) {
+		memset(stats, 0, sizeof(*stats));
+		loop->last_start = 0;
+		loop->reset_pending = false;
+	}
+	if (stats->runs == 0 || exec < stats->exec_min) stats->exec_min = exec;
+	if (exec > stats->exec_max) stats->exec_max = exec;
+	stats->exec_histogram[_histogram_bucket(exec)]++;
+	if (loop->last_start) {
+		uint32_t period = (uint32_t)(start - loop->last_start);
+		uint32_t nominal = loop->period * 1000;
+		uint32_t jitter = period > nominal ? period - nominal : nominal - period;
+		if (stats->period_max == 0 || period < stats->period_min) stats->period_min = period;
+		if (period > stats->period_max) stats->period_max = period;
+		if (jitter > stats->jitter_max) stats->jitter_max = jitter;
+		stats->jitter_histogram[_histogram_bucket(jitter)]++;
+	}
+	stats->runs++;
+	seqlock_write_end(&loop->lock);
+	loop->last_start = start;
+}
+
+static void _control_loop_run(uint32_t now) {
+	if (loop_count == 0) return;
+	mutex_recursive_take(loops_mutex, TIMEOUT_MAX);
+	for (size_t i = 0; i < CONTROL_LOOP_MAX; i++) {
+		control_loop_s_t* loop = &loops[i];
+		if (!loop->active || (int32_t)(now - loop->next_run) < 0) continue;
+
+		uint64_t start = vexSystemHighResTimeGet();
+		loop->function(loop->parameter);
+		uint64_t end = vexSystemHighResTimeGet();
+		if (!loop->active) continue;  // the loop removed itself
+
+		_control_loop_record(loop, start, end);
+		loop->next_run += loop->period;
+		if ((int32_t)(now - loop->next_run) >= 0) {
+			// Fell a whole period or more behind: drop the missed runs instead of
+			// running back to back to catch up
+			uint32_t missed = (now - loop->next_run) / loop->period + 1;
+			seqlock_write_begin(&loop->lock);
+			loop->stats.overruns += missed;
+			seqlock_write_end(&loop->lock);
+			loop->next_run += missed * loop->period;
+		}
+	}
+	mutex_recursive_give(loops_mutex);
+}
+
+static void _control_loop_task(void* ign) {
+	bool released = false;
+	while (true) {
+		if (!released) task_notify_take(true, TIMEOUT_MAX);
+		uint32_t now = millis();
+		last_frame = now;
+		_control_loop_run(now);
+
+		// Run the loops which are due between this frame and the next
+		task_delay_until(&now, 1);
+		released = task_notify_take(true, 0);
+		if (!released) _control_loop_run(millis());
+	}
+}
+
+/**
+ * Releases the control loop task for a new frame.
+ *
+ * Called by the system daemon after background processing, once it has given
+ * back the port mutexes.
+ */
+void control_loop_frame_ready(void) {
+	if (loop_count) task_notify(control_loop_task);
+}
+
+void control_loop_initialize(void) {
+	loops_mutex = mutex_recursive_create();
+	control_loop_task =
+	    task_create_static(_control_loop_task, NULL, TASK_PRIORITY_MAX - 1, TASK_STACK_DEPTH_DEFAULT,
+	                       "PROS Control Loops", control_loop_task_stack, &control_loop_task_buffer);
+}
+
+static control_loop_s_t* _control_loop_get(control_loop_t loop) {
+	if (loop < 0 || loop >= CONTROL_LOOP_MAX || !loops[loop].active) {
+		errno = EINVAL;
+		return NULL;
+	}
+	return &loops[loop];
+}
+
+control_loop_t control_loop_register(control_loop_fn_t function, void* const parameter, uint32_t period) {
+	if (function == NULL || period == 0) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	mutex_recursive_take(loops_mutex, TIMEOUT_MAX);
+	for (control_loop_t i = 0; i < CONTROL_LOOP_MAX; i++) {
+		control_loop_s_t* loop = &loops[i];
+		if (loop->active) continue;
+
+		seqlock_write_begin(&loop->lock);
+		memset(&loop->stats, 0, sizeof(loop->stats));
+		seqlock_write_end(&loop->lock);
+		loop->reset_pending = false;
+		loop->last_start = 0;
+		loop->function = function;
+		loop->parameter = parameter;
+		loop->period = period;
+		// Start on the next frame so that loops with even periods line up with
+		// the daemon's frames
+		loop->next_run = last_frame + CONTROL_LOOP_FRAME_PERIOD;
+		loop->active = true;
+		loop_count++;
+		mutex_recursive_give(loops_mutex);
+		return i;
+	}
+	mutex_recursive_give(loops_mutex);
+	errno = ENOSPC;
+	return PROS_ERR;
+}
+
+int32_t control_loop_remove(control_loop_t loop) {
+	mutex_recursive_take(loops_mutex, TIMEOUT_MAX);
+	control_loop_s_t* entry = _control_loop_get(loop);
+	if (entry == NULL) {
+		mutex_recursive_give(loops_mutex);
+		return PROS_ERR;
+	}
+	entry->active = false;
+	loop_count--;
+	mutex_recursive_give(loops_mutex);
+	return 1;
+}
+
+int32_t control_loop_get_stats(control_loop_t loop, control_loop_stats_s_t* const stats) {
+	control_loop_s_t* entry = _control_loop_get(loop);
+	if (entry == NULL) return PROS_ERR;
+	if (stats == NULL) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	seqlock_read(&entry->lock, stats, &entry->stats, sizeof(control_loop_stats_s_t));
+	stats->jitter_p99 = _histogram_p99(stats->jitter_histogram, stats->jitter_max);
+	stats->exec_p99 = _histogram_p99(stats->exec_histogram, stats->exec_max);
+	return 1;
+}
+
+int32_t control_loop_reset_stats(control_loop_t loop) {
+	control_loop_s_t* entry = _control_loop_get(loop);
+	if (entry == NULL) return PROS_ERR;
+	entry->reset_pending = true;
+	return 1;
+}
@@ -20,6 +20,8 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#include "common/cobs.h"
+#include "common/crc.h"
 #include "common/set.h"
 #include "common/string.h"
 #include "kapi.h"
@@ -31,27 +33,255 @@
 
 #define ASCII_ZERO 48
 
+#define DEV_FRAME_DEFAULT_MAX 256
+#define DEV_FRAME_LIMIT_MAX 4096
+#define DEV_FRAME_CRC_SIZE 2
+// Largest encoded frame body (without delimiters) for a given payload size
+#define DEV_FRAME_ENCODED_MAX(payload) COBS_ENCODE_MEASURE_MAX((payload) + DEV_FRAME_CRC_SIZE)
+// The receive buffer holds the longest legal frame body plus its delimiter
+#define DEV_FRAME_RX_SIZE(payload) (DEV_FRAME_ENCODED_MAX(payload) + 1)
+
+/**
+ * State for a file in framed mode. Each packet is sent on the wire as
+ * 0x00, COBS(payload, CRC-16 big endian), 0x00. The leading delimiter lets the
+ * receiver resynchronize on the very next packet after line noise.
+ *
+ * Received bytes are accumulated in rx_buf and each frame is decoded in place,
+ * so the payload is only copied once, into the caller's buffer.
+ */
+typedef struct dev_frame {
+	size_t max_payload;
+	size_t rx_len;      // number of bytes in rx_buf
+	size_t rx_scanned;  // bytes of rx_buf already known to contain no delimiter
+	bool discarding;    // dropping bytes until the next delimiter
+	uint32_t errors;    // frames dropped for bad encoding, bad CRC or length
+	uint8_t* rx_buf;    // DEV_FRAME_RX_SIZE(max_payload) bytes
+	uint8_t* tx_raw;    // max_payload + DEV_FRAME_CRC_SIZE bytes
+	uint8_t* tx_buf;    // DEV_FRAME_ENCODED_MAX(max_payload) + 2 bytes
+} dev_frame_s_t;
+
 typedef struct dev_file_arg {
 	uint32_t port;
 	int flags;
+	uint32_t read_timeout;  // in milliseconds, TIMEOUT_MAX to block forever
+	dev_frame_s_t* frame;   // NULL when the file is in raw mode
 } dev_file_arg_t;
+_Static_assert(sizeof(dev_file_arg_t) <= VFS_FILE_ARG_SIZE, "dev_file_arg_t doesn't fit in a VFS file argument");
+
+/**
+ * Blocks until the port may have data to read, or until the file's read
+ * timeout (measured from start) has expired.
+ *
+ * \return False if the read timed out, true otherwise
+ */
+static bool _dev_wait_readable(dev_file_arg_t* file_arg, uint32_t start) {
+	uint32_t timeout = file_arg->read_timeout;
+	if (timeout != TIMEOUT_MAX) {
+		uint32_t elapsed = millis() - start;
+		if (elapsed >= timeout) {
+			return false;
+		}
+		timeout -= elapsed;
+	}
+	// The system daemon wakes us once bytes arrive; fall back to polling if the
+	// port couldn't be waited on
+	if (serial_rx_wait(file_arg->port, timeout) == PROS_ERR) {
+		task_delay(2);
+	}
+	return true;
+}
+
+static void _dev_wait_writable(dev_file_arg_t* file_arg) {
+	if (serial_tx_wait(file_arg->port, TIMEOUT_MAX) == PROS_ERR) {
+		task_delay(2);
+	}
+}
+
+static void _dev_frame_free(dev_frame_s_t* frame) {
+	if (frame) {
+		kfree(frame->rx_buf);
+		kfree(frame->tx_raw);
+		kfree(frame->tx_buf);
+		kfree(frame);
+	}
+}
+
+static int32_t _dev_frame_enable(dev_file_arg_t* file_arg, size_t max_payload) {
+	if (max_payload == 0) {
+		max_payload = DEV_FRAME_DEFAULT_MAX;
+	}
+	if (max_payload > DEV_FRAME_LIMIT_MAX) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	dev_frame_s_t* frame = (dev_frame_s_t*)kmalloc(sizeof(dev_frame_s_t));
+	if (frame == NULL) {
+		errno = ENOMEM;
+		return PROS_ERR;
+	}
+	memset(frame, 0, sizeof(dev_frame_s_t));
+	frame->max_payload = max_payload;
+	frame->rx_buf = (uint8_t*)kmalloc(DEV_FRAME_RX_SIZE(max_payload));
+	frame->tx_raw = (uint8_t*)kmalloc(max_payload + DEV_FRAME_CRC_SIZE);
+	frame->tx_buf = (uint8_t*)kmalloc(DEV_FRAME_ENCODED_MAX(max_payload) + 2);
+	if (!frame->rx_buf || !frame->tx_raw || !frame->tx_buf) {
+		_dev_frame_free(frame);
+		errno = ENOMEM;
+		return PROS_ERR;
+	}
+	_dev_frame_free(file_arg->frame);
+	file_arg->frame = frame;
+	return 1;
+}
+
+/**
+ * Looks for a complete frame in the receive buffer and, if a valid one is
+ * found, copies its payload to buffer.
+ *
+ * \return The length of the payload copied, or -1 if no valid frame is
+ * available yet
+ */
+static int32_t _dev_frame_extract(dev_frame_s_t* frame, uint8_t* buffer, const size_t len) {
+	while (frame->rx_scanned < frame->rx_len) {
+		uint8_t* delim = memchr(frame->rx_buf + frame->rx_scanned, 0, frame->rx_len - frame->rx_scanned);
+		if (delim == NULL) {
+			frame->rx_scanned = frame->rx_len;
+			break;
+		}
+		size_t frame_len = delim - frame->rx_buf;
+		int32_t payload_len = -1;
+		if (frame->discarding) {
+			// end of an overlong frame, whose error was already counted
+			frame->discarding = false;
+		} else if (frame_len > 0) {
+			int decoded = cobs_decode(frame->rx_buf, frame->rx_buf, frame_len);
+			if (decoded < DEV_FRAME_CRC_SIZE + 1 || decoded - DEV_FRAME_CRC_SIZE > frame->max_payload) {
+				frame->errors++;
+			} else {
+				size_t n = decoded - DEV_FRAME_CRC_SIZE;
+				uint16_t crc = (frame->rx_buf[n] << 8) | frame->rx_buf[n + 1];
+				if (crc16(CRC16_INIT, frame->rx_buf, n) != crc) {
+					frame->errors++;
+				} else {
+					// datagram semantics: a payload larger than the caller's buffer is
+					// truncated
+					payload_len = n < len ? n : len;
+					memcpy(buffer, frame->rx_buf, payload_len);
+				}
+			}
+		}
+		// shift whatever follows the delimiter to the front of the buffer
+		size_t consumed = frame_len + 1;
+		memmove(frame->rx_buf, frame->rx_buf + consumed, frame->rx_len - consumed);
+		frame->rx_len -= consumed;
+		frame->rx_scanned = 0;
+		if (payload_len >= 0) {
+			return payload_len;
+		}
+	}
+	if (frame->rx_len == DEV_FRAME_RX_SIZE(frame->max_payload)) {
+		// no delimiter within the longest legal frame, so drop everything up to
+		// the next one
+		frame->errors++;
+		frame->discarding = true;
+		frame->rx_len = 0;
+		frame->rx_scanned = 0;
+	}
+	return -1;
+}
+
+static int dev_frame_read(dev_file_arg_t* file_arg, uint8_t* buffer, const size_t len) {
+	dev_frame_s_t* frame = file_arg->frame;
+	uint32_t port = file_arg->port;
+	uint32_t start = millis();
+	while (true) {
+		int32_t payload_len = _dev_frame_extract(frame, buffer, len);
+		if (payload_len >= 0) {
+			return payload_len;
+		}
+		int32_t recv = serial_read(port, frame->rx_buf + frame->rx_len,
+		                           DEV_FRAME_RX_SIZE(frame->max_payload) - frame->rx_len);
+		if (recv == PROS_ERR) {
+			return 0;
+		}
+		if (recv > 0) {
+			frame->rx_len += recv;
+			continue;
+		}
+		if (file_arg->flags & O_NONBLOCK || !_dev_wait_readable(file_arg, start)) {
+			errno = EAGAIN;
+			return 0;
+		}
+	}
+}
+
+static int dev_frame_write(dev_file_arg_t* file_arg, const uint8_t* buf, const size_t len) {
+	dev_frame_s_t* frame = file_arg->frame;
+	uint32_t port = file_arg->port;
+	if (len > frame->max_payload) {
+		errno = EMSGSIZE;
+		return -1;
+	}
+	// the receiving end drops frames without a payload, since a read() of 0
+	// bytes already means there was nothing to read
+	if (len == 0) {
+		errno = EINVAL;
+		return -1;
+	}
+	memcpy(frame->tx_raw, buf, len);
+	uint16_t crc = crc16(CRC16_INIT, buf, len);
+	frame->tx_raw[len] = crc >> 8;
+	frame->tx_raw[len + 1] = crc & 0xff;
+	frame->tx_buf[0] = 0;
+	size_t frame_len = cobs_encode_raw(frame->tx_buf + 1, frame->tx_raw, len + DEV_FRAME_CRC_SIZE) + 1;
+	frame->tx_buf[frame_len++] = 0;
+
+	// a frame is written whole or not at all when non-blocking, so a partial
+	// frame never has to be resumed by the caller
+	if (file_arg->flags & O_NONBLOCK) {
+		int32_t avail = serial_get_write_free(port);
+		if (avail == PROS_ERR) {
+			return -1;
+		}
+		if ((size_t)avail < frame_len) {
+			errno = EAGAIN;
+			return 0;
+		}
+	}
+	size_t wrtn = 0;
+	while (true) {
+		int32_t w = serial_write(port, frame->tx_buf + wrtn, frame_len - wrtn);
+		if (w == PROS_ERR) {
+			return -1;
+		}
+		wrtn += w;
+		if (wrtn >= frame_len) {
+			break;
+		}
+		_dev_wait_writable(file_arg);
+	}
+	return len;
+}
 
 /******************************************************************************/
 /**                         newlib driver functions                          **/
 /******************************************************************************/
-int dev_read_r(struct _reent* r, void* const arg, uint8_t* buffer, const size_t len) {
+ssize_t dev_read_r(struct _reent* r, void* const arg, uint8_t* buffer, const size_t len) {
 	dev_file_arg_t* file_arg = (dev_file_arg_t*)arg;
+	if (file_arg->frame) {
+		return dev_frame_read(file_arg, buffer, len);
+	}
 	uint32_t port = file_arg->port;
+	uint32_t start = millis();
 	int32_t recv = 0;
 	while (true) {
 		recv = serial_read(port, (uint8_t*)(buffer + recv), len - recv);
 		if (recv == PROS_ERR) {
 			return 0;
 		}
-		if (file_arg->flags & O_NONBLOCK || recv >= 1) {
+		if (file_arg->flags & O_NONBLOCK || recv >= 1 || !_dev_wait_readable(file_arg, start)) {
 			break;
 		}
-		task_delay(2);
 	}
 	if (recv == 0) {
 		errno = EAGAIN;
@@ -62,6 +292,9 @@ int dev_read_r(struct _reent* r, void* const arg, uint8_t* buffer, const size_t
 
 int dev_write_r(struct _reent* r, void* const arg, const uint8_t* buf, const size_t len) {
 	dev_file_arg_t* file_arg = (dev_file_arg_t*)arg;
+	if (file_arg->frame) {
+		return dev_frame_write(file_arg, buf, len);
+	}
 	uint32_t port = file_arg->port;
 	int32_t wrtn = 0;
 	while (true) {
@@ -73,7 +306,7 @@ int dev_write_r(struct _reent* r, void* const arg, const uint8_t* buf, const siz
 		if (file_arg->flags & O_NONBLOCK || wrtn >= len) {
 			break;
 		}
-		task_delay(2);
+		_dev_wait_writable(file_arg);
 	}
 	if (wrtn == 0) {
 		errno = EAGAIN;
@@ -83,6 +316,9 @@ int dev_write_r(struct _reent* r, void* const arg, const uint8_t* buf, const siz
 }
 
 int dev_close_r(struct _reent* r, void* const arg) {
+	dev_file_arg_t* file_arg = (dev_file_arg_t*)arg;
+	_dev_frame_free(file_arg->frame);
+	file_arg->frame = NULL;
 	return 0;
 }
 
@@ -113,6 +349,25 @@ int dev_ctl(void* const arg, const uint32_t cmd, void* const extra_arg) {
 			return serial_get_write_free(port);
 		case DEVCTL_SET_BAUDRATE:
 			return serial_set_baudrate(port, (int32_t)extra_arg);
+		case DEVCTL_SET_RX_BUFFER:
+			return serial_set_rx_buffer(port, (uint32_t)extra_arg);
+		case DEVCTL_GET_RX_OVERRUNS:
+			return serial_get_rx_overruns(port);
+		case DEVCTL_ENABLE_FRAMING:
+			return _dev_frame_enable(file_arg, (size_t)extra_arg);
+		case DEVCTL_DISABLE_FRAMING:
+			_dev_frame_free(file_arg->frame);
+			file_arg->frame = NULL;
+			return 1;
+		case DEVCTL_SET_READ_TIMEOUT:
+			file_arg->read_timeout = (uint32_t)extra_arg;
+			return 1;
+		case DEVCTL_GET_FRAME_ERRORS:
+			if (file_arg->frame == NULL) {
+				errno = EINVAL;
+				return PROS_ERR;
+			}
+			return file_arg->frame->errors;
 		default:
 			errno = EINVAL;
 			return PROS_ERR;
@@ -161,8 +416,13 @@ int dev_open_r(struct _reent* r, const char* path, int flags, int mode) {
 	}
 	serial_enable(port);
 
-	dev_file_arg_t* arg = (dev_file_arg_t*)kmalloc(sizeof(dev_file_arg_t));
+	dev_file_arg_t* arg = (dev_file_arg_t*)vfs_file_arg_alloc(r);
+	if (arg == NULL) {
+		return -1;
+	}
 	arg->port = port;
 	arg->flags = flags;
+	arg->read_timeout = TIMEOUT_MAX;
+	arg->frame = NULL;
 	return vfs_add_entry_r(r, dev_driver, arg);
 }
@@ -16,9 +16,11 @@
  */
 
 #include <errno.h>
+#include <stdarg.h>
 
 #include "kapi.h"
 #include "system/dev/banners.h"
+#include "system/heap_trace.h"
 #include "system/hot.h"
 #include "system/optimizers.h"
 #include "v5_api.h"
@@ -32,8 +34,8 @@ void print_small_banner(void) {
 	uint32_t uptime = millis();
 	char const * const timestamp = (HOT_TABLE && HOT_TABLE->compile_timestamp) ? HOT_TABLE->compile_timestamp : _PROS_COMPILE_TIMESTAMP;
 	char const * const directory = (HOT_TABLE && HOT_TABLE->compile_directory) ? HOT_TABLE->compile_directory : _PROS_COMPILE_DIRECTORY;
-	iprintf(short_banner, PROS_VERSION_STRING, uptime / 1000, uptime % 1000, timestamp,
-	        directory);
+	iprintf(short_banner, PROS_VERSION_STRING, (unsigned long)(uptime / 1000), (unsigned long)(uptime % 1000),
+	        timestamp, directory);
 }
 
 void print_large_banner(void) {
@@ -43,8 +45,135 @@ void print_large_banner(void) {
 	uint32_t uptime = millis();
 	char const * const timestamp = (HOT_TABLE && HOT_TABLE->compile_timestamp) ? HOT_TABLE->compile_timestamp : _PROS_COMPILE_TIMESTAMP;
 	char const * const directory = (HOT_TABLE && HOT_TABLE->compile_directory) ? HOT_TABLE->compile_directory : _PROS_COMPILE_DIRECTORY;
-	iprintf(large_banner, PROS_VERSION_STRING, version[3], version[2], version[1], version[0], uptime / 1000,
-	        uptime % 1000, timestamp, directory);
+	iprintf(large_banner, PROS_VERSION_STRING, version[3], version[2], version[1], version[0],
+	        (unsigned long)(uptime / 1000), (unsigned long)(uptime % 1000), timestamp, directory);
+}
+
+/******************************************************************************/
+/**                               Task stats                                 **/
+/**                                                                          **/
+/** Printed by the pRs command. CPU usage is over the time since the last    **/
+/** pRs, so the first one shows usage since each task was created            **/
+/******************************************************************************/
+#define STATS_MAX_TASKS 32
+
+static task_runtime_stats_s_t stats[STATS_MAX_TASKS];
+static struct {
+	task_t task;
+	uint32_t run_time;
+	uint32_t context_switches;
+} prev_stats[STATS_MAX_TASKS];
+static uint32_t prev_stats_count = 0;
+static uint32_t prev_total_run_time = 0;
+
+static const char task_state_chars[] = "RrBSD?";
+
+void print_task_stats(void) {
+	uint32_t total_run_time;
+	int32_t count = task_get_runtime_stats(stats, STATS_MAX_TASKS, &total_run_time);
+	if (count == PROS_ERR) {
+		iprintf("Can't show more than %d tasks\n", STATS_MAX_TASKS);
+		return;
+	}
+	uint32_t elapsed = total_run_time - prev_total_run_time;
+	iprintf("%-32s state prio    cpu  switches stack free\n", "task");
+	for (int32_t i = 0; i < count; i++) {
+		uint32_t run_time = stats[i].run_time;
+		uint32_t switches = stats[i].context_switches;
+		for (uint32_t j = 0; j < prev_stats_count; j++) {
+			if (prev_stats[j].task == stats[i].task) {
+				run_time -= prev_stats[j].run_time;
+				switches -= prev_stats[j].context_switches;
+				break;
+			}
+		}
+		uint32_t permille = elapsed ? (uint32_t)((uint64_t)run_time * 1000 / elapsed) : 0;
+		// uint32_t is unsigned long on the brain but not on every host, hence the casts
+		iprintf("%-32s %5c %4lu %3lu.%lu%% %9lu %10lu\n", stats[i].name,
+		        task_state_chars[stats[i].state < 5 ? stats[i].state : 5], (unsigned long)stats[i].priority,
+		        (unsigned long)(permille / 10), (unsigned long)(permille % 10), (unsigned long)switches,
+		        (unsigned long)stats[i].stack_free_min);
+	}
+	for (int32_t i = 0; i < count; i++) {
+		prev_stats[i].task = stats[i].task;
+		prev_stats[i].run_time = stats[i].run_time;
+		prev_stats[i].context_switches = stats[i].context_switches;
+	}
+	prev_stats_count = count;
+	prev_total_run_time = total_run_time;
+}
+
+/******************************************************************************/
+/**                               Heap report                                **/
+/**                                                                          **/
+/** Printed by the pRm command, and when the kernel heap runs out. Sites and **/
+/** tasks are only listed once heap tracing has been started, e.g. by pRH.   **/
+/** The report is formatted into a buffer first, since the malloc failed     **/
+/** hook can't go through stdio                                              **/
+/******************************************************************************/
+#define REPORT_MAX_SITES 16
+#define REPORT_MAX_TASKS 16
+
+static heap_site_stats_s_t report_sites[REPORT_MAX_SITES];
+static heap_task_stats_s_t report_tasks[REPORT_MAX_TASKS];
+
+static const char* const heap_names[] = {"kernel", "newlib"};
+
+// Appends to a report being formatted into buffer, which holds len characters
+// so far. Whatever doesn't fit is dropped.
+__attribute__((format(printf, 4, 5))) static size_t _report_append(char* buffer, size_t size, size_t len,
+                                                                   const char* fmt, ...) {
+	if (len + 1 >= size) return len;
+	va_list args;
+	va_start(args, fmt);
+	int n = vsniprintf(buffer + len, size - len, fmt, args);
+	va_end(args);
+	if (n < 0) return len;
+	return len + n < size ? len + n : size - 1;
+}
+
+size_t format_heap_stats(char* buffer, size_t size) {
+	heap_stats_s_t heap;
+	heap_get_stats(&heap);
+	size_t len = 0;
+	len = _report_append(buffer, size, len, "kernel heap: %lu bytes free in %lu blocks, largest %lu, fewest ever free %lu\n",
+	                     (unsigned long)heap.free_bytes, (unsigned long)heap.free_blocks,
+	                     (unsigned long)heap.largest_free_block, (unsigned long)heap.min_free_bytes);
+	len = _report_append(buffer, size, len, "%lu allocations, %lu frees\n", (unsigned long)heap.allocs,
+	                     (unsigned long)heap.frees);
+
+	int32_t sites = heap_trace_get_sites(report_sites, REPORT_MAX_SITES);
+	int32_t tasks = heap_trace_get_tasks(report_tasks, REPORT_MAX_TASKS);
+	if (!sites) {
+		return _report_append(buffer, size, len, "no heap trace\n");
+	}
+	len = _report_append(buffer, size, len, "%-6s %-10s %8s %8s %8s %10s\n", "heap", "site", "allocs", "failed", "blocks",
+	                     "bytes");
+	for (int32_t i = 0; i < sites && i < REPORT_MAX_SITES; i++) {
+		heap_site_stats_s_t* site = &report_sites[i];
+		len = _report_append(buffer, size, len, "%-6s %10p %8lu %8lu %8lu %10lu\n", heap_names[site->heap], site->site,
+		                     (unsigned long)site->allocs, (unsigned long)site->failures, (unsigned long)site->blocks,
+		                     (unsigned long)site->bytes);
+	}
+	len = _report_append(buffer, size, len, "%-32s %8s %8s %10s %10s\n", "task", "allocs", "blocks", "bytes",
+	                     "max bytes");
+	for (int32_t i = 0; i < tasks && i < REPORT_MAX_TASKS; i++) {
+		heap_task_stats_s_t* task = &report_tasks[i];
+		len = _report_append(buffer, size, len, "%-32s %8lu %8lu %10lu %10lu\n", task->name, (unsigned long)task->allocs,
+		                     (unsigned long)task->blocks, (unsigned long)task->bytes, (unsigned long)task->max_bytes);
+	}
+	uint32_t untracked = heap_trace_get_untracked();
+	if (untracked) {
+		len = _report_append(buffer, size, len, "%lu allocations didn't fit in the trace\n",
+		                     (unsigned long)untracked);
+	}
+	return len;
+}
+
+void print_heap_stats(void) {
+	static char report[HEAP_REPORT_SIZE];
+	format_heap_stats(report, sizeof(report));
+	fputs(report, stdout);
 }
 
 /******************************************************************************/
@@ -156,6 +285,41 @@ static void ser_daemon_task(void* ign) {
 						// printf("disabled %s\n", command_stack+3);
 						command_stack_idx = 0;
 						break;
+					case 's':
+						print_task_stats();
+						command_stack_idx = 0;
+						break;
+					case 'T':
+						trace_start(TRACE_SCHEDULING | TRACE_INTERRUPTS);
+						command_stack_idx = 0;
+						break;
+					case 't':
+						trace_stop();
+						command_stack_idx = 0;
+						break;
+					case 'P':
+						// read the period and depth
+						command_stack[command_stack_idx++] = vex_read_char();
+						command_stack[command_stack_idx++] = vex_read_char();
+						profiler_start(command_stack[3], command_stack[4]);
+						command_stack_idx = 0;
+						break;
+					case 'p':
+						profiler_stop();
+						command_stack_idx = 0;
+						break;
+					case 'H':
+						heap_trace_start();
+						command_stack_idx = 0;
+						break;
+					case 'h':
+						heap_trace_stop();
+						command_stack_idx = 0;
+						break;
+					case 'm':
+						print_heap_stats();
+						command_stack_idx = 0;
+						break;
 					case 'c':
 						serctl(SERCTL_ENABLE_COBS, NULL);
 						command_stack_idx = 0;
@@ -37,6 +37,7 @@ typedef struct ser_file_arg {
 	};
 	enum { E_NOBLK_WRITE = 1 } flags;
 } ser_file_s_t;
+_Static_assert(sizeof(ser_file_s_t) <= VFS_FILE_ARG_SIZE, "ser_file_s_t doesn't fit in a VFS file argument");
 
 #define STDIN_STREAM_ID 0x706e6973   // 'sinp' little endian
 #define STDOUT_STREAM_ID 0x74756f73  // 'sout' little endian
@@ -111,10 +112,40 @@ bool ser_output_write(const uint8_t* buffer, size_t size, bool noblock) {
 	return stream_buf_send(write_stream, buffer, size, noblock ? 0 : TIMEOUT_MAX);
 }
 
+size_t ser_output_free(void) {
+	return stream_buf_get_unused(write_stream);
+}
+
+// Sends a COBS frame on a stream from inside the kernel (e.g. the trace
+// recorder), without going through a file. Never blocks: a frame which doesn't
+// fit in the output buffer isn't sent at all, and false is returned. Frames on
+// a stream which isn't enabled are discarded, as they are for files.
+bool ser_output_write_stream(uint32_t stream_id, const uint8_t* buf, size_t len) {
+	if (!set_contains(&enabled_streams_set, stream_id)) {
+		return true;
+	}
+	// Binary data can't be told apart from other output without framing
+	if (!(ser_driver_runtime_config & E_COBS_ENABLED)) {
+		return false;
+	}
+
+	const size_t cobs_len = cobs_encode_measure(buf, len, stream_id);
+	uint8_t cobs_buf[cobs_len + 1];
+	cobs_encode(cobs_buf, buf, len, stream_id);
+	cobs_buf[cobs_len] = 0;
+
+	if (!mutex_take(write_mtx, 0)) {
+		return false;
+	}
+	bool ret = stream_buf_get_unused(write_stream) >= cobs_len + 1 && ser_output_write(cobs_buf, cobs_len + 1, true);
+	mutex_give(write_mtx);
+	return ret;
+}
+
 /******************************************************************************/
 /**                         newlib driver functions                          **/
 /******************************************************************************/
-int ser_read_r(struct _reent* r, void* const arg, uint8_t* buffer, const size_t len) {
+ssize_t ser_read_r(struct _reent* r, void* const arg, uint8_t* buffer, const size_t len) {
 	// arg isn't used since serial reads aren't stream-based
 	size_t read = 0;
 	int32_t c;
@@ -286,7 +317,11 @@ int ser_open_r(struct _reent* r, const char* path, int flags, int mode) {
 		return STDERR_FILENO;
 	}
 
-	ser_file_s_t* arg = kmalloc(sizeof(*arg));
+	ser_file_s_t* arg = vfs_file_arg_alloc(r);
+	if (arg == NULL) {
+		return -1;
+	}
+	memset(arg, 0, sizeof(*arg));
 	memcpy(arg->stream, path, strlen(path));
 	return vfs_add_entry_r(r, ser_driver, arg);
 }
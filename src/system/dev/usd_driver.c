@@ -28,6 +28,7 @@
 typedef struct usd_file_arg {
 	FIL* ifi_fptr;
 } usd_file_arg_t;
+_Static_assert(sizeof(usd_file_arg_t) <= VFS_FILE_ARG_SIZE, "usd_file_arg_t doesn't fit in a VFS file argument");
 
 static const int FRESULTMAP[] = {0,       EIO,    EINVAL, EBUSY, ENOENT,  ENOENT, EINVAL, EACCES,  // FR_DENIED
                                  EEXIST,  EINVAL, EROFS,  ENXIO, ENOBUFS, ENXIO,  EIO,    EACCES,  // FR_LOCKED
@@ -43,7 +44,7 @@ enum fa_flags {
 /******************************************************************************/
 /**                         newlib driver functions                          **/
 /******************************************************************************/
-int usd_read_r(struct _reent* r, void* const arg, uint8_t* buffer, const size_t len) {
+ssize_t usd_read_r(struct _reent* r, void* const arg, uint8_t* buffer, const size_t len) {
 	usd_file_arg_t* file_arg = (usd_file_arg_t*)arg;
 	// TODO: mutex here. Global or file lock?
 	int32_t result = vexFileRead((char*)buffer, sizeof(*buffer), len, file_arg->ifi_fptr);
@@ -108,7 +109,10 @@ int usd_open_r(struct _reent* r, const char* path, int flags, int mode) {
 		return -1;
 	}
 
-	usd_file_arg_t* file_arg = kmalloc(sizeof(*file_arg));
+	usd_file_arg_t* file_arg = vfs_file_arg_alloc(r);
+	if (file_arg == NULL) {
+		return -1;
+	}
 
 	switch (flags & O_ACCMODE) {
 		case O_RDONLY:
@@ -122,11 +126,13 @@ int usd_open_r(struct _reent* r, const char* path, int flags, int mode) {
 			}
 			break;
 		default:
+			vfs_file_arg_free(file_arg);
 			r->_errno = EINVAL;
 			return -1;
 	}
 
 	if (!file_arg->ifi_fptr) {
+		vfs_file_arg_free(file_arg);
 		r->_errno = ENFILE;  // up to 8 files max as of vexOS 0.7.4b55
 		return -1;
 	}
@@ -50,8 +50,16 @@ static struct gid_metadata file_table_gids = {.bitmap = file_table_bmp,
 // file table mapping a file descriptor number to a driver and driver argument
 static struct file_entry file_table[MAX_FILES_OPEN];
 
+// driver arguments of the files which aren't reserved
+static static_pool_s_t file_arg_pool_buf;
+static uint8_t file_arg_pool_storage[POOL_STORAGE_SIZE(VFS_FILE_ARG_SIZE, MAX_FILES_OPEN - RESERVED_FILENOS)]
+    __attribute__((aligned(8)));
+static pool_t file_arg_pool;
+
 void vfs_initialize(void) {
 	gid_init(&file_table_gids);
+	file_arg_pool = pool_create_static(VFS_FILE_ARG_SIZE, MAX_FILES_OPEN - RESERVED_FILENOS, file_arg_pool_storage,
+	                                   &file_arg_pool_buf);
 
 	ser_initialize();
 
@@ -64,6 +72,7 @@ void vfs_initialize(void) {
 int vfs_add_entry_r(struct _reent* r, struct fs_driver const* const driver, void* arg) {
 	uint32_t gid = gid_alloc(&file_table_gids);
 	if (gid == 0) {
+		vfs_file_arg_free(arg);
 		r->_errno = ENFILE;
 		return -1;
 	}
@@ -73,6 +82,20 @@ int vfs_add_entry_r(struct _reent* r, struct fs_driver const* const driver, void
 	return gid;
 }
 
+void* vfs_file_arg_alloc(struct _reent* r) {
+	void* arg = pool_alloc(file_arg_pool);
+	if (arg == NULL) {
+		r->_errno = ENFILE;
+	}
+	return arg;
+}
+
+void vfs_file_arg_free(void* arg) {
+	if (pool_contains(file_arg_pool, arg)) {
+		pool_free(file_arg_pool, arg);
+	}
+}
+
 // update a given fileno driver and arg. Used by ser_driver_initialize to
 // initialize stdout, stdin, stderr, and kdbg
 int vfs_update_entry(int file, struct fs_driver const* const driver, void* arg) {
@@ -150,6 +173,7 @@ int _close(int file) {
 	}
 	int ret = file_table[file].driver->close_r(r, file_table[file].arg);
 	if (ret == 0) {
+		vfs_file_arg_free(file_table[file].arg);
 		gid_free(&file_table_gids, file);
 	}
 	return ret;
@@ -0,0 +1,254 @@
+/**
+ * \file system/heap_trace.c
+ *
+ * Heap allocation tracing
+ *
+ * Each traced block is kept in an open addressing hash table keyed by its
+ * address, which remembers its size and the site and task it is charged to, so
+ * that freeing it can take it back off both. Sites are kept the same way,
+ * keyed by return address, and tasks in a short array searched by TCB number.
+ * Everything is updated with the scheduler suspended, since blocks come from
+ * two heaps which are locked differently.
+ *
+ * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include "kapi.h"
+#include "rtos/tcb.h"
+#include "system/heap_trace.h"
+#include "system/optimizers.h"
+
+// Both must be powers of 2. Tables are only filled to 3/4, so that searches
+// stay short
+#define HEAP_TRACE_BLOCKS 1024
+#define HEAP_TRACE_SITES 128
+#define HEAP_TRACE_TASKS 32
+
+#define BLOCKS_MAX (HEAP_TRACE_BLOCKS / 4 * 3)
+#define SITES_MAX (HEAP_TRACE_SITES / 4 * 3)
+
+typedef struct block_s {
+	void* ptr;  // NULL if the slot is empty
+	uint32_t size;
+	uint16_t site;  // index into sites
+	uint8_t task;   // index into tasks
+} block_s_t;
+
+volatile bool heap_trace_running = false;
+
+static block_s_t blocks[HEAP_TRACE_BLOCKS];
+static uint32_t block_count;
+static uint32_t untracked;
+
+// The last entry of each is where sites and tasks which don't fit are recorded
+static heap_site_stats_s_t sites[HEAP_TRACE_SITES + 1];
+static uint32_t site_count;
+static heap_task_stats_s_t tasks[HEAP_TRACE_TASKS + 1];
+static uint32_t task_numbers[HEAP_TRACE_TASKS];
+static uint32_t task_count;
+
+static inline uint32_t _hash(const void* ptr) {
+	// Fibonacci hashing. The low bits of heap addresses and return addresses are
+	// mostly the same, so they're shifted out first
+	return (uint32_t)((uintptr_t)ptr >> 2) * 2654435769u;
+}
+
+static uint16_t _site_index(uint8_t heap, void* site) {
+	uint32_t i = _hash(site) & (HEAP_TRACE_SITES - 1);
+	while (sites[i].site) {
+		if (sites[i].site == site && sites[i].heap == heap) return i;
+		i = (i + 1) & (HEAP_TRACE_SITES - 1);
+	}
+	if (site_count >= SITES_MAX) {
+		sites[HEAP_TRACE_SITES].heap = heap;
+		return HEAP_TRACE_SITES;
+	}
+	site_count++;
+	sites[i].site = site;
+	sites[i].heap = heap;
+	return i;
+}
+
+static uint8_t _task_index(void) {
+	// Allocations made before the scheduler starts are charged to whichever
+	// task was created first, as pxCurrentTCB is set by then
+	TCB_t* tcb = pxCurrentTCB;
+	uint32_t number = tcb ? tcb->uxTCBNumber : 0;
+	for (uint32_t i = 0; i < task_count; i++) {
+		if (task_numbers[i] == number) return i;
+	}
+	if (task_count >= HEAP_TRACE_TASKS) return HEAP_TRACE_TASKS;
+	task_numbers[task_count] = number;
+	tasks[task_count].task = tcb;
+	strncpy(tasks[task_count].name, tcb ? tcb->pcTaskName : "(no task)", sizeof(tasks[task_count].name));
+	return task_count++;
+}
+
+void heap_trace_record_alloc(uint8_t heap, void* ptr, size_t size, void* site) {
+	if (!ptr && !size) return;
+
+	rtos_suspend_all();
+	if (!heap_trace_running) {
+		rtos_resume_all();
+		return;
+	}
+	heap_site_stats_s_t* s = &sites[_site_index(heap, site)];
+	if (!ptr) {
+		s->failures++;
+		rtos_resume_all();
+		return;
+	}
+	uint8_t task = _task_index();
+	heap_task_stats_s_t* t = &tasks[task];
+	s->allocs++;
+	t->allocs++;
+	if (unlikely(block_count >= BLOCKS_MAX)) {
+		untracked++;
+		rtos_resume_all();
+		return;
+	}
+
+	uint32_t i = _hash(ptr) & (HEAP_TRACE_BLOCKS - 1);
+	while (blocks[i].ptr) i = (i + 1) & (HEAP_TRACE_BLOCKS - 1);
+	blocks[i] = (block_s_t){.ptr = ptr, .size = size, .site = s - sites, .task = task};
+	block_count++;
+	s->blocks++;
+	s->bytes += size;
+	t->blocks++;
+	t->bytes += size;
+	if (t->bytes > t->max_bytes) t->max_bytes = t->bytes;
+	rtos_resume_all();
+}
+
+void heap_trace_record_free(void* ptr) {
+	if (!ptr) return;
+
+	rtos_suspend_all();
+	if (!heap_trace_running) {
+		rtos_resume_all();
+		return;
+	}
+	uint32_t i = _hash(ptr) & (HEAP_TRACE_BLOCKS - 1);
+	while (blocks[i].ptr != ptr) {
+		if (!blocks[i].ptr) {
+			// Allocated before the trace started, or didn't fit in it
+			rtos_resume_all();
+			return;
+		}
+		i = (i + 1) & (HEAP_TRACE_BLOCKS - 1);
+	}
+	heap_site_stats_s_t* s = &sites[blocks[i].site];
+	heap_task_stats_s_t* t = &tasks[blocks[i].task];
+	s->blocks--;
+	s->bytes -= blocks[i].size;
+	t->blocks--;
+	t->bytes -= blocks[i].size;
+	block_count--;
+
+	// Move later blocks of the same run back into the hole, unless their own
+	// hash puts them after it, so that every block can still be found by
+	// searching from its hash to the first empty slot
+	uint32_t hole = i;
+	for (uint32_t j = (i + 1) & (HEAP_TRACE_BLOCKS - 1); blocks[j].ptr; j = (j + 1) & (HEAP_TRACE_BLOCKS - 1)) {
+		uint32_t home = _hash(blocks[j].ptr) & (HEAP_TRACE_BLOCKS - 1);
+		if (((j - home) & (HEAP_TRACE_BLOCKS - 1)) >= ((j - hole) & (HEAP_TRACE_BLOCKS - 1))) {
+			blocks[hole] = blocks[j];
+			hole = j;
+		}
+	}
+	blocks[hole].ptr = NULL;
+	rtos_resume_all();
+}
+
+int32_t heap_get_stats(heap_stats_s_t* const stats) {
+	if (!stats) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	HeapStats_t heap;
+	vPortGetHeapStats(&heap);
+	stats->free_bytes = heap.xAvailableHeapSpaceInBytes;
+	stats->min_free_bytes = heap.xMinimumEverFreeBytesRemaining;
+	stats->largest_free_block = heap.xSizeOfLargestFreeBlockInBytes;
+	stats->free_blocks = heap.xNumberOfFreeBlocks;
+	stats->allocs = heap.xNumberOfSuccessfulAllocations;
+	stats->frees = heap.xNumberOfSuccessfulFrees;
+	return 1;
+}
+
+int32_t heap_trace_start(void) {
+	rtos_suspend_all();
+	memset(blocks, 0, sizeof(blocks));
+	memset(sites, 0, sizeof(sites));
+	memset(tasks, 0, sizeof(tasks));
+	block_count = 0;
+	site_count = 0;
+	task_count = 0;
+	untracked = 0;
+	strcpy(tasks[HEAP_TRACE_TASKS].name, "(other tasks)");
+	heap_trace_running = true;
+	rtos_resume_all();
+	return 1;
+}
+
+int32_t heap_trace_stop(void) {
+	heap_trace_running = false;
+	return 1;
+}
+
+// Whether a should be listed before b: more bytes outstanding, then more
+// allocations
+#define LISTED_BEFORE(a, b) ((a).bytes > (b).bytes || ((a).bytes == (b).bytes && (a).allocs > (b).allocs))
+
+int32_t heap_trace_get_sites(heap_site_stats_s_t* const out, uint32_t size) {
+	if (!out) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	uint32_t count = 0;
+	rtos_suspend_all();
+	for (uint32_t i = 0; i <= HEAP_TRACE_SITES; i++) {
+		if (!sites[i].allocs && !sites[i].failures) continue;
+		// Insertion sort, keeping only the first size sites
+		uint32_t j = count < size ? count++ : size;
+		while (j > 0 && LISTED_BEFORE(sites[i], out[j - 1])) {
+			if (j < size) out[j] = out[j - 1];
+			j--;
+		}
+		if (j < size) out[j] = sites[i];
+	}
+	rtos_resume_all();
+	return count;
+}
+
+int32_t heap_trace_get_tasks(heap_task_stats_s_t* const out, uint32_t size) {
+	if (!out) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	uint32_t count = 0;
+	rtos_suspend_all();
+	for (uint32_t i = 0; i <= HEAP_TRACE_TASKS; i++) {
+		if (!tasks[i].allocs) continue;
+		uint32_t j = count < size ? count++ : size;
+		while (j > 0 && LISTED_BEFORE(tasks[i], out[j - 1])) {
+			if (j < size) out[j] = out[j - 1];
+			j--;
+		}
+		if (j < size) out[j] = tasks[i];
+	}
+	rtos_resume_all();
+	return count;
+}
+
+uint32_t heap_trace_get_untracked(void) {
+	return untracked;
+}
@@ -0,0 +1,65 @@
+/**
+ * \file system/malloc.c
+ *
+ * newlib allocator entry points
+ *
+ * Replaces newlib's malloc, free, calloc and realloc so that heap tracing sees
+ * the allocations made through them. Like newlib's own, they call the
+ * reentrant versions, which is what the C library uses internally, so its own
+ * allocations aren't traced.
+ *
+ * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <malloc.h>
+#include <reent.h>
+#include <stdlib.h>
+
+#include "system/heap_trace.h"
+#include "system/optimizers.h"
+
+void* malloc(size_t size) {
+	void* ptr = _malloc_r(_REENT, size);
+	if (unlikely(heap_trace_running)) {
+		heap_trace_record_alloc(HEAP_TRACE_NEWLIB, ptr, size, __builtin_return_address(0));
+	}
+	return ptr;
+}
+
+void free(void* ptr) {
+	// The block is taken off the trace first, since another task can be given
+	// it as soon as it's freed
+	if (unlikely(heap_trace_running)) {
+		heap_trace_record_free(ptr);
+	}
+	_free_r(_REENT, ptr);
+}
+
+void* calloc(size_t count, size_t size) {
+	void* ptr = _calloc_r(_REENT, count, size);
+	if (unlikely(heap_trace_running)) {
+		heap_trace_record_alloc(HEAP_TRACE_NEWLIB, ptr, count * size, __builtin_return_address(0));
+	}
+	return ptr;
+}
+
+void* realloc(void* ptr, size_t size) {
+	if (likely(!heap_trace_running)) {
+		return _realloc_r(_REENT, ptr, size);
+	}
+	// The old block is only freed if realloc succeeds, which isn't known until
+	// afterwards, so nobody else may allocate until the trace is updated
+	__malloc_lock(_REENT);
+	void* new_ptr = _realloc_r(_REENT, ptr, size);
+	if (new_ptr || !size) {
+		heap_trace_record_free(ptr);
+	}
+	heap_trace_record_alloc(HEAP_TRACE_NEWLIB, new_ptr, size, __builtin_return_address(0));
+	__malloc_unlock(_REENT);
+	return new_ptr;
+}
@@ -5,6 +5,16 @@
  *
  * Contains implementations of memory-locking functions for newlib.
  *
+ * newlib's allocator is serialized with a recursive mutex rather than by
+ * suspending the scheduler, so a task in malloc only holds up other tasks which
+ * allocate. Those tasks wait for at most one allocation, since the mutex lends
+ * their priority to the task holding it.
+ *
+ * Unlike with the scheduler suspended, a task in malloc can now be deleted by
+ * another task, which would leave the mutex held by a dead task and the heap
+ * half updated. So task_delete takes the mutex around deleting another task,
+ * which waits for the allocation in progress to finish.
+ *
  * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
  * All rights reserved.
  *
@@ -14,11 +24,44 @@
  */
 
 #include "rtos/task.h"
+#include "rtos/semphr.h"
+#include "system/optimizers.h"
+
+static static_sem_s_t malloc_mutex_buf;
+static mutex_t malloc_mutex = NULL;
+
+void __malloc_lock(void) {
+	// newlib can allocate before the kernel is initialized, so the mutex is
+	// created by whichever allocation comes first
+	if (unlikely(!malloc_mutex)) {
+		taskENTER_CRITICAL();
+		if (!malloc_mutex) {
+			malloc_mutex = xSemaphoreCreateRecursiveMutexStatic(&malloc_mutex_buf);
+		}
+		taskEXIT_CRITICAL();
+	}
+	// Blocking isn't allowed before the scheduler starts or while it's suspended.
+	// Nothing else can be in malloc before it starts, and a task which suspends
+	// the scheduler while another task is in malloc can't allocate.
+	uint32_t timeout = xTaskGetSchedulerState() == taskSCHEDULER_RUNNING ? portMAX_DELAY : 0;
+	uint8_t taken = mutex_recursive_take(malloc_mutex, timeout);
+	configASSERT(taken);
+}
+
+void __malloc_unlock(void) {
+	mutex_recursive_give(malloc_mutex);
+}
 
- void __malloc_lock(void) {
- 	rtos_suspend_all();
- }
+bool malloc_delete_lock(task_t task) {
+	// A task deleting itself can't be in malloc, and wouldn't live to give the
+	// mutex back. Without the scheduler running nothing else can be in malloc.
+	if (task == NULL || task == task_get_current() || xTaskGetSchedulerState() != taskSCHEDULER_RUNNING) {
+		return false;
+	}
+	__malloc_lock();
+	return true;
+}
 
- void __malloc_unlock(void) {
- 	rtos_resume_all();
- }
+void malloc_delete_unlock(bool locked) {
+	if (locked) __malloc_unlock();
+}
@@ -0,0 +1,172 @@
+/**
+ * \file system/profiler.c
+ *
+ * Sampling profiler
+ *
+ * The tick hook is the only writer of the sample ring and the system daemon the
+ * only reader, so the ring only needs its head and tail published in order.
+ * Samples which don't fit are counted and reported once there is room again.
+ * Each task's name is sent before its first sample, so that a capture which
+ * starts with the profiler can be read on its own.
+ *
+ * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include "kapi.h"
+#include "system/optimizers.h"
+#include "system/profiler.h"
+
+// NOTE: can't just include task.h because of redefinition that goes on in kapi
+//       include chain, so we just prototype what we need here
+void vTaskForEachTask(void (*pxCallback)(task_t, void*), void* pvArg);
+
+#include "rtos/tcb.h"
+
+// Must be a power of 2
+#define PROFILER_RING_LENGTH 64
+// Most bytes sent in one frame, so one flush can't take over the whole serial
+// output buffer
+#define PROFILER_FLUSH_MAX 512
+// Tasks are only named if their TCB number is below this
+#define PROFILER_NAMED_TASKS 256
+
+#define NAME_WORDS (configMAX_TASK_NAME_LEN / sizeof(uint32_t))
+
+typedef struct profiler_slot_s {
+	profiler_record_s_t header;
+	uint32_t pcs[PROFILER_MAX_DEPTH];
+} profiler_slot_s_t;
+
+extern volatile uint32_t ulPortSaveInterruptedContext;
+
+static volatile uint32_t sample_period = 0;  // in ticks, 0 while stopped
+static uint32_t sample_depth;
+static uint32_t ticks_since_sample;
+
+static profiler_slot_s_t ring[PROFILER_RING_LENGTH];
+static uint32_t ring_head = 0;  // next slot to fill
+static uint32_t ring_tail = 0;  // next slot to send
+static uint32_t dropped = 0;
+
+static uint32_t named_tasks[PROFILER_NAMED_TASKS / 32];
+static uint8_t flush_buf[PROFILER_FLUSH_MAX];
+
+extern size_t ser_output_free(void);
+extern bool ser_output_write_stream(uint32_t stream_id, const uint8_t* buf, size_t len);
+
+void profiler_tick(void) {
+	if (likely(!sample_period) || ++ticks_since_sample < sample_period) return;
+	ticks_since_sample = 0;
+
+	uint32_t head = ring_head;
+	if (head - __atomic_load_n(&ring_tail, __ATOMIC_ACQUIRE) >= PROFILER_RING_LENGTH) {
+		__atomic_fetch_add(&dropped, 1, __ATOMIC_RELAXED);
+		return;
+	}
+	profiler_slot_s_t* slot = &ring[head & (PROFILER_RING_LENGTH - 1)];
+	size_t n = backtrace_interrupted(slot->pcs, sample_depth);
+	if (!n) return;
+	slot->header = (profiler_record_s_t){
+	    .type = E_PROFILER_SAMPLE, .length = n, .task = pxCurrentTCB ? pxCurrentTCB->uxTCBNumber : 0};
+	__atomic_store_n(&ring_head, head + 1, __ATOMIC_RELEASE);
+}
+
+struct name_search {
+	uint16_t number;
+	char* name;
+};
+
+static void _find_name_cb(task_t task, void* arg) {
+	struct name_search* search = (struct name_search*)arg;
+	TCB_t* tcb = (TCB_t*)task;
+	if (tcb->uxTCBNumber == search->number) {
+		memcpy(search->name, tcb->pcTaskName, configMAX_TASK_NAME_LEN - 1);
+	}
+}
+
+// Appends a record for the task's name to flush_buf if it hasn't been sent yet
+// and fits, and returns the new length of flush_buf
+static size_t _append_name(uint16_t task, size_t len, size_t max) {
+	if (task >= PROFILER_NAMED_TASKS || (named_tasks[task / 32] & (1u << (task % 32)))) return len;
+	size_t size = sizeof(profiler_record_s_t) + NAME_WORDS * sizeof(uint32_t);
+	if (len + size > max) return len;
+
+	profiler_record_s_t header = {.type = E_PROFILER_TASK_NAME, .length = NAME_WORDS, .task = task};
+	memcpy(flush_buf + len, &header, sizeof(header));
+	char* name = (char*)flush_buf + len + sizeof(header);
+	memset(name, 0, configMAX_TASK_NAME_LEN);
+	struct name_search search = {.number = task, .name = name};
+	vTaskForEachTask(_find_name_cb, &search);
+	named_tasks[task / 32] |= 1u << (task % 32);
+	return len + size;
+}
+
+void profiler_flush(void) {
+	uint32_t tail = ring_tail;
+	uint32_t head = __atomic_load_n(&ring_head, __ATOMIC_ACQUIRE);
+	uint32_t lost = __atomic_load_n(&dropped, __ATOMIC_RELAXED);
+	if (likely(tail == head && !lost)) return;
+
+	// COBS adds a byte every 254 and the stream ID and delimiter take 6 more.
+	// Half of the output buffer is left for everything else.
+	size_t budget = ser_output_free() / 2;
+	size_t max = budget > 6 ? (budget - 6) * 254 / 255 : 0;
+	if (max > PROFILER_FLUSH_MAX) max = PROFILER_FLUSH_MAX;
+
+	size_t len = 0;
+	uint32_t sent = 0;
+	if (lost && sizeof(profiler_record_s_t) + sizeof(uint32_t) <= max) {
+		__atomic_fetch_sub(&dropped, lost, __ATOMIC_RELAXED);
+		sent = lost;
+		profiler_record_s_t header = {.type = E_PROFILER_DROPPED, .length = 1};
+		memcpy(flush_buf, &header, sizeof(header));
+		memcpy(flush_buf + sizeof(header), &lost, sizeof(lost));
+		len = sizeof(header) + sizeof(lost);
+	}
+	while (tail != head) {
+		profiler_slot_s_t* slot = &ring[tail & (PROFILER_RING_LENGTH - 1)];
+		len = _append_name(slot->header.task, len, max);
+		size_t size = sizeof(profiler_record_s_t) + slot->header.length * sizeof(uint32_t);
+		if (len + size > max) break;
+		memcpy(flush_buf + len, slot, size);
+		len += size;
+		sent++;
+		tail++;
+	}
+	__atomic_store_n(&ring_tail, tail, __ATOMIC_RELEASE);
+
+	if (len && !ser_output_write_stream(PROFILER_STREAM_ID, flush_buf, len)) {
+		// Report the samples in the frame (and any reported as dropped) later
+		__atomic_fetch_add(&dropped, sent, __ATOMIC_RELAXED);
+		// Names in the frame have to be sent again
+		memset(named_tasks, 0, sizeof(named_tasks));
+	}
+}
+
+int32_t profiler_start(uint32_t period, uint8_t depth) {
+	if (!period || !depth || depth > PROFILER_MAX_DEPTH) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	serctl(SERCTL_ACTIVATE, (void*)PROFILER_STREAM_ID);
+	memset(named_tasks, 0, sizeof(named_tasks));
+	sample_depth = depth;
+	ticks_since_sample = 0;
+	ulPortSaveInterruptedContext = 1;
+	sample_period = period;
+	return 1;
+}
+
+int32_t profiler_stop(void) {
+	sample_period = 0;
+	ulPortSaveInterruptedContext = 0;
+	return 1;
+}
@@ -14,10 +14,15 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 
+#include <stdio.h>
+#include <string.h>
+
 #include "rtos/FreeRTOS.h"
 #include "rtos/semphr.h"
 #include "rtos/task.h"
 #include "rtos/tcb.h"
+#include "system/heap_trace.h"
+#include "system/profiler.h"
 
 #include "v5_api.h"
 #include "v5_color.h"
@@ -57,6 +62,9 @@ void rtos_initialize() {
 
 	vPortInstallFreeRTOSVectorTable();
 
+	void linked_list_initialize(void);
+	linked_list_initialize();
+
 	void task_notify_when_deleting_init();
 	task_notify_when_deleting_init();
 }
@@ -72,7 +80,14 @@ void rtos_tick_interrupt_clear() {
 }
 
 void vApplicationFPUSafeIRQHandler(uint32_t ulICCIAR) {
+	// The low 10 bits of the interrupt acknowledge register are the interrupt ID
+	trace_hook(E_TRACE_ISR_ENTER, 0, ulICCIAR & 0x3FF, 0);
 	vexSystemApplicationIRQHandler(ulICCIAR);
+	trace_hook(E_TRACE_ISR_EXIT, 0, ulICCIAR & 0x3FF, 0);
+}
+
+void vApplicationTickHook(void) {
+	profiler_tick();
 }
 
 void vInitialiseTimerForRunTimeStats(void) {
@@ -85,10 +100,33 @@ void vApplicationMallocFailedHook(void) {
 	// FreeRTOS API functions that create tasks, queues, software timers, and
 	// semaphores.  The size of the FreeRTOS heap is set by the
 	// configTOTAL_HEAP_SIZE configuration constant in FreeRTOSConfig.h.
-	taskDISABLE_INTERRUPTS();
+	//
+	// Nothing here may block: kmalloc can fail with the scheduler suspended, or
+	// in the system daemon, which is what drains the serial output buffer. So
+	// the heap report is formatted into a static buffer and written straight to
+	// VEXos. Interrupts are masked with a critical section inside a scheduler
+	// suspension rather than with taskDISABLE_INTERRUPTS, so that the critical
+	// sections and suspensions the report takes nest inside them, and neither
+	// unmask interrupts nor switch tasks when they end.
+	static const char header[] = "\n\nFATAL ERROR!! The kernel heap is exhausted\n";
+	static char report[sizeof(header) - 1 + HEAP_REPORT_SIZE];
+	rtos_suspend_all();
+	taskENTER_CRITICAL();
+	memcpy(report, header, sizeof(header) - 1);
+	size_t len = sizeof(header) - 1 + format_heap_stats(report + sizeof(header) - 1, HEAP_REPORT_SIZE);
+	size_t sent = 0;
 
-	for (;;)
-		;
+	for (;;) {
+		vexBackgroundProcessing();
+		extern void ser_output_flush();
+		ser_output_flush();
+		int32_t avail = vexSerialWriteFree(1);
+		if (sent < len && avail > 0) {
+			size_t chunk = len - sent < (size_t)avail ? len - sent : (size_t)avail;
+			int32_t n = vexSerialWriteBuffer(1, (uint8_t*)report + sent, chunk);
+			if (n > 0) sent += n;
+		}
+	}
 }
 
 void vApplicationStackOverflowHook(task_t pxTask, char* pcTaskName) {
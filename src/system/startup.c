@@ -21,6 +21,7 @@
 extern void rtos_initialize();
 extern void vfs_initialize();
 extern void system_daemon_initialize();
+extern void control_loop_initialize();
 extern void rtos_sched_start();
 extern void vdml_initialize();
 extern void invoke_install_hot_table();
@@ -50,6 +51,8 @@ __attribute__((constructor(PROS_KERNEL_PRE_INIT))) static void pros_pre_init(voi
 __attribute__((constructor(PROS_KERNEL_INIT))) static void pros_init(void) {
 	system_daemon_initialize();
 
+	control_loop_initialize();
+
 	invoke_install_hot_table();
 }
 
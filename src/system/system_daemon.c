@@ -11,12 +11,27 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 
+#include <errno.h>
+#include <string.h>
+
+#include "common/seqlock.h"
 #include "kapi.h"
 #include "system/optimizers.h"
+#include "system/profiler.h"
+#include "system/trace.h"
 #include "system/user_functions.h"
 #include "v5_api.h"
+#include "vdml/registry.h"
 
 extern void vdml_background_processing();
+extern void serial_background_processing();
+extern void controller_background_processing();
+extern void vision_background_processing();
+extern void imu_background_processing();
+extern void adi_background_processing();
+extern void odom_background_processing();
+extern void vdml_frame_advance(void);
+extern void motor_command_invalidate_all(void);
 
 extern void port_mutex_take_all();
 extern void port_mutex_give_all();
@@ -44,16 +59,63 @@ char task_names[4][32] = {"User Operator Control (PROS)", "User Autonomous (PROS
 task_fn_t task_fns[4] = {_opcontrol_task, _autonomous_task, _disabled_task, _competition_initialize_task};
 
 extern void ser_output_flush(void);
+extern void control_loop_frame_ready(void);
+
+static seqlock_s_t stage_stats_lock;
+static daemon_stage_stats_s_t stage_stats[E_DAEMON_STAGE_COUNT];
+static bool stage_stats_reset_pending;
+
+static void _stage_end(daemon_stage_e_t stage, uint64_t start) {
+	uint32_t elapsed = (uint32_t)(vexSystemHighResTimeGet() - start);
+	daemon_stage_stats_s_t* stats = &stage_stats[stage];
+	seqlock_write_begin(&stage_stats_lock);
+	stats->runs++;
+	stats->last = elapsed;
+	if (elapsed > stats->max) stats->max = elapsed;
+	stats->total += elapsed;
+	seqlock_write_end(&stage_stats_lock);
+}
 
 // does the basic background operations that need to occur every 2ms
 static inline void do_background_operations() {
-	port_mutex_take_all();
+	if (unlikely(stage_stats_reset_pending)) {
+		seqlock_write_begin(&stage_stats_lock);
+		memset(stage_stats, 0, sizeof(stage_stats));
+		seqlock_write_end(&stage_stats_lock);
+		stage_stats_reset_pending = false;
+	}
+
+	// Serial output only goes through VEXos' serial buffer, which nothing but
+	// this task writes to, so user device accesses don't have to wait for it
+	uint64_t start = vexSystemHighResTimeGet();
+	trace_flush();
+	profiler_flush();
 	ser_output_flush();
+	_stage_end(E_DAEMON_STAGE_SERIAL_FLUSH, start);
+
+	// Device data must not change while a user task is in the middle of a VDML
+	// call, so everything which reads it in bulk runs under all of the port
+	// mutexes
+	start = vexSystemHighResTimeGet();
+	port_mutex_take_all();
 	rtos_suspend_all();
 	vexBackgroundProcessing();
 	rtos_resume_all();
-	vdml_background_processing();
+	vdml_frame_advance();
+	registry_update_types();
+	serial_background_processing();
+	imu_background_processing();
+	adi_background_processing();
+	odom_background_processing();
+	vision_background_processing();
+	controller_background_processing();
 	port_mutex_give_all();
+	_stage_end(E_DAEMON_STAGE_DEVICE_SYNC, start);
+	control_loop_frame_ready();
+
+	start = vexSystemHighResTimeGet();
+	vdml_background_processing();
+	_stage_end(E_DAEMON_STAGE_REGISTRY, start);
 }
 
 static void _system_daemon_task(void* ign) {
@@ -113,6 +175,9 @@ static void _system_daemon_task(void* ign) {
 			    task_state == E_TASK_STATE_SUSPENDED) {
 				task_delete(competition_task);
 			}
+			// The motors were stopped while disabled, so the new task's first
+			// commands must reach them even if they match the old task's last ones
+			motor_command_invalidate_all();
 
 			competition_task = task_create_static(task_fns[state], NULL, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT,
 			                                      task_names[state], competition_task_stack, &competition_task_buffer);
@@ -122,6 +187,20 @@ static void _system_daemon_task(void* ign) {
 	}
 }
 
+int32_t daemon_get_stage_stats(daemon_stage_e_t stage, daemon_stage_stats_s_t* const stats) {
+	if (stage >= E_DAEMON_STAGE_COUNT || stats == NULL) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	seqlock_read(&stage_stats_lock, stats, &stage_stats[stage], sizeof(daemon_stage_stats_s_t));
+	return 1;
+}
+
+int32_t daemon_reset_stage_stats(void) {
+	stage_stats_reset_pending = true;
+	return 1;
+}
+
 void system_daemon_initialize() {
 	system_daemon_task = task_create_static(_system_daemon_task, NULL, TASK_PRIORITY_MAX - 2, TASK_STACK_DEPTH_DEFAULT,
 	                                        "PROS System Daemon", system_daemon_task_stack, &system_daemon_task_buffer);
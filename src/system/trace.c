@@ -0,0 +1,142 @@
+/**
+ * \file system/trace.c
+ *
+ * Kernel trace recorder
+ *
+ * Events are recorded from scheduler hooks, from any task and from interrupts,
+ * so the ring is lock-free: a writer claims a slot by advancing the head with a
+ * compare-and-swap, fills it in, and publishes it by writing its type last.
+ * The system daemon is the only reader. It stops at the first slot which
+ * hasn't been published yet, and frees slots by advancing the tail. When the
+ * ring is full new events are dropped and counted, and the count is sent as an
+ * event of its own once there is room again.
+ *
+ * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include "kapi.h"
+#include "system/optimizers.h"
+#include "system/trace.h"
+#include "v5_api.h"
+
+// NOTE: can't just include task.h because of redefinition that goes on in kapi
+//       include chain, so we just prototype what we need here
+void vTaskForEachTask(void (*pxCallback)(task_t, void*), void* pvArg);
+
+#include "rtos/tcb.h"
+
+// Must be a power of 2
+#define TRACE_RING_LENGTH 1024
+// Most events sent in one frame, so one flush can't take over the whole
+// serial output buffer
+#define TRACE_FLUSH_MAX 64
+
+volatile uint32_t trace_mask = 0;
+
+static trace_event_s_t ring[TRACE_RING_LENGTH];
+static uint32_t ring_head = 0;  // next slot to claim
+static uint32_t ring_tail = 0;  // next slot to send
+static uint32_t dropped = 0;
+
+static trace_event_s_t flush_buf[TRACE_FLUSH_MAX];
+
+extern size_t ser_output_free(void);
+extern bool ser_output_write_stream(uint32_t stream_id, const uint8_t* buf, size_t len);
+
+static void _trace_record(uint8_t type, uint8_t data, uint16_t task, uint32_t arg, uint32_t extra) {
+	uint32_t head = __atomic_load_n(&ring_head, __ATOMIC_RELAXED);
+	do {
+		if (head - __atomic_load_n(&ring_tail, __ATOMIC_ACQUIRE) >= TRACE_RING_LENGTH) {
+			__atomic_fetch_add(&dropped, 1, __ATOMIC_RELAXED);
+			return;
+		}
+	} while (!__atomic_compare_exchange_n(&ring_head, &head, head + 1, true, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED));
+
+	trace_event_s_t* event = &ring[head & (TRACE_RING_LENGTH - 1)];
+	event->time = (uint32_t)vexSystemHighResTimeGet();
+	event->data = data;
+	event->task = task;
+	event->arg = arg;
+	event->extra = extra;
+	__atomic_store_n(&event->type, type, __ATOMIC_RELEASE);
+}
+
+void trace_record(uint8_t type, uint8_t data, uint32_t arg, uint32_t extra) {
+	_trace_record(type, data, pxCurrentTCB ? pxCurrentTCB->uxTCBNumber : 0, arg, extra);
+}
+
+void trace_record_task_name(uint16_t task, const char* name) {
+	char buf[configMAX_TASK_NAME_LEN] = {0};
+	strncpy(buf, name, sizeof(buf) - 1);
+	for (uint8_t i = 0; i < sizeof(buf) / 8; i++) {
+		uint32_t chunk[2];
+		memcpy(chunk, buf + i * 8, 8);
+		_trace_record(E_TRACE_TASK_NAME, i, task, chunk[0], chunk[1]);
+		if (!buf[i * 8 + 7]) break;
+	}
+}
+
+static void _record_name_cb(task_t task, void* ign) {
+	TCB_t* tcb = (TCB_t*)task;
+	trace_record_task_name(tcb->uxTCBNumber, tcb->pcTaskName);
+}
+
+int32_t trace_start(uint32_t events) {
+	if (!events || (events & ~TRACE_ALL)) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	serctl(SERCTL_ACTIVATE, (void*)TRACE_STREAM_ID);
+	bool running = trace_mask;
+	trace_mask = events;
+	// Tasks created from now on are named by traceTASK_CREATE
+	if (!running) vTaskForEachTask(_record_name_cb, NULL);
+	return 1;
+}
+
+int32_t trace_stop(void) {
+	trace_mask = 0;
+	return 1;
+}
+
+void trace_flush(void) {
+	uint32_t tail = ring_tail;
+	uint32_t head = __atomic_load_n(&ring_head, __ATOMIC_ACQUIRE);
+	uint32_t lost = __atomic_load_n(&dropped, __ATOMIC_RELAXED);
+	if (likely(tail == head && !lost)) return;
+
+	// A frame of n events takes up to 16n + 16n/254 + 6 bytes once it's been
+	// COBS encoded and prefixed with the stream ID. Half of the output buffer is
+	// left for everything else.
+	size_t budget = ser_output_free() / 2;
+	size_t max = budget > 6 ? (budget - 6) * 254 / (255 * sizeof(trace_event_s_t)) : 0;
+	if (max > TRACE_FLUSH_MAX) max = TRACE_FLUSH_MAX;
+
+	size_t n = 0;
+	if (lost && n < max) {
+		__atomic_fetch_sub(&dropped, lost, __ATOMIC_RELAXED);
+		flush_buf[n++] = (trace_event_s_t){.time = (uint32_t)vexSystemHighResTimeGet(),
+		                                   .type = E_TRACE_DROPPED,
+		                                   .arg = lost};
+	}
+	while (tail != head && n < max) {
+		trace_event_s_t* event = &ring[tail & (TRACE_RING_LENGTH - 1)];
+		if (!__atomic_load_n(&event->type, __ATOMIC_ACQUIRE)) break;
+		flush_buf[n++] = *event;
+		event->type = 0;
+		tail++;
+	}
+	__atomic_store_n(&ring_tail, tail, __ATOMIC_RELEASE);
+
+	if (n && !ser_output_write_stream(TRACE_STREAM_ID, (uint8_t*)flush_buf, n * sizeof(trace_event_s_t))) {
+		__atomic_fetch_add(&dropped, n, __ATOMIC_RELAXED);
+	}
+}
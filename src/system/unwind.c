@@ -22,6 +22,7 @@
 #include "rtos/task.h"
 #include "rtos/tcb.h"
 #include "system/hot.h"
+#include "system/profiler.h"
 
 #include "v5_api.h"
 
@@ -218,3 +219,82 @@ void backtrace_task(task_t task) {
 	__gnu_Unwind_Backtrace(trace_fn, NULL, &vrs);
 	printf("finished trace\n");
 }
+
+/******************************************************************************/
+/**                       Sampling Profiler Unwinding                        **/
+/**                                                                          **/
+/** While the profiler runs, FreeRTOS_IRQ_Handler saves the context of the   **/
+/** code it interrupted into ulPortInterruptedContext (r4-r11, sp, lr, pc    **/
+/** and cpsr), and the tick hook unwinds from there                          **/
+/******************************************************************************/
+extern volatile uint32_t ulPortInterruptedContext[12];
+
+#define CPSR_MODE_MASK 0x1F
+#define CPSR_MODE_USR 0x10
+#define CPSR_MODE_SYS 0x1F
+
+struct interrupted_trace {
+	uint32_t* pcs;
+	size_t count;
+	size_t max;
+	_uw lr;  // lr of the interrupted code
+	_uw sp;  // sp of the last frame
+};
+
+static _Unwind_Reason_Code interrupted_trace_fn(_Unwind_Context* unwind_ctx, void* d) {
+	struct interrupted_trace* trace = (struct interrupted_trace*)d;
+	uint32_t pc = _Unwind_GetIP(unwind_ctx);
+	_uw sp = _Unwind_GetGR(unwind_ctx, 13);  // r13 is sp
+	// The first frame is the interrupted pc, which has already been stored
+	if (trace->count == 1 && pc == trace->pcs[0] && sp == trace->sp) {
+		trace->sp = sp;
+		return _URC_NO_REASON;
+	}
+	// The unwinder starts from lr, so lr holds the interrupted pc and a leaf
+	// function which never saved lr unwinds to itself. The real lr is its
+	// caller, but nothing can be found past that.
+	if (pc == trace->pcs[trace->count - 1] && sp == trace->sp) {
+		trace->pcs[trace->count++] = trace->lr;
+		return _URC_FAILURE;
+	}
+	// Frames only ever move up the stack
+	if (sp < trace->sp) {
+		return _URC_FAILURE;
+	}
+	trace->pcs[trace->count++] = pc;
+	trace->sp = sp;
+	extern void task_clean_up();
+	if (trace->count == trace->max || pc == (uint32_t)task_clean_up) {
+		return _URC_FAILURE;
+	}
+	return _URC_NO_REASON;
+}
+
+// called by profiler_tick in system/profiler.c
+size_t backtrace_interrupted(uint32_t* pcs, size_t max) {
+	const volatile uint32_t* ctx = ulPortInterruptedContext;
+	if (!max || !ctx[10]) {
+		return 0;
+	}
+	pcs[0] = ctx[10];
+
+	// Only a task's own stack can be unwound. Anything else (e.g. the kernel
+	// handling a yield in supervisor mode) just gets its pc.
+	uint32_t mode = ctx[11] & CPSR_MODE_MASK;
+	_uw sp = ctx[8];
+	if (max == 1 || (mode != CPSR_MODE_SYS && mode != CPSR_MODE_USR) || !pxCurrentTCB ||
+	    sp < (_uw)pxCurrentTCB->pxStack) {
+		return 1;
+	}
+
+	struct phase2_vrs vrs = {0};
+	for (size_t i = 0; i < 8; i++) {
+		vrs.core.r[4 + i] = ctx[i];
+	}
+	vrs.core.r[13] = sp;       // r13 is sp
+	vrs.core.r[14] = ctx[10];  // r14 is lr, see interrupted_trace_fn
+	vrs.core.r[15] = ctx[10];  // r15 is pc
+	struct interrupted_trace trace = {.pcs = pcs, .count = 1, .max = max, .lr = ctx[9], .sp = sp};
+	__gnu_Unwind_Backtrace(interrupted_trace_fn, &trace, &vrs);
+	return trace.count;
+}
@@ -0,0 +1,59 @@
+/**
+ * \file tests/control_loop.c
+ *
+ * Test code for the kernel control loop scheduler
+ *
+ * Runs a 1 ms and a 10 ms loop and prints their timing statistics on the LCD.
+ * The periods should stay within a few microseconds of nominal while opcontrol
+ * keeps the CPU busy, and the 1 ms loop's counter should keep increasing
+ * after it is removed and re-registered.
+ *
+ * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "main.h"
+
+static void count_loop(void* counter) {
+	(*(uint32_t*)counter)++;
+}
+
+static void busy_loop(void* ignore) {
+	volatile uint32_t x = 0;
+	for (uint32_t i = 0; i < 2000; i++) x += i;
+}
+
+static void print_stats(int line, const char* name, control_loop_t loop) {
+	control_loop_stats_s_t stats;
+	control_loop_get_stats(loop, &stats);
+	lcd_print(line, "%s: %u runs %u over, period %u-%u us", name, stats.runs, stats.overruns, stats.period_min,
+	          stats.period_max);
+	lcd_print(line + 1, "  jitter max %u p99 %u, exec max %u p99 %u", stats.jitter_max, stats.jitter_p99,
+	          stats.exec_max, stats.exec_p99);
+}
+
+void opcontrol() {
+	uint32_t counter = 0;
+	control_loop_t fast = control_loop_register(count_loop, &counter, 1);
+	control_loop_t slow = control_loop_register(busy_loop, NULL, 10);
+
+	uint32_t start = millis();
+	while (true) {
+		print_stats(0, "1ms", fast);
+		print_stats(2, "10ms", slow);
+		lcd_print(4, "counter %u after %u ms", counter, millis() - start);
+
+		if (millis() - start > 10000) {
+			control_loop_remove(fast);
+			fast = control_loop_register(count_loop, &counter, 1);
+			start = millis();
+		}
+		// Keep the CPU busy at a lower priority than the control loops
+		for (volatile uint32_t i = 0; i < 100000; i++)
+			;
+		delay(20);
+	}
+}
@@ -0,0 +1,183 @@
+/**
+ * \file tests/heap_bench.c
+ *
+ * Benchmark for the kernel heap (kmalloc/kfree)
+ *
+ * Replays a pseudo-random trace of allocations and frees shaped like what the
+ * kernel heap sees at run time: mostly small objects (VFS file arguments,
+ * std::function tasks, LVGL objects) with the occasional large buffer. Every
+ * call is timed with interrupts masked, and at the end the heap's free space is
+ * compared to its largest free block to show how fragmented it became. The trace
+is replayed a few times from an empty heap, which puts the heap through exactly
+the same states each time, and each call's fastest time is kept so that
+preemption by the host OS doesn't show up as allocator latency.
+ *
+ * The trace is the same every run, so building it against heap_4.c and against
+ * heap_tlsf.c compares the two directly. On the host:
+ *
+ *   make -C host TEST=heap_bench && ./host/bin/heap_bench
+ *   make -C host TEST=heap_bench HEAP=tlsf && ./host/bin-tlsf/heap_bench
+ *
+ * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "main.h"
+
+#ifdef PROS_HOST
+#include <time.h>
+#endif
+
+// NOTE: can't include the FreeRTOS headers alongside the PROS API, so we just
+//       prototype what we need here
+void* kmalloc(size_t size);
+void kfree(void* ptr);
+size_t xPortGetFreeHeapSize(void);
+size_t xPortGetMinimumEverFreeHeapSize(void);
+size_t xPortGetLargestFreeBlockSize(void);
+void vPortEnterCritical(void);
+void vPortExitCritical(void);
+
+#define SLOTS 1536
+#define OPERATIONS 100000
+#define RUNS 5
+// Latencies are histogrammed to the nanosecond up to this
+#define HISTOGRAM_MAX 20000
+
+typedef struct latency {
+	uint32_t histogram[HISTOGRAM_MAX + 1];
+	uint32_t count;
+	uint32_t max;
+} latency_s_t;
+
+static void* slots[SLOTS];
+static uint32_t fastest[OPERATIONS];
+static bool is_free[OPERATIONS];
+static latency_s_t alloc_latency;
+static latency_s_t free_latency;
+
+static uint32_t rng_state = 0x12345678;
+
+static uint32_t rng(void) {
+	// xorshift32
+	rng_state ^= rng_state << 13;
+	rng_state ^= rng_state >> 17;
+	rng_state ^= rng_state << 5;
+	return rng_state;
+}
+
+static uint32_t rng_range(uint32_t min, uint32_t max) {
+	return min + rng() % (max - min + 1);
+}
+
+static size_t random_size(void) {
+	uint32_t kind = rng() % 100;
+	if (kind < 70) return rng_range(8, 128);
+	if (kind < 95) return rng_range(129, 1024);
+	if (kind < 99) return rng_range(1025, 8192);
+	return rng_range(16384, 32768);
+}
+
+// On the V5 this is only good to the microsecond
+static inline uint32_t now_ns(void) {
+#ifdef PROS_HOST
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32_t)((uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec);
+#else
+	return (uint32_t)(micros() * 1000);
+#endif
+}
+
+static void record(latency_s_t* latency, uint32_t ns) {
+	latency->histogram[ns < HISTOGRAM_MAX ? ns : HISTOGRAM_MAX]++;
+	latency->count++;
+	if (ns > latency->max) latency->max = ns;
+}
+
+static uint32_t percentile(latency_s_t* latency, uint32_t permyriad) {
+	uint64_t target = (uint64_t)latency->count * permyriad / 10000;
+	uint64_t seen = 0;
+	for (uint32_t i = 0; i <= HISTOGRAM_MAX; i++) {
+		seen += latency->histogram[i];
+		if (seen > target) return i;
+	}
+	return HISTOGRAM_MAX;
+}
+
+static void print_latency(const char* name, latency_s_t* latency) {
+	printf("%-6s %8u calls  p50 %5u ns  p99 %5u ns  p99.9 %5u ns  max %6u ns\n", name, latency->count,
+	       percentile(latency, 5000), percentile(latency, 9900), percentile(latency, 9990), latency->max);
+}
+
+void opcontrol() {
+	// Warm up the heap (heap_4 and heap_tlsf set themselves up on the first call)
+	kfree(kmalloc(1));
+	size_t initial_free = xPortGetFreeHeapSize();
+
+	uint32_t overhead = UINT32_MAX;
+	for (int i = 0; i < 1000; i++) {
+		uint32_t start = now_ns();
+		uint32_t ns = now_ns() - start;
+		if (ns < overhead) overhead = ns;
+	}
+
+	size_t live_bytes, peak_live_bytes = 0;
+	for (uint32_t run = 0; run < RUNS; run++) {
+		rng_state = 0x12345678;
+		live_bytes = 0;
+		for (uint32_t i = 0; i < OPERATIONS; i++) {
+			uint32_t slot = rng() % SLOTS;
+			uint32_t start, ns;
+			if (slots[slot]) {
+				live_bytes -= *(size_t*)slots[slot];
+				vPortEnterCritical();
+				start = now_ns();
+				kfree(slots[slot]);
+				ns = now_ns() - start;
+				vPortExitCritical();
+				slots[slot] = NULL;
+			} else {
+				size_t size = random_size();
+				vPortEnterCritical();
+				start = now_ns();
+				slots[slot] = kmalloc(size);
+				ns = now_ns() - start;
+				vPortExitCritical();
+				*(size_t*)slots[slot] = size;
+				live_bytes += size;
+				if (live_bytes > peak_live_bytes) peak_live_bytes = live_bytes;
+			}
+			if (!run || ns < fastest[i]) fastest[i] = ns;
+			is_free[i] = !slots[slot];
+		}
+		if (run == RUNS - 1) break;
+		for (uint32_t i = 0; i < SLOTS; i++) {
+			kfree(slots[i]);
+			slots[i] = NULL;
+		}
+	}
+
+	for (uint32_t i = 0; i < OPERATIONS; i++) {
+		record(is_free[i] ? &free_latency : &alloc_latency, fastest[i] > overhead ? fastest[i] - overhead : 0);
+	}
+
+	size_t free_bytes = xPortGetFreeHeapSize();
+	size_t largest = xPortGetLargestFreeBlockSize();
+	printf("kernel heap benchmark: %u operations over %u slots, timer overhead %u ns\n", OPERATIONS, SLOTS, overhead);
+	print_latency("kmalloc", &alloc_latency);
+	print_latency("kfree", &free_latency);
+	printf("live %u bytes (peak %u), free %u bytes, largest free block %u bytes, fragmentation %u.%u%%\n",
+	       (unsigned)live_bytes, (unsigned)peak_live_bytes, (unsigned)free_bytes, (unsigned)largest,
+	       (unsigned)(1000 - (uint64_t)largest * 1000 / free_bytes) / 10,
+	       (unsigned)(1000 - (uint64_t)largest * 1000 / free_bytes) % 10);
+	printf("minimum ever free %u bytes\n", (unsigned)xPortGetMinimumEverFreeHeapSize());
+
+	for (uint32_t i = 0; i < SLOTS; i++) kfree(slots[i]);
+	printf("heap %s to %u free bytes after freeing everything\n",
+	       xPortGetFreeHeapSize() == initial_free ? "returned" : "DID NOT RETURN", (unsigned)initial_free);
+	fflush(stdout);
+}
@@ -0,0 +1,145 @@
+/**
+ * \file tests/heap_trace.c
+ *
+ * Test for heap statistics and heap tracing
+ *
+ * Checks that freeing every other block of a run splits the kernel heap's free
+ * space into more blocks, then traces two tasks which allocate from different
+ * sites and checks that each site and task is charged what it still holds, and
+ * nothing once it frees. Last it allocates more blocks than the trace holds,
+ * prints the heap report, and checks that it is truncated to fit a small
+ * buffer.
+ *
+ * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "main.h"
+#include "pros/apix.h"
+
+// NOTE: can't include the FreeRTOS headers alongside the PROS API, so we just
+//       prototype what we need here
+void* kmalloc(size_t size);
+void kfree(void* ptr);
+size_t format_heap_stats(char* buffer, size_t size);
+void print_heap_stats(void);
+
+#define BLOCKS 20
+#define OVERFLOW 1000
+
+static volatile uint32_t errors = 0;
+static volatile uint32_t finished = 0;
+
+#define check(cond)                                 \
+	do {                                              \
+		if (!(cond)) {                                  \
+			printf("line %d: %s failed\n", __LINE__, #cond); \
+			errors++;                                     \
+		}                                               \
+	} while (0)
+
+static void* blocks[OVERFLOW];
+
+// Kept out of line, so that each is its own allocation site
+static __attribute__((noinline)) void* alloc_small(void) {
+	return kmalloc(24);
+}
+
+static __attribute__((noinline)) void* alloc_large(void) {
+	return kmalloc(1000);
+}
+
+static void* held[2][BLOCKS];
+
+static void alloc_task(void* param) {
+	uint32_t id = (uint32_t)param;
+	for (size_t i = 0; i < BLOCKS; i++) held[id][i] = id ? alloc_large() : alloc_small();
+	finished++;
+}
+
+static heap_task_stats_s_t* find_task(heap_task_stats_s_t* tasks, int32_t count, const char* name) {
+	for (int32_t i = 0; i < count; i++) {
+		if (!strcmp(tasks[i].name, name)) return &tasks[i];
+	}
+	return NULL;
+}
+
+void opcontrol() {
+	heap_stats_s_t before, after;
+	heap_site_stats_s_t sites[8];
+	heap_task_stats_s_t tasks[8];
+
+	check(heap_get_stats(NULL) == PROS_ERR && errno == EINVAL);
+	for (size_t i = 0; i < BLOCKS; i++) blocks[i] = kmalloc(256);
+	heap_get_stats(&before);
+	for (size_t i = 0; i < BLOCKS; i += 2) kfree(blocks[i]);
+	heap_get_stats(&after);
+	check(after.free_blocks >= before.free_blocks + BLOCKS / 2 - 1);
+	check(after.free_bytes >= before.free_bytes + BLOCKS / 2 * 256);
+	check(after.frees == before.frees + BLOCKS / 2);
+	check(after.largest_free_block >= 256 && after.largest_free_block <= after.free_bytes);
+	check(after.min_free_bytes <= before.free_bytes);
+	for (size_t i = 1; i < BLOCKS; i += 2) kfree(blocks[i]);
+	printf("%u free bytes in %u blocks with every other block freed\n", (uint32_t)after.free_bytes,
+	       (uint32_t)after.free_blocks);
+
+	check(heap_trace_get_sites(sites, 8) == 0);
+	heap_trace_start();
+	task_create(alloc_task, (void*)0, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "small allocator");
+	task_create(alloc_task, (void*)1, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "large allocator");
+	while (finished < 2) task_delay(10);
+
+	int32_t site_count = heap_trace_get_sites(sites, 8);
+	int32_t task_count = heap_trace_get_tasks(tasks, 8);
+	// Creating the tasks allocated their stacks and TCBs from other sites
+	check(site_count >= 2 && task_count >= 2);
+	for (int32_t i = 1; i < site_count; i++) check(sites[i].bytes <= sites[i - 1].bytes);
+	int32_t small = -1, large = -1;
+	for (int32_t i = 0; i < site_count; i++) {
+		if (sites[i].allocs == BLOCKS && sites[i].blocks == BLOCKS) {
+			if (sites[i].bytes >= BLOCKS * 24 && sites[i].bytes < BLOCKS * 64) small = i;
+			if (sites[i].bytes >= BLOCKS * 1000 && sites[i].bytes < BLOCKS * 1040) large = i;
+		}
+	}
+	check(small >= 0 && large >= 0 && large < small);
+	check(large >= 0 && sites[large].heap == E_HEAP_KERNEL && sites[large].failures == 0);
+	heap_task_stats_s_t* small_task = find_task(tasks, task_count, "small allocator");
+	heap_task_stats_s_t* large_task = find_task(tasks, task_count, "large allocator");
+	check(small_task && small >= 0 && small_task->allocs == BLOCKS && small_task->bytes == sites[small].bytes);
+	check(large_task && large >= 0 && large_task->blocks == BLOCKS && large_task->max_bytes == sites[large].bytes);
+
+	for (size_t i = 0; i < BLOCKS; i++) {
+		kfree(held[0][i]);
+		kfree(held[1][i]);
+	}
+	site_count = heap_trace_get_sites(sites, 8);
+	task_count = heap_trace_get_tasks(tasks, 8);
+	small_task = find_task(tasks, task_count, "small allocator");
+	large_task = find_task(tasks, task_count, "large allocator");
+	check(small_task && small_task->blocks == 0 && small_task->bytes == 0 && small_task->allocs == BLOCKS);
+	check(large_task && large_task->bytes == 0 && large_task->max_bytes >= BLOCKS * 1000);
+	printf("two tasks traced, %u errors\n", errors);
+
+	for (size_t i = 0; i < OVERFLOW; i++) blocks[i] = kmalloc(16);
+	check(heap_trace_get_untracked() >= OVERFLOW - 768);
+	print_heap_stats();
+	// The malloc failed hook formats the report into a fixed buffer
+	char truncated[64];
+	check(format_heap_stats(truncated, sizeof(truncated)) == sizeof(truncated) - 1 && strlen(truncated) == sizeof(truncated) - 1);
+	for (size_t i = 0; i < OVERFLOW; i++) kfree(blocks[i]);
+	task_count = heap_trace_get_tasks(tasks, 8);
+	heap_task_stats_s_t* self = find_task(tasks, task_count, "User Operator Control (PROS)");
+	check(self && self->allocs >= OVERFLOW && self->bytes == 0);
+
+	heap_trace_stop();
+	void* late = kmalloc(16);
+	check(heap_trace_get_tasks(tasks, 8) == task_count);
+	self = find_task(tasks, task_count, "User Operator Control (PROS)");
+	check(self && self->allocs >= OVERFLOW && self->bytes == 0);
+	kfree(late);
+	printf("%s\n", errors ? "FAILED" : "PASSED");
+	fflush(stdout);
+}
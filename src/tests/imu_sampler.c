@@ -0,0 +1,70 @@
+/**
+ * \file tests/imu_sampler.c
+ *
+ * Test for reading the kernel IMU sampler
+ *
+ * Lets the sampler run until it has overwritten its buffer before reading
+ * from a cursor of 0, which must skip to the oldest sample that can still be
+ * read instead of spinning, then checks that a reader which keeps up gets every
+ * sample in order.
+ *
+ * NOTE: Needs an Inertial Sensor in IMU_PORT. On the host port, run with
+ * PROS_HOST_IMU_PORT=6 in the environment.
+ *
+ * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "main.h"
+
+#define IMU_PORT 6
+
+static volatile uint32_t errors = 0;
+
+#define check(cond)                                      \
+	do {                                                   \
+		if (!(cond)) {                                       \
+			printf("line %d: %s failed\n", __LINE__, #cond); \
+			errors++;                                          \
+		}                                                    \
+	} while (0)
+
+void opcontrol() {
+	imu_sample_s_t samples[IMU_SAMPLER_BUFFER_SIZE];
+	uint32_t cursor = 0;
+
+	check(imu_sampler_enable(IMU_PORT, E_IMU_FILTER_COMPLEMENTARY, 0) == 1);
+	// At the default data rate of 10 ms, well past the buffer's worth
+	delay(IMU_SAMPLER_BUFFER_SIZE * 10 * 2);
+	int32_t read = imu_sampler_read(IMU_PORT, &cursor, samples, IMU_SAMPLER_BUFFER_SIZE);
+	printf("fallen behind reader: %d samples, cursor %u\n", read, cursor);
+	check(read > 0 && read < IMU_SAMPLER_BUFFER_SIZE);
+	check(cursor > IMU_SAMPLER_BUFFER_SIZE);
+	for (int32_t i = 1; i < read; i++) check(samples[i].timestamp > samples[i - 1].timestamp);
+
+	// A cursor from the future is treated like one which fell behind
+	uint32_t invalid = cursor + 1000;
+	check(imu_sampler_read(IMU_PORT, &invalid, samples, 1) == 1 && invalid <= cursor + 1);
+
+	uint32_t total = 0;
+	uint32_t last = 0;
+	for (uint32_t i = 0; i < 50; i++) {
+		delay(5);
+		uint32_t start = cursor;
+		read = imu_sampler_read(IMU_PORT, &cursor, samples, IMU_SAMPLER_BUFFER_SIZE);
+		check(read >= 0 && cursor == start + read);
+		for (int32_t j = 0; j < read; j++) {
+			check(samples[j].timestamp > last);
+			last = samples[j].timestamp;
+		}
+		total += read;
+	}
+	printf("reader keeping up: %u samples\n", total);
+	check(total > 0);
+	imu_sampler_disable(IMU_PORT);
+	printf("%s\n", errors ? "FAILED" : "PASSED");
+	fflush(stdout);
+}
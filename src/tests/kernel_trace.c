@@ -0,0 +1,64 @@
+/**
+ * \file tests/kernel_trace.c
+ *
+ * Test code for the kernel trace recorder
+ *
+ * Traces a priority inversion: a low priority task holds a mutex which a high
+ * priority task then waits for, while a medium priority task spins. Convert a
+ * capture of the serial output with trace-to-json.py; the low priority task
+ * should inherit the high priority while the high priority task is blocked on
+ * the mutex, and so run ahead of the medium priority task.
+ *
+ * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "main.h"
+#include "pros/apix.h"
+
+static mutex_t mutex;
+
+static void spin(uint32_t us) {
+	uint64_t start = micros();
+	while (micros() - start < us)
+		;
+}
+
+static void low_task(void* ignore) {
+	while (true) {
+		mutex_take(mutex, TIMEOUT_MAX);
+		spin(2000);
+		mutex_give(mutex);
+		delay(10);
+	}
+}
+
+static void medium_task(void* ignore) {
+	while (true) {
+		delay(11);
+		spin(3000);
+	}
+}
+
+static void high_task(void* ignore) {
+	while (true) {
+		delay(11);
+		mutex_take(mutex, TIMEOUT_MAX);
+		spin(100);
+		mutex_give(mutex);
+	}
+}
+
+void opcontrol() {
+	mutex = mutex_create();
+	trace_start(TRACE_SCHEDULING | TRACE_INTERRUPTS);
+	task_create(low_task, NULL, TASK_PRIORITY_DEFAULT - 1, TASK_STACK_DEPTH_DEFAULT, "low");
+	task_create(medium_task, NULL, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "medium");
+	task_create(high_task, NULL, TASK_PRIORITY_DEFAULT + 1, TASK_STACK_DEPTH_DEFAULT, "high");
+	delay(1000);
+	trace_stop();
+	lcd_print(0, "trace stopped");
+}
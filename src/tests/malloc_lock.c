@@ -0,0 +1,130 @@
+/**
+ * \file tests/malloc_lock.c
+ *
+ * Benchmark for the newlib malloc lock
+ *
+ * A task standing in for a control task runs just below the system daemon and
+ * waits for notifications. A low priority task keeps holding the allocator
+ * lock for HOLD_US at a time, as a long allocation such as a realloc() copying
+ * a large block would, and notifies the control task halfway through. The
+ * control task measures how long after the notification it runs, and how long
+ * its own malloc() and free() then take. This is run without the lock, with
+ * the allocator serialized by suspending the scheduler as __malloc_lock() used
+ * to do, and with __malloc_lock() itself.
+ *
+ * With the scheduler suspended the control task only runs once the allocation
+ * is done, whether or not it allocates. With the mutex it runs right away, and
+ * only its own allocation waits for the rest of the one in progress.
+ *
+ * On the host newlib isn't used, so both tasks take the lock around their
+ * allocations themselves. The lock is recursive, so on the V5 the
+ * allocations inside just take it again.
+ *
+ * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "main.h"
+
+void __malloc_lock(void);
+void __malloc_unlock(void);
+void rtos_suspend_all(void);
+int32_t rtos_resume_all(void);
+
+#define SAMPLES 2000
+#define HOLD_US 200
+
+typedef struct lock_kind {
+	const char* name;
+	void (*lock)(void);
+	void (*unlock)(void);
+} lock_kind_s_t;
+
+static void no_lock(void) {}
+
+static void suspend_lock(void) {
+	rtos_suspend_all();
+}
+
+static void suspend_unlock(void) {
+	rtos_resume_all();
+}
+
+static const lock_kind_s_t kinds[] = {{"no lock", no_lock, no_lock},
+                                      {"suspend all", suspend_lock, suspend_unlock},
+                                      {"malloc mutex", __malloc_lock, __malloc_unlock}};
+
+static const lock_kind_s_t* volatile kind;
+static task_t control_task;
+static volatile uint64_t notified_at;
+
+static uint32_t rng_state = 0x12345678;
+
+static void churn_until(uint64_t end) {
+	while (micros() < end) {
+		rng_state ^= rng_state << 13;
+		rng_state ^= rng_state >> 17;
+		rng_state ^= rng_state << 5;
+		free(malloc(16 + rng_state % 4096));
+	}
+}
+
+static void allocator_task(void* ignore) {
+	for (uint32_t n = 0; n < SAMPLES; n++) {
+		kind->lock();
+		uint64_t start = micros();
+		churn_until(start + HOLD_US / 2);
+		notified_at = micros();
+		task_notify(control_task);
+		churn_until(start + HOLD_US);
+		kind->unlock();
+		task_delay(1);
+	}
+}
+
+static uint32_t percentile(uint32_t* sorted, uint32_t permyriad) {
+	return sorted[(uint64_t)SAMPLES * permyriad / 10000];
+}
+
+static int compare(const void* a, const void* b) {
+	uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+	return x < y ? -1 : x > y;
+}
+
+static void print_latency(const char* name, uint32_t* samples) {
+	qsort(samples, SAMPLES, sizeof(uint32_t), compare);
+	printf("  %-12s p50 %4u us  p99 %4u us  max %4u us\n", name, percentile(samples, 5000),
+	       percentile(samples, 9900), samples[SAMPLES - 1]);
+}
+
+static uint32_t late[SAMPLES];
+static uint32_t alloc[SAMPLES];
+
+void opcontrol() {
+	control_task = task_get_current();
+	task_set_priority(CURRENT_TASK, TASK_PRIORITY_MAX - 3);
+	printf("malloc lock benchmark: allocator lock held for %u us at a time\n", HOLD_US);
+
+	for (size_t k = 0; k < sizeof(kinds) / sizeof(kinds[0]); k++) {
+		kind = &kinds[k];
+		task_create(allocator_task, NULL, TASK_PRIORITY_MIN + 1, TASK_STACK_DEPTH_DEFAULT, "Allocator");
+		for (uint32_t n = 0; n < SAMPLES; n++) {
+			task_notify_take(true, TIMEOUT_MAX);
+			uint64_t now = micros();
+			late[n] = (uint32_t)(now - notified_at);
+			kind->lock();
+			free(malloc(64));
+			kind->unlock();
+			alloc[n] = (uint32_t)(micros() - now);
+		}
+		printf("%s\n", kind->name);
+		print_latency("wake up", late);
+		print_latency("malloc+free", alloc);
+		// Let the allocator task finish its last allocation
+		task_delay(5);
+	}
+	fflush(stdout);
+}
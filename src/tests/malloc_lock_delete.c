@@ -0,0 +1,99 @@
+/**
+ * \file tests/malloc_lock_delete.c
+ *
+ * Test for deleting a task in the middle of an allocation
+ *
+ * A low priority task takes the allocator lock and is preempted while holding
+ * it by a higher priority task which deletes it, as the system daemon deletes
+ * the competition task. The delete must wait for the lock to be given back.
+ * Then a new task is created in the same buffer, which must be able to
+ * take the lock without finding it held by the old task, and so must every
+ * other task afterwards.
+ *
+ * On the host newlib isn't used, so the victim takes the lock itself. On the
+ * V5 a malloc() inside it would just take it again.
+ *
+ * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "main.h"
+#include "pros/apix.h"
+
+void __malloc_lock(void);
+void __malloc_unlock(void);
+
+#define HOLD_US 20000
+
+static volatile uint32_t errors = 0;
+
+#define check(cond)                                      \
+	do {                                                   \
+		if (!(cond)) {                                       \
+			printf("line %d: %s failed\n", __LINE__, #cond); \
+			errors++;                                          \
+		}                                                    \
+	} while (0)
+
+static uint32_t victim_stack[TASK_STACK_DEPTH_DEFAULT];
+static task_buffer_s_t victim_buffer;
+
+static volatile bool locked = false;
+static volatile bool finished = false;
+static volatile bool reused = false;
+
+static void victim_task(void* ignore) {
+	__malloc_lock();
+	locked = true;
+	// Stand in for a long allocation, such as a realloc() copying a large block
+	uint64_t start = micros();
+	while (micros() - start < HOLD_US) {}
+	// The task deleting us runs as soon as the lock is given
+	finished = true;
+	__malloc_unlock();
+	while (true) {
+		task_delay(1000);
+	}
+}
+
+static void reuse_task(void* ignore) {
+	__malloc_lock();
+	__malloc_lock();
+	__malloc_unlock();
+	__malloc_unlock();
+	reused = true;
+	while (true) {
+		task_delay(1000);
+	}
+}
+
+void opcontrol() {
+	task_set_priority(CURRENT_TASK, TASK_PRIORITY_DEFAULT + 1);
+	task_t victim = task_create_buffered(victim_task, NULL, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Victim",
+	                                     victim_stack, &victim_buffer);
+	// Let the victim get the lock, then preempt it while it holds it
+	while (!locked) task_delay(1);
+	check(!finished);
+	uint64_t start = micros();
+	task_delete(victim);
+	uint32_t waited = micros() - start;
+	printf("task_delete waited %u us for the allocation to finish\n", waited);
+	check(finished);
+
+	// The daemon creates the next competition task in the same buffer right away
+	task_t reuse = task_create_buffered(reuse_task, NULL, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Reuse",
+	                                    victim_stack, &victim_buffer);
+	start = millis();
+	while (!reused && millis() - start < 100) task_delay(1);
+	check(reused);
+	task_delete(reuse);
+
+	// Nobody else may be left holding the lock
+	__malloc_lock();
+	__malloc_unlock();
+	printf("%s\n", errors ? "FAILED" : "PASSED");
+	fflush(stdout);
+}
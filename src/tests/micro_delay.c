@@ -0,0 +1,70 @@
+/**
+ * \file tests/micro_delay.c
+ *
+ * Jitter benchmark for microsecond delays
+ *
+ * Measures how late task_delay_micros() ends for a range of delays, and how
+ * far the periods of a 250 us task_delay_until_micros() loop stray from
+ * nominal. The task runs just below the system daemon so that only the daemon
+ * and the control loop task can preempt it. Every delay should end within a
+ * few microseconds of its target, except when one of those two runs.
+ *
+ * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "main.h"
+
+#define SAMPLES 1000
+
+static const uint32_t delays[] = {10, 100, 500, 999, 1000, 1500, 4321};
+
+// How many samples were late by at most 1, 10, 100 and 1000 us, and more
+static void print_overshoot(int line, const char* name, uint32_t* late, uint32_t max) {
+	lcd_print(line, "%s: <=1 %u, <=10 %u, <=100 %u, <=1000 %u, more %u, max %u us", name, late[0], late[1],
+	          late[2], late[3], late[4], max);
+}
+
+static void record(uint32_t* late, uint32_t* max, uint32_t over) {
+	if (over > *max) *max = over;
+	if (over <= 1)
+		late[0]++;
+	else if (over <= 10)
+		late[1]++;
+	else if (over <= 100)
+		late[2]++;
+	else if (over <= 1000)
+		late[3]++;
+	else
+		late[4]++;
+}
+
+void opcontrol() {
+	task_set_priority(CURRENT_TASK, TASK_PRIORITY_MAX - 3);
+	char name[16];
+
+	for (size_t i = 0; i < sizeof(delays) / sizeof(delays[0]); i++) {
+		uint32_t late[5] = {0};
+		uint32_t max = 0;
+		for (uint32_t n = 0; n < SAMPLES; n++) {
+			uint64_t start = micros();
+			task_delay_micros(delays[i]);
+			record(late, &max, (uint32_t)(micros() - start - delays[i]));
+		}
+		snprintf(name, sizeof(name), "%u us", delays[i]);
+		print_overshoot(i, name, late, max);
+	}
+
+	uint32_t late[5] = {0};
+	uint32_t max = 0;
+	uint64_t wake = micros();
+	for (uint32_t n = 0; n < SAMPLES * 4; n++) {
+		task_delay_until_micros(&wake, 250);
+		uint64_t now = micros();
+		record(late, &max, (uint32_t)(now - wake));
+	}
+	print_overshoot(sizeof(delays) / sizeof(delays[0]), "until 250 us", late, max);
+}
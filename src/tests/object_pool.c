@@ -0,0 +1,146 @@
+/**
+ * \file tests/object_pool.c
+ *
+ * Test for fixed-size object pools
+ *
+ * Checks that a pool hands out every object once, refuses to allocate when
+ * empty and to free pointers which aren't its objects, and keeps count. Then
+ * several tasks of the same priority allocate and free objects from one pool
+ * at once while the tick switches between them, each writing its own pattern
+ * into the objects it holds and checking nobody else changed it. Last it times
+ * pool_alloc and pool_free against kmalloc and kfree for objects of the same
+ * size.
+ *
+ * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "main.h"
+#include "pros/apix.h"
+
+// NOTE: can't include the FreeRTOS headers alongside the PROS API, so we just
+//       prototype what we need here
+void* kmalloc(size_t size);
+void kfree(void* ptr);
+
+#define OBJ_SIZE 20
+#define COUNT 32
+#define TASKS 4
+#define HELD 10
+#define ROUNDS 200000
+#define TIMED 1000
+
+static static_pool_s_t pool_buf;
+static uint8_t pool_storage[POOL_STORAGE_SIZE(OBJ_SIZE, COUNT)] __attribute__((aligned(8)));
+static pool_t pool;
+
+static volatile uint32_t errors = 0;
+static volatile uint32_t finished = 0;
+
+#define check(cond)                                 \
+	do {                                              \
+		if (!(cond)) {                                  \
+			printf("line %d: %s failed\n", __LINE__, #cond); \
+			errors++;                                     \
+		}                                               \
+	} while (0)
+
+static void stress_task(void* param) {
+	uint32_t id = (uint32_t)param;
+	uint32_t* held[HELD] = {NULL};
+	uint32_t rng = 0x9e3779b9 * (id + 1);
+	for (uint32_t i = 0; i < ROUNDS; i++) {
+		rng ^= rng << 13;
+		rng ^= rng >> 17;
+		rng ^= rng << 5;
+		uint32_t slot = rng % HELD;
+		if (held[slot]) {
+			for (size_t w = 0; w < OBJ_SIZE / sizeof(uint32_t); w++) {
+				if (held[slot][w] != id) __atomic_fetch_add(&errors, 1, __ATOMIC_RELAXED);
+			}
+			pool_free(pool, held[slot]);
+			held[slot] = NULL;
+		} else if ((held[slot] = pool_alloc(pool)) != NULL) {
+			for (size_t w = 0; w < OBJ_SIZE / sizeof(uint32_t); w++) held[slot][w] = id;
+		}
+	}
+	for (size_t slot = 0; slot < HELD; slot++) {
+		if (held[slot]) pool_free(pool, held[slot]);
+	}
+	__atomic_fetch_add(&finished, 1, __ATOMIC_RELAXED);
+}
+
+static uint32_t elapsed_us(uint64_t start) {
+	return (uint32_t)(micros() - start);
+}
+
+void opcontrol() {
+	pool_stats_s_t stats;
+	void* objs[COUNT + 1];
+
+	check(pool_create_static(0, COUNT, pool_storage, &pool_buf) == NULL && errno == EINVAL);
+	check(pool_create_static(OBJ_SIZE, COUNT, pool_storage + 4, &pool_buf) == NULL && errno == EINVAL);
+	pool = pool_create_static(OBJ_SIZE, COUNT, pool_storage, &pool_buf);
+	check(pool != NULL);
+
+	for (size_t i = 0; i < COUNT; i++) {
+		objs[i] = pool_alloc(pool);
+		check(objs[i] != NULL && pool_contains(pool, objs[i]));
+		for (size_t j = 0; j < i; j++) check(objs[i] != objs[j]);
+	}
+	check(pool_alloc(pool) == NULL && errno == ENOMEM);
+	check(pool_free(pool, (uint8_t*)objs[0] + 4) == PROS_ERR && errno == EINVAL);
+	check(pool_free(pool, &stats) == PROS_ERR && errno == EINVAL);
+	check(pool_delete(pool) == PROS_ERR && errno == EINVAL);
+	pool_get_stats(pool, &stats);
+	check(stats.obj_size == POOL_OBJECT_SIZE(OBJ_SIZE) && stats.count == COUNT && stats.used == COUNT &&
+	      stats.max_used == COUNT && stats.failed == 1);
+	for (size_t i = 0; i < COUNT; i++) check(pool_free(pool, objs[i]) == 1);
+	pool_get_stats(pool, &stats);
+	check(stats.used == 0 && stats.max_used == COUNT);
+
+	pool_t heap_pool = pool_create(OBJ_SIZE, COUNT);
+	check(heap_pool != NULL);
+	check(pool_create(OBJ_SIZE, POOL_MAX_COUNT + 1) == NULL && errno == EINVAL);
+	void* obj = pool_alloc(heap_pool);
+	check(obj != NULL && !pool_contains(pool, obj) && pool_free(pool, obj) == PROS_ERR);
+	check(pool_free(heap_pool, obj) == 1);
+	check(pool_delete(heap_pool) == 1);
+	printf("single task checks done, %u errors\n", errors);
+
+	for (uint32_t i = 0; i < TASKS; i++) {
+		task_create(stress_task, (void*)i, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "pool stress");
+	}
+	while (finished < TASKS) task_delay(10);
+	pool_get_stats(pool, &stats);
+	check(stats.used == 0);
+	// Every object must be back on the free list exactly once
+	for (size_t i = 0; i < COUNT; i++) {
+		objs[i] = pool_alloc(pool);
+		check(objs[i] != NULL);
+		for (size_t j = 0; j < i; j++) check(objs[i] != objs[j]);
+	}
+	check(pool_alloc(pool) == NULL);
+	printf("%u tasks x %u rounds: max used %u of %u, %u failed allocations, %u errors\n", TASKS, ROUNDS,
+	       stats.max_used, COUNT, stats.failed, errors);
+	for (size_t i = 0; i < COUNT; i++) pool_free(pool, objs[i]);
+
+	uint64_t start = micros();
+	for (uint32_t i = 0; i < TIMED; i++) {
+		for (size_t j = 0; j < COUNT; j++) objs[j] = pool_alloc(pool);
+		for (size_t j = 0; j < COUNT; j++) pool_free(pool, objs[j]);
+	}
+	uint32_t pool_us = elapsed_us(start);
+	start = micros();
+	for (uint32_t i = 0; i < TIMED; i++) {
+		for (size_t j = 0; j < COUNT; j++) objs[j] = kmalloc(OBJ_SIZE);
+		for (size_t j = 0; j < COUNT; j++) kfree(objs[j]);
+	}
+	uint32_t heap_us = elapsed_us(start);
+	printf("%u allocations and frees: pool %u us, kernel heap %u us\n", TIMED * COUNT, pool_us, heap_us);
+	printf("%s\n", errors ? "FAILED" : "PASSED");
+	fflush(stdout);
+}
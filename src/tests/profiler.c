@@ -0,0 +1,47 @@
+/**
+ * \file tests/profiler.c
+ *
+ * Test code for the sampling profiler
+ *
+ * Profiles a task which spends about three times as long in heavy_work as in
+ * light_work for a second. Run profile-to-flamegraph.py on a capture of the
+ * serial output; the flame graph should show roughly that split under the
+ * "worker" task.
+ *
+ * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "main.h"
+#include "pros/apix.h"
+
+static volatile uint32_t sink;
+
+__attribute__((noinline)) static void heavy_work(void) {
+	uint64_t start = micros();
+	while (micros() - start < 3000) sink++;
+}
+
+__attribute__((noinline)) static void light_work(void) {
+	uint64_t start = micros();
+	while (micros() - start < 1000) sink++;
+}
+
+static void worker(void* ignore) {
+	while (true) {
+		heavy_work();
+		light_work();
+		delay(1);
+	}
+}
+
+void opcontrol() {
+	profiler_start(1, 8);
+	task_create(worker, NULL, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "worker");
+	delay(1000);
+	profiler_stop();
+	lcd_print(0, "profiler stopped");
+}
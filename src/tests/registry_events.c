@@ -0,0 +1,53 @@
+/**
+ * \file tests/registry_events.c
+ *
+ * Test code for registry hot-plug events
+ *
+ * First checks that a task's subscription is removed when it is deleted.
+ *
+ * NOTE: Plug and unplug devices while this test is running. Each event should
+ * be printed on the LCD as it happens.
+ *
+ * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "main.h"
+#include "pros/apix.h"
+
+static const char* event_names[] = {"", "PLUGGED", "UNPLUGGED", "", "MISMATCH"};
+
+void notified_task(void* ignore) {
+	registry_subscribe_task(task_get_current(), E_REGISTRY_EVENT_UNPLUGGED);
+	while (true) {
+		uint32_t ports = task_notify_take(true, TIMEOUT_MAX);
+		lcd_print(1, "Unplugged bitmap: %08x", ports);
+	}
+}
+
+void deleted_task(void* ignore) {
+	registry_subscribe_task(task_get_current(), REGISTRY_EVENT_ALL);
+}
+
+void opcontrol() {
+	// A task's subscription must not outlive it
+	task_t deleted = task_create(deleted_task, NULL, TASK_PRIORITY_DEFAULT + 1, TASK_STACK_DEPTH_DEFAULT, "Deleted");
+	errno = 0;
+	printf("deleted task unsubscribed: %s\n",
+	       registry_unsubscribe(deleted) == PROS_ERR && errno == ENOENT ? "PASSED" : "FAILED");
+
+	queue_t events = queue_create(8, sizeof(registry_event_s_t));
+	registry_subscribe_queue(events, REGISTRY_EVENT_ALL);
+	task_create(notified_task, NULL, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Registry Notified");
+
+	registry_event_s_t event;
+	while (true) {
+		if (queue_recv(events, &event, TIMEOUT_MAX)) {
+			lcd_print(0, "%d: port %d %s (%d/%d)", event.timestamp, event.port, event_names[event.event],
+			          event.plugged_type, event.bound_type);
+		}
+	}
+}
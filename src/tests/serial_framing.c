@@ -0,0 +1,94 @@
+/**
+ * \file tests/serial_framing.c
+ *
+ * Test for framed mode on /dev generic serial files
+ *
+ * First checks that COBS_ENCODE_MEASURE_MAX is enough for the worst case
+ * encodings, then sends frames through a port whose output is wired back to
+ * its input. The largest payload is 252 bytes, which makes 254 bytes with the
+ * CRC, the length at which COBS needs an extra code byte. Payloads are chosen
+ * so that neither they nor their CRCs contain a zero, which is the longest
+ * encoding.
+ *
+ * NOTE: Needs a loopback cable on SERIAL_PORT. On the host port, run with
+ * PROS_HOST_SERIAL_PORT=7 in the environment.
+ *
+ * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include <fcntl.h>
+
+#include "main.h"
+#include "pros/apix.h"
+#include "common/cobs.h"
+#include "common/crc.h"
+
+// NOTE: the host C library doesn't go through the kernel's VFS, so its entry
+//       points are called directly
+int _open(const char* file, int flags, int mode);
+ssize_t _write(int file, const void* buf, size_t len);
+ssize_t _read(int file, void* buf, size_t len);
+int _close(int file);
+
+#define SERIAL_PORT "7"
+#define MAX_PAYLOAD 252
+
+static volatile uint32_t errors = 0;
+
+#define check(cond)                                      \
+	do {                                                   \
+		if (!(cond)) {                                       \
+			printf("line %d: %s failed\n", __LINE__, #cond); \
+			errors++;                                          \
+		}                                                    \
+	} while (0)
+
+static uint8_t raw[600];
+static uint8_t encoded[600];
+
+// Fills buf with len non-zero bytes whose CRC has no zero byte either
+static void fill_zero_free(uint8_t* buf, size_t len) {
+	for (uint8_t seed = 1;; seed++) {
+		for (size_t i = 0; i < len; i++) buf[i] = 1 + (seed + i) % 255;
+		uint16_t crc = crc16(CRC16_INIT, buf, len);
+		if ((crc >> 8) && (crc & 0xff)) return;
+	}
+}
+
+void opcontrol() {
+	memset(raw, 0x55, sizeof(raw));
+	size_t lengths[] = {0, 1, 253, 254, 255, 508, 509};
+	for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+		size_t n = lengths[i];
+		memset(encoded, 0xaa, sizeof(encoded));
+		int written = cobs_encode_raw(encoded, raw, n);
+		check(written == COBS_ENCODE_MEASURE_MAX(n));
+		check(encoded[COBS_ENCODE_MEASURE_MAX(n)] == 0xaa);
+	}
+
+	int fd = _open("/dev/" SERIAL_PORT, O_RDWR, 0);
+	check(fd >= 0);
+	check(fdctl(fd, DEVCTL_ENABLE_FRAMING, (void*)MAX_PAYLOAD) == 1);
+	check(fdctl(fd, DEVCTL_SET_READ_TIMEOUT, (void*)100) == 1);
+
+	uint8_t sent[MAX_PAYLOAD];
+	uint8_t received[MAX_PAYLOAD];
+	size_t payloads[] = {1, 100, MAX_PAYLOAD - 1, MAX_PAYLOAD};
+	for (size_t i = 0; i < sizeof(payloads) / sizeof(payloads[0]); i++) {
+		size_t n = payloads[i];
+		fill_zero_free(sent, n);
+		check(_write(fd, sent, n) == (ssize_t)n);
+		memset(received, 0, sizeof(received));
+		ssize_t got = _read(fd, received, sizeof(received));
+		printf("%u byte payload: read %d bytes\n", (unsigned)n, (int)got);
+		check(got == (ssize_t)n && !memcmp(sent, received, n));
+	}
+	check(fdctl(fd, DEVCTL_GET_FRAME_ERRORS, NULL) == 0);
+	_close(fd);
+	printf("%s\n", errors ? "FAILED" : "PASSED");
+	fflush(stdout);
+}
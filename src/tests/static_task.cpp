@@ -0,0 +1,110 @@
+/**
+ * \file tests/static_task.cpp
+ *
+ * Test for pros::StaticTask
+ *
+ * Checks that a StaticTask runs its callable with what it captured, that
+ * creating one doesn't allocate from the kernel heap, and that destroying one
+ * deletes its task if it's still running and destroys the callable. Then it
+ * creates and destroys a StaticTask on the stack over and over, which reuses
+ * the same memory each time, and times that against pros::Task.
+ *
+ * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "main.h"
+#include "pros/apix.h"
+
+#define ROUNDS 200
+
+static volatile std::uint32_t errors = 0;
+
+#define check(cond)                                      \
+	do {                                                   \
+		if (!(cond)) {                                       \
+			printf("line %d: %s failed\n", __LINE__, #cond); \
+			errors++;                                          \
+		}                                                    \
+	} while (0)
+
+struct Counted {
+	std::uint32_t* destroyed;
+	Counted(std::uint32_t* destroyed) : destroyed(destroyed) {}
+	Counted(const Counted& other) = delete;
+	Counted(Counted&& other) : destroyed(other.destroyed) {
+		other.destroyed = nullptr;
+	}
+	~Counted() {
+		if (destroyed) (*destroyed)++;
+	}
+};
+
+void opcontrol() {
+	pros::c::heap_stats_s_t before, after;
+	std::uint32_t stack[TASK_STACK_DEPTH_MIN];
+	pros::task_buffer_s_t buffer;
+
+	errno = 0;
+	check(pros::c::task_create_buffered([](void*) {}, NULL, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_MIN, "", NULL,
+	                                    &buffer) == NULL &&
+	      errno == EINVAL);
+	check(pros::c::task_create_buffered([](void*) {}, NULL, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_MIN, "", stack,
+	                                    NULL) == NULL &&
+	      errno == EINVAL);
+
+	volatile std::uint32_t ran = 0;
+	std::uint32_t destroyed = 0;
+	std::uint32_t tasks = pros::c::task_get_count();
+	pros::c::heap_get_stats(&before);
+	{
+		std::uint32_t value = 42;
+		pros::StaticTask<TASK_STACK_DEPTH_MIN> task(
+		    [&ran, value, counted = Counted(&destroyed)] {
+			    ran = value;
+			    while (true) pros::delay(1);
+		    },
+		    TASK_PRIORITY_DEFAULT + 1, "static task");
+		pros::c::heap_get_stats(&after);
+		check(after.allocs == before.allocs);
+		check(ran == 42);
+		check(!strcmp(task.get_name(), "static task") && task.get_priority() == TASK_PRIORITY_DEFAULT + 1);
+		check(pros::c::task_get_count() == tasks + 1);
+		check(destroyed == 0);
+	}
+	check(destroyed == 1);
+	check(pros::c::task_get_count() == tasks);
+
+	// A task which returns by itself is left for the idle task to clean up
+	{
+		pros::StaticTask<TASK_STACK_DEPTH_MIN> task([&ran] { ran = 1; }, TASK_PRIORITY_DEFAULT + 1);
+		check(ran == 1);
+		check(task.get_state() == pros::E_TASK_STATE_DELETED);
+	}
+	check(pros::c::task_get_count() == tasks);
+	printf("single task checks done, %u errors\n", errors);
+
+	std::uint64_t start = pros::micros();
+	pros::c::heap_get_stats(&before);
+	for (std::uint32_t i = 0; i < ROUNDS; i++) {
+		pros::StaticTask<TASK_STACK_DEPTH_MIN> task([&ran, i] { ran = i; }, TASK_PRIORITY_DEFAULT + 1);
+		check(ran == i);
+	}
+	pros::c::heap_get_stats(&after);
+	std::uint32_t static_us = pros::micros() - start;
+	check(after.allocs == before.allocs);
+	check(pros::c::task_get_count() == tasks);
+
+	start = pros::micros();
+	for (std::uint32_t i = 0; i < ROUNDS; i++) {
+		pros::Task task([&ran, i] { ran = i; }, TASK_PRIORITY_DEFAULT + 1, TASK_STACK_DEPTH_MIN);
+		check(ran == i);
+	}
+	std::uint32_t dynamic_us = pros::micros() - start;
+	printf("%u tasks created and finished: StaticTask %u us, Task %u us\n", ROUNDS, static_us, dynamic_us);
+	printf("%s\n", errors ? "FAILED" : "PASSED");
+	fflush(stdout);
+}
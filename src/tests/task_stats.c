@@ -0,0 +1,76 @@
+/**
+ * \file tests/task_stats.c
+ *
+ * Test code for per-task run time statistics
+ *
+ * Runs a task which busy-waits for 3 ms out of every 10 ms and one which only
+ * wakes up every millisecond, then prints their CPU usage, context switches
+ * and free stack every second. The busy task should show close to 30% and
+ * about 400 switches per second, since the other task interrupts it every
+ * millisecond while it is busy, and the other task next to no CPU and about
+ * 1000 switches per second. Sending pRs over the serial port prints the same
+ * statistics for every task.
+ *
+ * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "main.h"
+#include "pros/apix.h"
+
+#define MAX_TASKS 32
+
+static void busy_task(void* ignore) {
+	uint32_t now = millis();
+	while (true) {
+		uint64_t start = micros();
+		while (micros() - start < 3000)
+			;
+		task_delay_until(&now, 10);
+	}
+}
+
+static void wakeup_task(void* ignore) {
+	while (true) {
+		task_delay(1);
+	}
+}
+
+static task_runtime_stats_s_t stats[MAX_TASKS];
+
+static void print_task(int line, task_t task, uint32_t elapsed, uint32_t* prev_run_time, uint32_t* prev_switches) {
+	for (int32_t i = 0; i < MAX_TASKS; i++) {
+		if (stats[i].task == task) {
+			lcd_print(line, "%s: %u%% cpu, %u switches, %u words free", stats[i].name,
+			          (stats[i].run_time - *prev_run_time) * 100 / elapsed, stats[i].context_switches - *prev_switches,
+			          stats[i].stack_free_min);
+			*prev_run_time = stats[i].run_time;
+			*prev_switches = stats[i].context_switches;
+			return;
+		}
+	}
+}
+
+void opcontrol() {
+	task_t busy = task_create(busy_task, NULL, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "busy");
+	task_t wakeup = task_create(wakeup_task, NULL, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "wakeup");
+
+	uint32_t prev_total = 0;
+	uint32_t busy_run_time = 0, busy_switches = 0, wakeup_run_time = 0, wakeup_switches = 0;
+	while (true) {
+		uint32_t total;
+		int32_t count = task_get_runtime_stats(stats, MAX_TASKS, &total);
+		if (count == PROS_ERR) {
+			lcd_print(0, "task_get_runtime_stats failed: %d", errno);
+		} else {
+			print_task(0, busy, total - prev_total, &busy_run_time, &busy_switches);
+			print_task(1, wakeup, total - prev_total, &wakeup_run_time, &wakeup_switches);
+			lcd_print(2, "%d tasks", count);
+		}
+		prev_total = total;
+		delay(1000);
+	}
+}
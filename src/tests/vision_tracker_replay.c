@@ -0,0 +1,108 @@
+/**
+ * \file tests/vision_tracker_replay.c
+ *
+ * Host-side replay benchmark for the vision tracker
+ *
+ * NOTE: This is not a robot program. Build and run it on a host with:
+ *   gcc -O2 -Iinclude src/tests/vision_tracker_replay.c \
+ *       src/devices/vdml_vision_tracker.c -o tracker_replay && ./tracker_replay
+ *
+ * A scene of objects bouncing around the field of view is synthesized at the
+ * sensor's 50 Hz frame rate, with position noise and dropped detections, and
+ * replayed through the tracker. The benchmark reports the time per frame and
+ * how often the track following an object changed ID.
+ *
+ * Copyright (c) 2017-2020, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "vdml/vision_tracker.h"
+
+#define FRAMES 20000
+#define FRAME_MS 20
+#define OBJECTS 8
+#define DROP_PERCENT 10
+
+typedef struct {
+	float x, y, vx, vy;
+	int16_t size;
+	uint16_t signature;
+	uint32_t last_id;
+} truth_s_t;
+
+static float noise(void) {
+	return ((rand() % 1001) - 500) / 250.0f;  // +/- 2 units
+}
+
+static int by_size(const void* a, const void* b) {
+	return ((const vision_object_s_t*)b)->width - ((const vision_object_s_t*)a)->width;
+}
+
+int main(void) {
+	static vision_tracker_s_t tracker;
+	truth_s_t truth[OBJECTS];
+	vision_object_s_t objects[OBJECTS];
+	uint32_t id_switches = 0, matched = 0;
+	double total_ns = 0, worst_ns = 0;
+
+	srand(1);
+	vision_tracker_init(&tracker);
+	for (int i = 0; i < OBJECTS; i++) {
+		truth[i] = (truth_s_t){.x = rand() % VISION_FOV_WIDTH,
+		                       .y = rand() % VISION_FOV_HEIGHT,
+		                       .vx = (rand() % 400) - 200,
+		                       .vy = (rand() % 400) - 200,
+		                       .size = 10 + 5 * i,
+		                       .signature = 1 + i % 3};
+	}
+
+	for (uint32_t frame = 0; frame < FRAMES; frame++) {
+		uint32_t count = 0;
+		for (int i = 0; i < OBJECTS; i++) {
+			truth_s_t* t = &truth[i];
+			t->x += t->vx * FRAME_MS / 1000.0f;
+			t->y += t->vy * FRAME_MS / 1000.0f;
+			if (t->x < 0 || t->x > VISION_FOV_WIDTH) t->vx = -t->vx;
+			if (t->y < 0 || t->y > VISION_FOV_HEIGHT) t->vy = -t->vy;
+			if (rand() % 100 < DROP_PERCENT) continue;
+			vision_object_s_t* o = &objects[count];
+			o->signature = t->signature;
+			o->width = o->height = t->size;
+			o->x_middle_coord = t->x + noise();
+			o->y_middle_coord = t->y + noise();
+			count++;
+		}
+		// The sensor reports objects largest first
+		qsort(objects, count, sizeof(objects[0]), by_size);
+
+		struct timespec start, end;
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		vision_tracker_update(&tracker, objects, count, frame * FRAME_MS, frame * FRAME_MS);
+		clock_gettime(CLOCK_MONOTONIC, &end);
+		double ns = (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+		total_ns += ns;
+		if (ns > worst_ns) worst_ns = ns;
+
+		// Each object has a unique size, so a track's width identifies its object
+		for (uint8_t t = 0; t < tracker.count; t++) {
+			vision_track_s_t* track = &tracker.entries[t].track;
+			if (track->missed) continue;
+			truth_s_t* tr = &truth[(track->width - 10) / 5];
+			if (tr->last_id && tr->last_id != track->id) id_switches++;
+			tr->last_id = track->id;
+			matched++;
+		}
+	}
+
+	printf("frames: %d, objects: %d, dropped detections: %d%%\n", FRAMES, OBJECTS, DROP_PERCENT);
+	printf("update: %.0f ns average, %.0f ns worst\n", total_ns / FRAMES, worst_ns);
+	printf("track-frames: %u, ID switches: %u\n", matched, id_switches);
+	return 0;
+}
@@ -0,0 +1,142 @@
+#!/usr/bin/env python3
+"""Converts a PROS kernel trace into Chrome trace JSON.
+
+Start a trace with trace_start() or by sending pRT to the brain, capture the
+raw serial output (e.g. cat /dev/ttyACM1 > capture.bin), then run
+
+    python3 trace-to-json.py capture.bin trace.json
+
+and open trace.json in chrome://tracing or https://ui.perfetto.dev. Frames of
+other streams (stdout, stderr, ...) in the capture are ignored.
+
+Each task gets a track showing when it ran, with its queue, semaphore and
+mutex operations as instant events. Interrupts get a track of their own.
+"""
+import json
+import struct
+import sys
+
+TRACE_STREAM_ID = b'trce'
+EVENT = struct.Struct('<IBBHII')
+
+TASK_NAME = 1
+SWITCH_IN = 2
+SWITCH_OUT = 3
+QUEUE_SEND = 4
+QUEUE_RECEIVE = 5
+QUEUE_BLOCK_SEND = 6
+QUEUE_BLOCK_RECV = 7
+PRIORITY_INHERIT = 8
+PRIORITY_RESTORE = 9
+ISR_ENTER = 10
+ISR_EXIT = 11
+DROPPED = 12
+
+# queueQUEUE_TYPE_* from rtos/queue.h
+QUEUE_TYPES = {0: 'queue', 1: 'mutex', 2: 'semaphore', 3: 'semaphore', 4: 'mutex'}
+QUEUE_OPS = {
+    QUEUE_SEND: ('send', 'give'),
+    QUEUE_RECEIVE: ('receive', 'take'),
+    QUEUE_BLOCK_SEND: ('block on send', 'block on give'),
+    QUEUE_BLOCK_RECV: ('block on receive', 'block on take'),
+}
+
+PID = 1
+ISR_TID = 0
+
+
+def cobs_decode(frame):
+    """Returns the decoded contents of a COBS frame, or None if it isn't one"""
+    out = bytearray()
+    i = 0
+    while i < len(frame):
+        code = frame[i]
+        if code == 0 or i + code > len(frame):
+            return None
+        out += frame[i + 1:i + code]
+        i += code
+        if code < 0xff and i < len(frame):
+            out.append(0)
+    return bytes(out)
+
+
+def is_trace_frame(frame):
+    return frame is not None and frame[:4] == TRACE_STREAM_ID and (len(frame) - 4) % EVENT.size == 0
+
+
+def trace_events(data):
+    for chunk in data.split(b'\0'):
+        frame = cobs_decode(chunk)
+        if not is_trace_frame(frame):
+            # Output which wasn't COBS encoded (e.g. the banner, or text printed
+            # with COBS disabled) has no delimiter of its own, so it ends up in
+            # front of the next frame. Look for a frame at the end of the chunk.
+            frame = next((f for f in map(cobs_decode, (chunk[i:] for i in range(1, len(chunk))))
+                          if is_trace_frame(f)), None)
+            if frame is None:
+                continue
+        body = frame[4:]
+        for offset in range(0, len(body), EVENT.size):
+            yield EVENT.unpack_from(body, offset)
+
+
+def convert(data):
+    names = {}
+    out = []
+    running = None  # (task, start time)
+    last_time = None
+    epoch = 0
+    for time, kind, data_byte, task, arg, extra in trace_events(data):
+        # Timestamps are the low 32 bits of micros(), so unwrap them
+        if last_time is not None and time < last_time and last_time - time > 1 << 31:
+            epoch += 1 << 32
+        last_time = time
+        ts = epoch + time
+
+        if kind == TASK_NAME:
+            chunks = names.setdefault(task, {})
+            chunks[data_byte] = struct.pack('<II', arg, extra)
+        elif kind == SWITCH_IN:
+            running = (task, ts)
+        elif kind == SWITCH_OUT:
+            if running is not None and running[0] == task:
+                out.append({'name': 'running', 'ph': 'X', 'pid': PID, 'tid': task, 'ts': running[1],
+                            'dur': ts - running[1]})
+            running = None
+        elif kind in QUEUE_OPS:
+            queue_type = QUEUE_TYPES.get(data_byte, 'queue')
+            op = QUEUE_OPS[kind][0 if queue_type == 'queue' else 1]
+            out.append({'name': '{} {}'.format(queue_type, op), 'ph': 'i', 's': 't', 'pid': PID, 'tid': task,
+                        'ts': ts, 'args': {queue_type: '0x{:08x}'.format(arg)}})
+        elif kind in (PRIORITY_INHERIT, PRIORITY_RESTORE):
+            name = 'inherited priority' if kind == PRIORITY_INHERIT else 'restored priority'
+            out.append({'name': name, 'ph': 'i', 's': 't', 'pid': PID, 'tid': arg, 'ts': ts,
+                        'args': {'priority': extra}})
+        elif kind == ISR_ENTER:
+            out.append({'name': 'IRQ {}'.format(arg), 'ph': 'B', 'pid': PID, 'tid': ISR_TID, 'ts': ts})
+        elif kind == ISR_EXIT:
+            out.append({'name': 'IRQ {}'.format(arg), 'ph': 'E', 'pid': PID, 'tid': ISR_TID, 'ts': ts})
+        elif kind == DROPPED:
+            out.append({'name': 'dropped {} events'.format(arg), 'ph': 'i', 's': 'g', 'pid': PID, 'tid': ISR_TID,
+                        'ts': ts})
+
+    out.append({'name': 'thread_name', 'ph': 'M', 'pid': PID, 'tid': ISR_TID, 'args': {'name': 'Interrupts'}})
+    for task, chunks in names.items():
+        name = b''.join(chunks[i] for i in sorted(chunks)).split(b'\0')[0].decode(errors='replace')
+        out.append({'name': 'thread_name', 'ph': 'M', 'pid': PID, 'tid': task,
+                    'args': {'name': '{} ({})'.format(name, task)}})
+    return {'traceEvents': out, 'displayTimeUnit': 'ns'}
+
+
+def main():
+    if len(sys.argv) != 3:
+        print('usage: {} capture.bin trace.json'.format(sys.argv[0]), file=sys.stderr)
+        sys.exit(1)
+    with open(sys.argv[1], 'rb') as f:
+        data = f.read()
+    with open(sys.argv[2], 'w') as f:
+        json.dump(convert(data), f)
+
+
+if __name__ == '__main__':
+    main()